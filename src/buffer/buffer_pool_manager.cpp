@@ -1,242 +1,272 @@
 #include "buffer/buffer_pool_manager.h"
 
+#include <algorithm>
+
 #include "glog/logging.h"
 #include "page/bitmap_page.h"
 
-static const char EMPTY_PAGE_DATA[PAGE_SIZE] = {0};
-
-BufferPoolManager::BufferPoolManager(size_t pool_size, DiskManager *disk_manager)
+BufferPoolManager::BufferPoolManager(size_t pool_size, DiskManager *disk_manager, ReplacerType replacer_type,
+                                     size_t num_instances)
     : pool_size_(pool_size), disk_manager_(disk_manager) {
-  pages_ = new Page[pool_size_];
-  replacer_ = new LRUReplacer(pool_size_);
-  for (size_t i = 0; i < pool_size_; i++) {
-    free_list_.emplace_back(i); // frame_id
+  ASSERT(num_instances > 0 && num_instances <= pool_size, "Invalid number of buffer pool instances.");
+  // spread the frames as evenly as possible, the first pool_size % num_instances instances get one more
+  for (size_t i = 0; i < num_instances; i++) {
+    size_t instance_size = pool_size / num_instances + (i < pool_size % num_instances ? 1 : 0);
+    instances_.push_back(new BufferPoolManagerInstance(instance_size, disk_manager, replacer_type));
   }
 }
 
 BufferPoolManager::~BufferPoolManager() {
-  for (auto page : page_table_) {
-    FlushPage(page.first);
-  }
-  delete[] pages_;
-  delete replacer_;
-}
-
-/**
- * TODO: Student Implement
- */
-Page *BufferPoolManager::FetchPage(page_id_t page_id) {
-  // 1.     Search the page table for the requested page (P).
-  // 1.1    If P exists, pin it and return it immediately.
-  // 1.2    If P does not exist, find a replacement page (R) from either the free list or the replacer.
-  //        Note that pages are always found from the free list first.
-  // 2.     If R is dirty, write it back to the disk.
-  // 3.     Delete R from the page table and insert P.
-  // 4.     Update P's metadata, read in the page content from disk, and then return a pointer to P.
-
-  if (page_id == INVALID_PAGE_ID ) {
-    return nullptr;
+  StopPrefetcher();
+  StopBackgroundFlusher();
+  for (auto instance : instances_) {
+    delete instance;
   }
+}
 
-  if (page_table_.find(page_id) != page_table_.end()) { // 1.1
-    frame_id_t frame_id = page_table_[page_id];
-    replacer_->Pin(frame_id);
-    pages_[frame_id].pin_count_++;
-    return &pages_[frame_id];
+Page *BufferPoolManager::FetchPage(page_id_t page_id, AccessType access_type) {
+  if (page_id == INVALID_PAGE_ID) {
+    return nullptr;
   }
+  return GetInstance(page_id)->FetchPage(page_id, access_type);
+}
 
-  if (free_list_.empty() && replacer_->Size() == 0) {
+Page *BufferPoolManager::TryFetchPage(page_id_t page_id, AccessType access_type) {
+  if (page_id == INVALID_PAGE_ID) {
     return nullptr;
-  } else
+  }
+  return GetInstance(page_id)->TryFetchPage(page_id, access_type);
+}
+
+void BufferPoolManager::PrefetchPages(const vector<page_id_t> &page_ids) {
   {
-    frame_id_t frame_id = TryToFindFreePage();  // 1.2获取一个空闲的frame
-    if (frame_id == INVALID_FRAME_ID ) {
-      return nullptr;
+    std::scoped_lock<std::mutex> lock(prefetch_mutex_);
+    if (!prefetcher_.joinable()) {
+      prefetcher_ = std::thread(&BufferPoolManager::RunPrefetcher, this);
     }
-    if (pages_[frame_id].IsDirty()) { // 2 from lru
-      FlushPage(pages_[frame_id].GetPageId());
+    for (auto page_id : page_ids) {
+      if (page_id != INVALID_PAGE_ID && prefetch_queue_.size() < pool_size_) {
+        prefetch_queue_.push_back({page_id, 1, nullptr});
+      }
     }
+  }
+  prefetch_cv_.notify_one();
+}
 
-    page_table_.erase(pages_[frame_id].GetPageId()); // 通过frame_id获取page_id
-    disk_manager_->ReadPage(page_id, pages_[frame_id].data_); // 从disk上读取逻辑页号为page_id的数据
-    page_table_.insert({page_id, frame_id});
-    pages_[frame_id].page_id_ = page_id;
-    pages_[frame_id].pin_count_ = 1;
-    pages_[frame_id].is_dirty_ = false;
-    replacer_->Pin(frame_id); // remove from lru_list_
-
-    return &pages_[frame_id];
+void BufferPoolManager::PrefetchChain(page_id_t page_id, size_t num_pages, NextPageFunc next_page) {
+  if (page_id == INVALID_PAGE_ID || num_pages == 0) {
+    return;
   }
+  {
+    std::scoped_lock<std::mutex> lock(prefetch_mutex_);
+    if (!prefetcher_.joinable()) {
+      prefetcher_ = std::thread(&BufferPoolManager::RunPrefetcher, this);
+    }
+    if (prefetch_queue_.size() < pool_size_) {
+      prefetch_queue_.push_back({page_id, num_pages, next_page});
+    }
+  }
+  prefetch_cv_.notify_one();
 }
 
-/**
- * TODO: Student Implement
- */
 Page *BufferPoolManager::NewPage(page_id_t &page_id) {
   // 0.   Make sure you call AllocatePage!
-  // 1.   If all the pages in the buffer pool are pinned, return nullptr.
-  // 2.   Pick a victim page P from either the free list or the replacer. Always pick from the free list first.
-  // 3.   Update P's metadata, zero out memory and add P to the page table.
-  // 4.   Set the page ID output parameter. Return a pointer to P.
-
-  size_t index = 0;
-  for (index = 0; index < pool_size_; index++) {
-    if (pages_[index].GetPinCount() == 0) {
-      break;
-    }
-  }
-  if (index == pool_size_) {
+  // 1.   If all the pages in the owning instance are pinned, release the page id and return nullptr.
+  // 2.   Let the instance pick a victim, zero out its memory and pin it.
+  // 3.   Set the page ID output parameter. Return a pointer to P.
+  page_id_t new_page_id = AllocatePage();
+  if (new_page_id == INVALID_PAGE_ID) {
     return nullptr;
   }
-  if (replacer_->Size() + free_list_.size() <= 0) {
+  Page *page = GetInstance(new_page_id)->NewPage(new_page_id);
+  if (page == nullptr) {
+    DeallocatePage(new_page_id);
     return nullptr;
   }
-  page_id_t new_page_id = AllocatePage();
-
+  page_id = new_page_id;
+  return page;
+}
 
-  frame_id_t frame_id;
-  frame_id = TryToFindFreePage(); // 2
-  if (frame_id == INVALID_FRAME_ID) {
-    return nullptr;
+Page *BufferPoolManager::NewPage(page_id_t &page_id, PageRun &run) {
+  if (run.IsEmpty()) {
+    page_id_t first_page_id = disk_manager_->AllocatePages(PAGE_RUN_SIZE);
+    if (first_page_id == INVALID_PAGE_ID) {
+      return NewPage(page_id);
+    }
+    run.next_ = first_page_id;
+    run.end_ = first_page_id + PAGE_RUN_SIZE;
   }
-
-  if (pages_[frame_id].IsDirty()) { // lru
-    // disk_manager_->WritePage(pages_[frame_id].page_id_, pages_[frame_id].data_);
-    FlushPage(pages_[frame_id].page_id_);
+  page_id_t new_page_id = run.next_++;
+  Page *page = GetInstance(new_page_id)->NewPage(new_page_id);
+  if (page == nullptr) {
+    DeallocatePage(new_page_id);
+    return nullptr;
   }
-  page_table_.erase(pages_[frame_id].GetPageId());
-
-  pages_[frame_id].ResetMemory();
-  page_table_.insert({new_page_id, frame_id});
   page_id = new_page_id;
-  pages_[frame_id].page_id_ = new_page_id;
-  pages_[frame_id].pin_count_  = 1;
-  pages_[frame_id].is_dirty_ = false;
-
-  // replacer_->Unpin(frame_id);
-  replacer_->Pin(frame_id);
+  return page;
+}
 
-  return &(pages_[frame_id]);
+void BufferPoolManager::ReleasePages(PageRun &run) {
+  for (; !run.IsEmpty(); run.next_++) {
+    DeallocatePage(run.next_);
+  }
 }
 
-/**
- * TODO: Student Implement
- */
 bool BufferPoolManager::DeletePage(page_id_t page_id) {
   // 0.   Make sure you call DeallocatePage!
-  // 1.   Search the page table for the requested page (P).
-  // 1.   If P does not exist, return true.
-  // 2.   If P exists, but has a non-zero pin-count, return false. Someone is using the page.
-  // 3.   Otherwise, P can be deleted. Remove P from the page table, reset its metadata and return it to the free list.
-
-
-  if (page_id == INVALID_PAGE_ID)
-    return true;
-  if (page_table_.find(page_id) == page_table_.end()) { // 1
+  // 1.   If P is not in the pool, return true.
+  // 2.   If P is in the pool but has a non-zero pin-count, return false. Someone is using the page.
+  // 3.   Otherwise, P can be deleted. The instance returns its frame to the free list.
+  if (page_id == INVALID_PAGE_ID) {
     return true;
   }
-
-  frame_id_t frame_id = page_table_[page_id]; // exists
-
-  if (pages_[frame_id].pin_count_ != 0) { // 2
+  auto instance = GetInstance(page_id);
+  if (!instance->DeletePage(page_id)) {
     return false;
   }
-  // if (pages_[frame_id].IsDirty()) {
-  //   FlushPage(pages_[frame_id].GetPageId());
-  // }
-
-  DeallocatePage(page_id); // 0
-  page_table_.erase(page_id);
-  pages_[frame_id].page_id_ = INVALID_PAGE_ID;
-  pages_[frame_id].pin_count_ = 0;
-  pages_[frame_id].is_dirty_ = false;
-  pages_[frame_id].ResetMemory();
-  free_list_.emplace_back(frame_id);
-  dynamic_cast<LRUReplacer*>(replacer_)->Remove(frame_id);
+  if (!disk_manager_->IsPageFree(page_id)) {
+    DeallocatePage(page_id);
+  }
   return true;
 }
 
-/**
- * TODO: Student Implement
- */
 bool BufferPoolManager::UnpinPage(page_id_t page_id, bool is_dirty) {
-  if (page_table_.find(page_id) == page_table_.end()) {
-    return true;
-  }
-
   if (page_id == INVALID_PAGE_ID) {
     return false;
   }
+  return GetInstance(page_id)->UnpinPage(page_id, is_dirty);
+}
 
-  frame_id_t frame_id = page_table_[page_id];
-  if (pages_[frame_id].pin_count_ == 0) {
+bool BufferPoolManager::FlushPage(page_id_t page_id) {
+  if (page_id == INVALID_PAGE_ID) {
     return false;
   }
-  if (is_dirty) {
-    pages_[frame_id].is_dirty_ = true;
-  } else {
-    pages_[frame_id].is_dirty_ = false;
-  }
-  pages_[frame_id].pin_count_--;
-  if (pages_[frame_id].pin_count_ == 0) {
-    replacer_->Unpin(frame_id);
-  }
+  return GetInstance(page_id)->FlushPage(page_id);
+}
 
+page_id_t BufferPoolManager::AllocatePage() {
+  int next_page_id = disk_manager_->AllocatePage();
+  return next_page_id;
+}
 
-  return true;
+void BufferPoolManager::DeallocatePage(__attribute__((unused)) page_id_t page_id) {
+  disk_manager_->DeAllocatePage(page_id);
 }
 
-/**
- * TODO: Student Implement
- */
-bool BufferPoolManager::FlushPage(page_id_t page_id) {
-  if (page_table_.find(page_id) == page_table_.end()) {
-    return false;
-  }
-  if (page_id == INVALID_PAGE_ID) {
-    return false;
+bool BufferPoolManager::IsPageFree(page_id_t page_id) { return disk_manager_->IsPageFree(page_id); }
+
+void BufferPoolManager::StartBackgroundFlusher(double low_watermark, double high_watermark, size_t batch_size,
+                                               std::chrono::milliseconds interval) {
+  ASSERT(low_watermark >= 0 && low_watermark <= high_watermark && high_watermark <= 1, "Invalid flusher watermarks.");
+  ASSERT(batch_size > 0, "Invalid flusher batch size.");
+  if (flusher_.joinable()) {
+    return;
   }
-  frame_id_t frame_id = page_table_[page_id];
-  disk_manager_->WritePage(page_id, pages_[frame_id].GetData());
-  pages_[frame_id].is_dirty_ = false;
+  flusher_low_watermark_ = low_watermark;
+  flusher_high_watermark_ = high_watermark;
+  flusher_batch_size_ = batch_size;
+  flusher_interval_ = interval;
+  flusher_stop_ = false;
+  flusher_ = std::thread(&BufferPoolManager::RunBackgroundFlusher, this);
+}
 
-  return true;
+void BufferPoolManager::StopBackgroundFlusher() {
+  if (!flusher_.joinable()) {
+    return;
+  }
+  {
+    std::scoped_lock<std::mutex> lock(flusher_mutex_);
+    flusher_stop_ = true;
+  }
+  flusher_cv_.notify_all();
+  flusher_.join();
 }
 
-frame_id_t BufferPoolManager::TryToFindFreePage() {
-  if (!free_list_.empty()) {
-    frame_id_t frame_id = free_list_.front();
-    free_list_.pop_front();
-    return frame_id;
-  } else {
-    frame_id_t frame_id;
-    if (replacer_->Victim(&frame_id)) {
-      return frame_id;
+void BufferPoolManager::RunBackgroundFlusher() {
+  std::unique_lock<std::mutex> lock(flusher_mutex_);
+  while (!flusher_cv_.wait_for(lock, flusher_interval_, [this] { return flusher_stop_; })) {
+    lock.unlock();
+    for (auto instance : instances_) {
+      auto high = static_cast<size_t>(instance->GetPoolSize() * flusher_high_watermark_);
+      auto low = static_cast<size_t>(instance->GetPoolSize() * flusher_low_watermark_);
+      if (instance->GetNumDirtyPages() <= high) {
+        continue;
+      }
+      size_t dirty;
+      while ((dirty = instance->GetNumDirtyPages()) > low) {
+        // stop when everything left is pinned
+        if (instance->FlushDirtyPages(std::min(flusher_batch_size_, dirty - low)) == 0) {
+          break;
+        }
+      }
     }
+    lock.lock();
   }
-  return INVALID_PAGE_ID;
+}
 
+void BufferPoolManager::RunPrefetcher() {
+  std::unique_lock<std::mutex> lock(prefetch_mutex_);
+  while (true) {
+    prefetch_cv_.wait(lock, [this] { return prefetch_stop_ || !prefetch_queue_.empty(); });
+    if (prefetch_stop_) {
+      return;
+    }
+    PrefetchRequest request = prefetch_queue_.front();
+    prefetch_queue_.pop_front();
+    lock.unlock();
+    if (request.next_page_ == nullptr) {
+      GetInstance(request.page_id_)->PrefetchPage(request.page_id_);
+    } else {
+      LoadChain(request);
+    }
+    lock.lock();
+  }
 }
 
-page_id_t BufferPoolManager::AllocatePage() {
-  int next_page_id = disk_manager_->AllocatePage();
-  return next_page_id;
+void BufferPoolManager::LoadChain(const PrefetchRequest &request) {
+  page_id_t page_id = request.page_id_;
+  for (size_t i = 0; i < request.num_pages_; i++) {
+    // the link of a page is only known once it is cached, each page was loaded by the previous step
+    Page *page = TryFetchPage(page_id, kSequentialAccess);
+    if (page == nullptr) {
+      return;
+    }
+    page->RLatch();
+    page_id_t next_page_id = request.next_page_(page);
+    page->RUnlatch();
+    UnpinPage(page_id, false);
+    if (next_page_id == INVALID_PAGE_ID || !GetInstance(next_page_id)->PrefetchPage(next_page_id)) {
+      return;
+    }
+    page_id = next_page_id;
+  }
 }
 
-void BufferPoolManager::DeallocatePage(__attribute__((unused)) page_id_t page_id) {
-  disk_manager_->DeAllocatePage(page_id);
+void BufferPoolManager::StopPrefetcher() {
+  {
+    std::scoped_lock<std::mutex> lock(prefetch_mutex_);
+    if (!prefetcher_.joinable()) {
+      return;
+    }
+    prefetch_stop_ = true;
+  }
+  prefetch_cv_.notify_all();
+  prefetcher_.join();
 }
 
-bool BufferPoolManager::IsPageFree(page_id_t page_id) { return disk_manager_->IsPageFree(page_id); }
+BufferPoolStats BufferPoolManager::GetStats() const {
+  BufferPoolStats stats;
+  for (auto instance : instances_) {
+    instance->CollectStats(&stats);
+  }
+  return stats;
+}
 
 // Only used for debug
 bool BufferPoolManager::CheckAllUnpinned() {
   bool res = true;
-  for (size_t i = 0; i < pool_size_; i++) {
-    if (pages_[i].pin_count_ != 0) {
-      res = false;
-      LOG(ERROR) << "page " << pages_[i].page_id_ << " pin count:" << pages_[i].pin_count_ << endl;
-    }
+  for (auto instance : instances_) {
+    res = instance->CheckAllUnpinned() && res;
   }
   return res;
-}
\ No newline at end of file
+}
@@ -0,0 +1,368 @@
+#include "buffer/buffer_pool_manager_instance.h"
+
+#include <algorithm>
+
+#include "glog/logging.h"
+
+BufferPoolManagerInstance::BufferPoolManagerInstance(size_t pool_size, DiskManager *disk_manager,
+                                                     ReplacerType replacer_type)
+    : pool_size_(pool_size),
+      disk_manager_(disk_manager),
+      page_table_(pool_size),
+      pending_access_(pool_size),
+      in_replacer_(pool_size),
+      flushing_(pool_size) {
+  pages_ = new Page[pool_size_];
+  if (replacer_type == kClockReplacer) {
+    replacer_ = new CLOCKReplacer(pool_size_);
+  } else if (replacer_type == kTwoQueueReplacer) {
+    replacer_ = new TwoQueueReplacer(pool_size_);
+  } else {
+    replacer_ = new LRUReplacer(pool_size_);
+  }
+  for (size_t i = 0; i < pool_size_; i++) {
+    pages_[i].pin_count_ = -1;
+    free_list_.emplace_back(i); // frame_id
+  }
+}
+
+BufferPoolManagerInstance::~BufferPoolManagerInstance() {
+  FlushAllPages();
+  delete[] pages_;
+  delete replacer_;
+}
+
+Page *BufferPoolManagerInstance::FetchPage(page_id_t page_id, AccessType access_type) {
+  // 0.     Try to serve the request without the latch.
+  // 1.     Search the page table for the requested page (P).
+  // 1.1    If P exists, pin it and return it immediately.
+  // 1.2    If P does not exist, find a replacement page (R) from either the free list or the replacer.
+  //        Note that pages are always found from the free list first.
+  // 2.     If R is dirty, write it back to the disk.
+  // 3.     Delete R from the page table and insert P.
+  // 4.     Update P's metadata, read in the page content from disk, and then return a pointer to P.
+  Page *page = TryFetchPage(page_id, access_type); // 0
+  if (page != nullptr) {
+    return page;
+  }
+
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
+  frame_id_t frame_id;
+  if (page_table_.Find(page_id, &frame_id)) { // 1.1, evictions hold the latch so the pin count is not -1
+    pages_[frame_id].pin_count_++;
+    replacer_->RecordAccess(frame_id, access_type);
+    replacer_->Pin(frame_id);
+    in_replacer_[frame_id] = false;
+    return &pages_[frame_id];
+  }
+
+  frame_id = LoadPage(page_id); // 1.2, 2, 3, 4
+  if (frame_id == INVALID_FRAME_ID) {
+    return nullptr;
+  }
+  pages_[frame_id].pin_count_ = 1; // publish the frame to latch-free readers
+  replacer_->RecordAccess(frame_id, access_type);
+  replacer_->Pin(frame_id); // remove from lru_list_
+  in_replacer_[frame_id] = false;
+  return &pages_[frame_id];
+}
+
+Page *BufferPoolManagerInstance::TryFetchPage(page_id_t page_id, AccessType access_type) {
+  frame_id_t frame_id;
+  if (page_table_.Find(page_id, &frame_id) && TryPinFrame(frame_id, page_id)) {
+    pending_access_[frame_id] |= (access_type == kSequentialAccess ? SEQUENTIAL_ACCESS_SEEN : RANDOM_ACCESS_SEEN);
+    return &pages_[frame_id];
+  }
+  return nullptr;
+}
+
+bool BufferPoolManagerInstance::PrefetchPage(page_id_t page_id) {
+  frame_id_t frame_id;
+  if (page_table_.Find(page_id, &frame_id)) {
+    return true;
+  }
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
+  if (page_table_.Find(page_id, &frame_id)) {
+    return true;
+  }
+  frame_id = LoadPage(page_id);
+  if (frame_id == INVALID_FRAME_ID) {
+    return false;
+  }
+  pages_[frame_id].pin_count_ = 0;
+  // nobody asked for the page yet, it gets no more credit than a page touched by a scan
+  replacer_->RecordAccess(frame_id, kSequentialAccess);
+  replacer_->Unpin(frame_id);
+  in_replacer_[frame_id] = true;
+  return true;
+}
+
+Page *BufferPoolManagerInstance::NewPage(page_id_t page_id) {
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
+
+  frame_id_t frame_id;
+  // a read-ahead may have cached the page while its id was free
+  if (page_table_.Find(page_id, &frame_id) && !DeletePage(page_id)) {
+    return nullptr;
+  }
+  frame_id = TryToFindFreePage();
+  if (frame_id == INVALID_FRAME_ID) {
+    return nullptr;
+  }
+  EvictFrame(frame_id);
+  Page &page = pages_[frame_id];
+  page.ResetMemory();
+  page.page_id_ = page_id;
+  pending_access_[frame_id] = 0;
+  page_table_.Insert(page_id, frame_id);
+  page.pin_count_ = 1;
+
+  replacer_->RecordAccess(frame_id, kRandomAccess);
+  replacer_->Pin(frame_id);
+  in_replacer_[frame_id] = false;
+
+  return &page;
+}
+
+bool BufferPoolManagerInstance::DeletePage(page_id_t page_id) {
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
+
+  frame_id_t frame_id;
+  if (!page_table_.Find(page_id, &frame_id)) {
+    return true;
+  }
+  // keep latch-free readers away while the frame is reset
+  int expected = 0;
+  if (!pages_[frame_id].pin_count_.compare_exchange_strong(expected, -1)) {
+    return false;
+  }
+
+  WaitForFlush(frame_id);
+  page_table_.Erase(page_id);
+  pages_[frame_id].page_id_ = INVALID_PAGE_ID;
+  MarkClean(pages_[frame_id]);
+  pages_[frame_id].ResetMemory();
+  free_list_.emplace_back(frame_id);
+  replacer_->Remove(frame_id);
+  in_replacer_[frame_id] = false;
+  return true;
+}
+
+bool BufferPoolManagerInstance::UnpinPage(page_id_t page_id, bool is_dirty) {
+  // the caller holds a pin, so the mapping can not change under us unless the call is bogus
+  frame_id_t frame_id;
+  if (!page_table_.Find(page_id, &frame_id) || pages_[frame_id].page_id_ != page_id) {
+    std::scoped_lock<std::recursive_mutex> lock(latch_);
+    if (!page_table_.Find(page_id, &frame_id)) {
+      return true;
+    }
+  }
+  // a clean unpin must not hide the modifications of another user of the page
+  if (is_dirty) {
+    MarkDirty(pages_[frame_id]);
+  }
+  return UnpinFrame(frame_id);
+}
+
+bool BufferPoolManagerInstance::FlushPage(page_id_t page_id) {
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
+
+  frame_id_t frame_id;
+  if (!page_table_.Find(page_id, &frame_id)) {
+    return false;
+  }
+  WaitForFlush(frame_id);
+  disk_manager_->WritePage(page_id, pages_[frame_id].GetData());
+  MarkClean(pages_[frame_id]);
+  return true;
+}
+
+size_t BufferPoolManagerInstance::FlushDirtyPages(size_t max_pages) {
+  // latch_ before flush_latch_, like the threads that wait for a batch while holding latch_
+  std::unique_lock<std::recursive_mutex> lock(latch_);
+  std::scoped_lock<std::mutex> flush_lock(flush_latch_);
+  max_pages = std::min(max_pages, pool_size_);
+  if (flush_buffer_.size() < max_pages * PAGE_SIZE) {
+    flush_buffer_.resize(max_pages * PAGE_SIZE);
+  }
+  vector<pair<frame_id_t, page_id_t>> frames;
+  vector<pair<page_id_t, const char *>> batch;
+  // resume where the last scan stopped, so that every dirty frame gets its turn
+  size_t scanned = 0;
+  for (; scanned < pool_size_ && batch.size() < max_pages; scanned++) {
+    frame_id_t frame_id = static_cast<frame_id_t>((flush_cursor_ + scanned) % pool_size_);
+    Page &page = pages_[frame_id];
+    if (!page.IsDirty()) {
+      continue;
+    }
+    // only unpinned pages, nobody can modify them while the pin count is -1
+    int expected = 0;
+    if (!page.pin_count_.compare_exchange_strong(expected, -1)) {
+      continue;
+    }
+    char *copy = flush_buffer_.data() + batch.size() * PAGE_SIZE;
+    memcpy(copy, page.data_, PAGE_SIZE);
+    MarkClean(page);
+    flushing_[frame_id] = true;
+    page.pin_count_ = 0;
+    frames.emplace_back(frame_id, page.page_id_);
+    batch.emplace_back(page.page_id_, copy);
+  }
+  flush_cursor_ = (flush_cursor_ + scanned) % pool_size_;
+  lock.unlock();
+  if (batch.empty()) {
+    return 0;
+  }
+  sort(batch.begin(), batch.end());
+  // submitted at once, the backend keeps all of them in flight
+  bool written = disk_manager_->WritePagesAsync(batch).get();
+  for (auto [frame_id, page_id] : frames) {
+    // the frame can not be evicted before flushing_ is cleared, the check only guards against a bogus mapping
+    if (!written && pages_[frame_id].page_id_ == page_id) {
+      MarkDirty(pages_[frame_id]);
+    }
+    flushing_[frame_id] = false;
+  }
+  if (!written) {
+    LOG(ERROR) << "Failed to write back a batch of " << batch.size() << " pages, they stay dirty";
+    return 0;
+  }
+  num_background_writes_ += batch.size();
+  num_background_batches_++;
+  return batch.size();
+}
+
+void BufferPoolManagerInstance::FlushAllPages() {
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
+  for (size_t i = 0; i < pool_size_; i++) {
+    page_id_t page_id = pages_[i].page_id_;
+    if (page_id != INVALID_PAGE_ID) {
+      FlushPage(page_id);
+    }
+  }
+}
+
+frame_id_t BufferPoolManagerInstance::TryToFindFreePage() {
+  if (!free_list_.empty()) {
+    frame_id_t frame_id = free_list_.front();
+    free_list_.pop_front();
+    return frame_id;
+  }
+  frame_id_t frame_id;
+  while (replacer_->Victim(&frame_id)) {
+    // must be cleared before the CAS, so that an unpin racing with a failed CAS puts the frame back
+    in_replacer_[frame_id] = false;
+    if (ReplayPendingAccess(frame_id)) {
+      // used without the latch since it entered the replacer: second chance
+      replacer_->Unpin(frame_id);
+      in_replacer_[frame_id] = true;
+      continue;
+    }
+    // a latch-free hit may have pinned the victim in the meantime, it goes back to the replacer on its last unpin
+    int expected = 0;
+    if (pages_[frame_id].pin_count_.compare_exchange_strong(expected, -1)) {
+      replacer_->Remove(frame_id);
+      return frame_id;
+    }
+  }
+  return INVALID_FRAME_ID;
+}
+
+frame_id_t BufferPoolManagerInstance::LoadPage(page_id_t page_id) {
+  frame_id_t frame_id = TryToFindFreePage(); // 获取一个空闲的frame
+  if (frame_id == INVALID_FRAME_ID) {
+    return INVALID_FRAME_ID;
+  }
+  EvictFrame(frame_id);
+  Page &page = pages_[frame_id];
+  disk_manager_->ReadPage(page_id, page.data_); // 从disk上读取逻辑页号为page_id的数据
+  page.page_id_ = page_id;
+  pending_access_[frame_id] = 0;
+  page_table_.Insert(page_id, frame_id);
+  return frame_id;
+}
+
+void BufferPoolManagerInstance::EvictFrame(frame_id_t frame_id) {
+  Page &page = pages_[frame_id];
+  if (page.page_id_ == INVALID_PAGE_ID) { // from the free list
+    return;
+  }
+  WaitForFlush(frame_id);
+  num_evictions_++;
+  if (page.IsDirty()) {
+    disk_manager_->WritePage(page.page_id_, page.data_);
+    MarkClean(page);
+  } else {
+    num_clean_evictions_++;
+  }
+  page_table_.Erase(page.page_id_); // 通过frame_id获取page_id
+  page.page_id_ = INVALID_PAGE_ID;
+}
+
+bool BufferPoolManagerInstance::TryPinFrame(frame_id_t frame_id, page_id_t page_id) {
+  Page &page = pages_[frame_id];
+  int pin_count = page.pin_count_.load();
+  do {
+    if (pin_count < 0) {
+      return false;
+    }
+  } while (!page.pin_count_.compare_exchange_weak(pin_count, pin_count + 1));
+  // the lookup may be stale: the frame could have been recycled for another page before we pinned it
+  if (page.page_id_ != page_id) {
+    UnpinFrame(frame_id);
+    return false;
+  }
+  return true;
+}
+
+bool BufferPoolManagerInstance::UnpinFrame(frame_id_t frame_id) {
+  Page &page = pages_[frame_id];
+  int pin_count = page.pin_count_.load();
+  do {
+    if (pin_count <= 0) {
+      return false;
+    }
+  } while (!page.pin_count_.compare_exchange_weak(pin_count, pin_count - 1));
+  if (pin_count > 1 || in_replacer_[frame_id]) {
+    return true;
+  }
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
+  // somebody may have pinned the frame again before we got the latch, their last unpin will do this instead
+  if (page.pin_count_ != 0 || in_replacer_[frame_id]) {
+    return true;
+  }
+  ReplayPendingAccess(frame_id);
+  replacer_->Unpin(frame_id);
+  in_replacer_[frame_id] = true;
+  return true;
+}
+
+bool BufferPoolManagerInstance::ReplayPendingAccess(frame_id_t frame_id) {
+  uint8_t pending = pending_access_[frame_id].exchange(0);
+  if (pending == 0) {
+    return false;
+  }
+  replacer_->RecordAccess(frame_id, (pending & RANDOM_ACCESS_SEEN) ? kRandomAccess : kSequentialAccess);
+  return true;
+}
+
+// Only used for debug
+bool BufferPoolManagerInstance::CheckAllUnpinned() {
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
+  bool res = true;
+  for (size_t i = 0; i < pool_size_; i++) {
+    if (pages_[i].pin_count_ > 0) {
+      res = false;
+      LOG(ERROR) << "page " << pages_[i].page_id_ << " pin count:" << pages_[i].pin_count_ << endl;
+    }
+  }
+  return res;
+}
+
+void BufferPoolManagerInstance::CollectStats(BufferPoolStats *stats) const {
+  stats->dirty_pages_ += num_dirty_;
+  stats->evictions_ += num_evictions_;
+  stats->clean_evictions_ += num_clean_evictions_;
+  stats->background_writes_ += num_background_writes_;
+  stats->background_batches_ += num_background_batches_;
+}
@@ -0,0 +1,57 @@
+#include "buffer/clock_replacer.h"
+
+CLOCKReplacer::CLOCKReplacer(size_t num_pages)
+    : capacity(num_pages), in_replacer_(num_pages, 0), ref_bits_(num_pages, 0) {}
+
+CLOCKReplacer::~CLOCKReplacer() = default;
+
+bool CLOCKReplacer::Victim(frame_id_t *frame_id) {
+  if (size_ == 0) {
+    return false;
+  }
+  // every frame gets at most one second chance, so two full sweeps always find a victim
+  for (size_t i = 0; i < 2 * capacity; i++) {
+    size_t cur = hand_;
+    hand_ = (hand_ + 1) % capacity;
+    if (!in_replacer_[cur]) {
+      continue;
+    }
+    if (ref_bits_[cur]) {
+      ref_bits_[cur] = 0;
+      continue;
+    }
+    in_replacer_[cur] = 0;
+    size_--;
+    *frame_id = static_cast<frame_id_t>(cur);
+    return true;
+  }
+  return false;
+}
+
+void CLOCKReplacer::Pin(frame_id_t frame_id) {
+  if (frame_id < 0 || static_cast<size_t>(frame_id) >= capacity || !in_replacer_[frame_id]) {
+    return;
+  }
+  in_replacer_[frame_id] = 0;
+  size_--;
+}
+
+void CLOCKReplacer::Unpin(frame_id_t frame_id) {
+  if (frame_id < 0 || static_cast<size_t>(frame_id) >= capacity) {
+    return;
+  }
+  ref_bits_[frame_id] = 1;
+  if (!in_replacer_[frame_id]) {
+    in_replacer_[frame_id] = 1;
+    size_++;
+  }
+}
+
+void CLOCKReplacer::Remove(frame_id_t frame_id) {
+  Pin(frame_id);
+  if (frame_id >= 0 && static_cast<size_t>(frame_id) < capacity) {
+    ref_bits_[frame_id] = 0;
+  }
+}
+
+size_t CLOCKReplacer::Size() { return size_; }
@@ -1,48 +1,59 @@
 #include "buffer/lru_replacer.h"
 
-LRUReplacer::LRUReplacer(size_t num_pages) : num_pages_(num_pages){}
+LRUReplacer::LRUReplacer(size_t num_pages)
+    : num_pages_(num_pages),
+      sentinel_(static_cast<frame_id_t>(num_pages)),
+      prev_(num_pages + 1, INVALID_FRAME_ID),
+      next_(num_pages + 1, INVALID_FRAME_ID) {
+  prev_[sentinel_] = sentinel_;
+  next_[sentinel_] = sentinel_;
+}
 
 LRUReplacer::~LRUReplacer() = default;
 
-/**
- * TODO: Student Implement
- */
 bool LRUReplacer::Victim(frame_id_t *frame_id) {
-  if (lru_list_.empty()) {
+  if (size_ == 0) {
     return false;
-  } else{
-    unordered_set<int>::iterator it = lru_list_.begin();
-    for (uint32_t i = 0 ; i < lru_list_.size(); i++, it++) {
-      if (i == lru_list_.size() - 1) {
-        *frame_id = *it;
-        lru_list_.erase(it);
-        return true;
-      }
-    }
   }
-  return false;
+  // the least recently used frame sits right after the sentinel
+  *frame_id = next_[sentinel_];
+  Unlink(*frame_id);
+  return true;
 }
 
-/**
- * TODO: Student Implement
- */
 void LRUReplacer::Pin(frame_id_t frame_id) {
-  lru_list_.erase(frame_id);
+  if (frame_id < 0 || static_cast<size_t>(frame_id) >= num_pages_ || !InList(frame_id)) {
+    return;
+  }
+  Unlink(frame_id);
 }
 
-/**
- * TODO: Student Implement
- */
 void LRUReplacer::Unpin(frame_id_t frame_id) {
-  if (lru_list_.size() >= num_pages_) {
+  if (frame_id < 0 || static_cast<size_t>(frame_id) >= num_pages_ || InList(frame_id)) {
     return;
   }
-  lru_list_.insert(frame_id);
+  PushBack(frame_id);
+}
+
+void LRUReplacer::Remove(frame_id_t frame_id) { Pin(frame_id); }
+
+size_t LRUReplacer::Size() { return size_; }
+
+void LRUReplacer::Unlink(frame_id_t frame_id) {
+  frame_id_t prev = prev_[frame_id];
+  frame_id_t next = next_[frame_id];
+  next_[prev] = next;
+  prev_[next] = prev;
+  prev_[frame_id] = INVALID_FRAME_ID;
+  next_[frame_id] = INVALID_FRAME_ID;
+  size_--;
 }
 
-/**
- * TODO: Student Implement
- */
-size_t LRUReplacer::Size() {
-  return lru_list_.size();
-}
\ No newline at end of file
+void LRUReplacer::PushBack(frame_id_t frame_id) {
+  frame_id_t tail = prev_[sentinel_];
+  next_[tail] = frame_id;
+  prev_[frame_id] = tail;
+  next_[frame_id] = sentinel_;
+  prev_[sentinel_] = frame_id;
+  size_++;
+}
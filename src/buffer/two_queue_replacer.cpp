@@ -0,0 +1,118 @@
+#include "buffer/two_queue_replacer.h"
+
+TwoQueueReplacer::TwoQueueReplacer(size_t num_pages, size_t probation_size)
+    : num_pages_(num_pages),
+      probation_size_(probation_size == 0 ? num_pages / 4 : probation_size),
+      probation_sentinel_(static_cast<frame_id_t>(num_pages)),
+      protected_sentinel_(static_cast<frame_id_t>(num_pages + 1)),
+      state_(num_pages, kUntracked),
+      prev_(num_pages + 2, INVALID_FRAME_ID),
+      next_(num_pages + 2, INVALID_FRAME_ID) {
+  prev_[probation_sentinel_] = next_[probation_sentinel_] = probation_sentinel_;
+  prev_[protected_sentinel_] = next_[protected_sentinel_] = protected_sentinel_;
+}
+
+TwoQueueReplacer::~TwoQueueReplacer() = default;
+
+bool TwoQueueReplacer::Victim(frame_id_t *frame_id) {
+  if (size_ == 0) {
+    return false;
+  }
+  bool protected_empty = next_[protected_sentinel_] == protected_sentinel_;
+  if (num_probation_evictable_ > 0 && (num_probation_ > probation_size_ || protected_empty)) {
+    *frame_id = PopFront(probation_sentinel_);
+  } else if (!protected_empty) {
+    *frame_id = PopFront(protected_sentinel_);
+  } else {
+    *frame_id = PopFront(probation_sentinel_);
+  }
+  return true;
+}
+
+void TwoQueueReplacer::Pin(frame_id_t frame_id) {
+  if (!IsValid(frame_id) || !InList(frame_id)) {
+    return;
+  }
+  Unlink(frame_id);
+}
+
+void TwoQueueReplacer::Unpin(frame_id_t frame_id) {
+  if (!IsValid(frame_id) || InList(frame_id)) {
+    return;
+  }
+  if (state_[frame_id] == kUntracked) {
+    // never accessed through RecordAccess, treat it as a fresh page
+    state_[frame_id] = kProbation;
+    num_probation_++;
+  }
+  PushBack(state_[frame_id] == kProtected ? protected_sentinel_ : probation_sentinel_, frame_id);
+}
+
+void TwoQueueReplacer::RecordAccess(frame_id_t frame_id, AccessType access_type) {
+  if (!IsValid(frame_id)) {
+    return;
+  }
+  if (state_[frame_id] == kUntracked) {
+    state_[frame_id] = kProbation;
+    num_probation_++;
+  } else if (state_[frame_id] == kProbation && access_type != kSequentialAccess) {
+    // second non-scan reference: the page has proven to be hot
+    bool linked = InList(frame_id);
+    if (linked) {
+      Unlink(frame_id);
+    }
+    state_[frame_id] = kProtected;
+    num_probation_--;
+    if (linked) {
+      PushBack(protected_sentinel_, frame_id);
+    }
+  }
+}
+
+void TwoQueueReplacer::Remove(frame_id_t frame_id) {
+  if (!IsValid(frame_id)) {
+    return;
+  }
+  Pin(frame_id);
+  Untrack(frame_id);
+}
+
+size_t TwoQueueReplacer::Size() { return size_; }
+
+void TwoQueueReplacer::Unlink(frame_id_t frame_id) {
+  frame_id_t prev = prev_[frame_id];
+  frame_id_t next = next_[frame_id];
+  next_[prev] = next;
+  prev_[next] = prev;
+  prev_[frame_id] = INVALID_FRAME_ID;
+  next_[frame_id] = INVALID_FRAME_ID;
+  if (state_[frame_id] == kProbation) {
+    num_probation_evictable_--;
+  }
+  size_--;
+}
+
+void TwoQueueReplacer::PushBack(frame_id_t sentinel, frame_id_t frame_id) {
+  frame_id_t tail = prev_[sentinel];
+  next_[tail] = frame_id;
+  prev_[frame_id] = tail;
+  next_[frame_id] = sentinel;
+  prev_[sentinel] = frame_id;
+  if (state_[frame_id] == kProbation) {
+    num_probation_evictable_++;
+  }
+  size_++;
+}
+
+frame_id_t TwoQueueReplacer::PopFront(frame_id_t sentinel) {
+  frame_id_t frame_id = next_[sentinel];
+  Unlink(frame_id);
+  return frame_id;
+}
+
+void TwoQueueReplacer::Untrack(frame_id_t frame_id) {
+  if (state_[frame_id] == kProbation) {
+    num_probation_--;
+  }
+  state_[frame_id] = kUntracked;
+}
@@ -1,5 +1,7 @@
 #include "catalog/catalog.h"
 
+#include <algorithm>
+
 void CatalogMeta::SerializeTo(char *buf) const {
   ASSERT(GetSerializedSize() <= PAGE_SIZE, "Failed to serialize catalog metadata to disk.");
   MACH_WRITE_UINT32(buf, CATALOG_METADATA_MAGIC_NUM);
@@ -95,6 +97,12 @@ CatalogManager::CatalogManager(BufferPoolManager *buffer_pool_manager, LockManag
     for (auto iter : catalog_meta_->index_meta_pages_) {
       LoadIndex(iter.first, iter.second);
     }
+    for (auto iter : catalog_meta_->table_meta_pages_) {
+      ConvertEarlierTable(iter.first, iter.second);
+    }
+    for (auto iter : catalog_meta_->index_meta_pages_) {
+      RebuildEarlierIndex(iter.first, iter.second);
+    }
     next_index_id_ = catalog_meta_->GetNextIndexId();
     next_table_id_ = catalog_meta_->GetNextTableId();
   }
@@ -135,7 +143,8 @@ dberr_t CatalogManager::CreateTable(const string &table_name, TableSchema *schem
   // create table heap
   TableHeap *table_heap = TableHeap::Create(buffer_pool_manager_, deepCopySchema, txn, log_manager_, lock_manager_);
   // create table metadata
-  TableMetadata *table_meta = TableMetadata::Create(next_table_id_, table_name,table_heap->GetFirstPageId() , deepCopySchema);
+  TableMetadata *table_meta = TableMetadata::Create(next_table_id_, table_name,table_heap->GetFirstPageId() , deepCopySchema,
+                                                    table_heap->GetFreeSpaceMapPageId());
 
   // createable info
   table_info = TableInfo::Create();
@@ -352,10 +361,7 @@ dberr_t CatalogManager::DropIndex(const string &table_name, const string &index_
     return error_num;
   }
 
-  auto bpindex = dynamic_cast<BPlusTreeIndex*>(index_info_tobe_deleted->GetIndex());
-  auto bptree = bpindex->GetContainer();
-  auto root_page_id = bptree.GetRootPageId();
-  bptree.Destroy(root_page_id);
+  index_info_tobe_deleted->GetIndex()->Destroy();
 
 
   index_id_t index_id = index_names_[table_name][index_name];
@@ -369,6 +375,25 @@ dberr_t CatalogManager::DropIndex(const string &table_name, const string &index_
   return DB_SUCCESS;
 }
 
+dberr_t CatalogManager::VacuumTable(const string &table_name, Txn *txn, TableHeap::VacuumStats *stats) {
+  TableInfo *table_info = nullptr;
+  auto error_num = GetTable(table_name, table_info);
+  if (error_num != DB_SUCCESS) {
+    return error_num;
+  }
+  std::vector<IndexInfo *> indexes;
+  GetTableIndexes(table_name, indexes);
+  *stats = table_info->GetTableHeap()->Vacuum(txn, [&](Row &row, const RowId &old_rid) {
+    Row key_row;
+    for (auto index_info : indexes) {
+      row.GetKeyFromRow(table_info->GetSchema(), index_info->GetIndexKeySchema(), key_row);
+      index_info->GetIndex()->RemoveEntry(key_row, old_rid, txn);
+      index_info->GetIndex()->InsertEntry(key_row, row.GetRowId(), txn);
+    }
+  });
+  return DB_SUCCESS;
+}
+
 /**
  * TODO: Student Implement
  */
@@ -393,11 +418,15 @@ dberr_t CatalogManager::FlushCatalogMetaPage() const {
 
   TableMetadata *table_meta = nullptr;
   Page* page = buffer_pool_manager_->FetchPage(page_id);
+  if (page == nullptr) {
+    return DB_FAILED;
+  }
   TableMetadata::DeserializeFrom(page->GetData(), table_meta);
   ASSERT(table_meta != nullptr, "Unable to deserialize table_meta_data");
   buffer_pool_manager_->UnpinPage(page_id, false);
 
-  TableHeap *table_heap = TableHeap::Create(buffer_pool_manager_, table_meta->GetFirstPageId(), table_meta->GetSchema(), log_manager_, lock_manager_);
+  TableHeap *table_heap = TableHeap::Create(buffer_pool_manager_, table_meta->GetFirstPageId(), table_meta->GetSchema(), log_manager_,
+                                            lock_manager_, table_meta->GetFreeSpaceMapPageId());
   TableInfo *table_info = TableInfo::Create();
   table_info->Init(table_meta, table_heap);
 
@@ -408,6 +437,75 @@ dberr_t CatalogManager::FlushCatalogMetaPage() const {
   return DB_SUCCESS;
 }
 
+dberr_t CatalogManager::ConvertEarlierTable(const table_id_t table_id, const page_id_t page_id) {
+  TableInfo *table_info = tables_[table_id];
+  TableMetadata *table_meta = table_info->GetTableMetadata();
+  // only tables created before the free space map existed have none, their pages have the earlier header
+  if (table_meta->GetFreeSpaceMapPageId() != INVALID_PAGE_ID) {
+    return DB_SUCCESS;
+  }
+  // indexes of earlier builds are empty until they are rebuilt from the converted pages
+  std::vector<IndexInfo *> indexes;
+  GetTableIndexes(table_info->GetTableName(), indexes);
+  indexes.erase(std::remove_if(indexes.begin(), indexes.end(),
+                               [](IndexInfo *index_info) {
+                                 return !index_info->GetIndexMetadata()->HasNormalizedKeys();
+                               }),
+                indexes.end());
+  auto table_heap = table_info->GetTableHeap();
+  bool converted = table_heap->ConvertEarlierPages(nullptr, [&](Row &row, const RowId &old_rid) {
+    Row key_row;
+    for (auto index_info : indexes) {
+      row.GetKeyFromRow(table_info->GetSchema(), index_info->GetIndexKeySchema(), key_row);
+      index_info->GetIndex()->RemoveEntry(key_row, old_rid, nullptr);
+      index_info->GetIndex()->InsertEntry(key_row, row.GetRowId(), nullptr);
+    }
+  });
+  if (!converted) {
+    LOG(ERROR) << "Failed to convert the pages of table " << table_info->GetTableName() << std::endl;
+    return DB_FAILED;
+  }
+  // the free space map marks the table as converted
+  table_meta->SetFreeSpaceMapPageId(table_heap->GetFreeSpaceMapPageId());
+  Page *page = buffer_pool_manager_->FetchPage(page_id);
+  if (table_meta->GetFreeSpaceMapPageId() == INVALID_PAGE_ID || page == nullptr) {
+    LOG(ERROR) << "Failed to record the free space map of table " << table_info->GetTableName() << std::endl;
+    return DB_FAILED;
+  }
+  table_meta->SerializeTo(page->GetData());
+  buffer_pool_manager_->UnpinPage(page_id, true);
+  return DB_SUCCESS;
+}
+
+dberr_t CatalogManager::RebuildEarlierIndex(const index_id_t index_id, const page_id_t page_id) {
+  IndexInfo *index_info = indexes_[index_id];
+  IndexMetadata *index_meta = index_info->GetIndexMetadata();
+  if (index_meta->HasNormalizedKeys()) {
+    return DB_SUCCESS;
+  }
+  TableInfo *table_info = tables_[index_meta->GetTableId()];
+  auto table_heap = table_info->GetTableHeap();
+  Row key_row;
+  for (auto iter = table_heap->Begin(nullptr); iter != table_heap->End(); ++iter) {
+    iter->GetKeyFromRow(table_info->GetSchema(), index_info->GetIndexKeySchema(), key_row);
+    if (index_info->GetIndex()->InsertEntry(key_row, iter->GetRowId(), nullptr) != DB_SUCCESS) {
+      LOG(ERROR) << "Failed to rebuild index " << index_info->GetIndexName() << " at row "
+                 << iter->GetRowId().GetPageId() << "/" << iter->GetRowId().GetSlotNum() << std::endl;
+      return DB_FAILED;
+    }
+  }
+  // the new magic marks the index as rebuilt
+  index_meta->SetNormalizedKeys();
+  Page *page = buffer_pool_manager_->FetchPage(page_id);
+  if (page == nullptr) {
+    LOG(ERROR) << "Failed to record the rebuild of index " << index_info->GetIndexName() << std::endl;
+    return DB_FAILED;
+  }
+  index_meta->SerializeTo(page->GetData());
+  buffer_pool_manager_->UnpinPage(page_id, true);
+  return DB_SUCCESS;
+}
+
 /**
  * TODO: Student Implement
  */
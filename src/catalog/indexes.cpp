@@ -1,5 +1,7 @@
 #include "catalog/indexes.h"
 
+#include "page/index_roots_page.h"
+
 IndexMetadata::IndexMetadata(const index_id_t index_id, const std::string &index_name, const table_id_t table_id,
                              const std::vector<uint32_t> &key_map)
     : index_id_(index_id), index_name_(index_name), table_id_(table_id), key_map_(key_map) {}
@@ -14,7 +16,7 @@ uint32_t IndexMetadata::SerializeTo(char *buf) const {
   uint32_t ofs = GetSerializedSize();
   ASSERT(ofs <= PAGE_SIZE, "Failed to serialize index info.");
   // magic num
-  MACH_WRITE_UINT32(buf, INDEX_METADATA_MAGIC_NUM);
+  MACH_WRITE_UINT32(buf, INDEX_METADATA_NORMALIZED_KEY_MAGIC_NUM);
   buf += 4;
   // index id
   MACH_WRITE_TO(index_id_t, buf, index_id_);
@@ -54,7 +56,8 @@ uint32_t IndexMetadata::DeserializeFrom(char *buf, IndexMetadata *&index_meta) {
   // magic num
   uint32_t magic_num = MACH_READ_UINT32(buf);
   buf += 4;
-  ASSERT(magic_num == INDEX_METADATA_MAGIC_NUM, "Failed to deserialize index info.");
+  ASSERT(magic_num == INDEX_METADATA_MAGIC_NUM || magic_num == INDEX_METADATA_NORMALIZED_KEY_MAGIC_NUM,
+         "Failed to deserialize index info.");
   // index id
   index_id_t index_id = MACH_READ_FROM(index_id_t, buf);
   buf += 4;
@@ -78,44 +81,58 @@ uint32_t IndexMetadata::DeserializeFrom(char *buf, IndexMetadata *&index_meta) {
   }
   // allocate space for index meta data
   index_meta = new IndexMetadata(index_id, index_name, table_id, key_map);
+  index_meta->normalized_keys_ = magic_num == INDEX_METADATA_NORMALIZED_KEY_MAGIC_NUM;
   return buf - p;
 }
 
-Index *IndexInfo::CreateIndex(BufferPoolManager *buffer_pool_manager, const string &index_type) {
-  // size_t max_size = 0;
-  // for (auto col : key_schema_->GetColumns()) {
-  //   max_size += col->GetLength();
-  // }
-  size_t max_size = 0;
-  uint32_t column_cnt = key_schema_->GetColumns().size();
-  size_t size_bitmap = (column_cnt % 8) ? column_cnt / 8 + 1 : column_cnt / 8;
-  // column_cnt + bitmap
-  max_size += 4 + sizeof(unsigned char) * size_bitmap;
-  for (auto col : key_schema_->GetColumns()) {
-    // length of char column
-    if(col->GetType() == TypeId::kTypeChar)
-      max_size += 4;
-    max_size += col->GetLength();
+Index *IndexInfo::CreateIndex(BufferPoolManager *buffer_pool_manager, const string &index_type, size_t key_size) {
+  if (index_type != "bptree") {
+    return nullptr;
   }
+  index_id_t index_id = meta_data_->index_id_;
+  if (key_size <= 8) {
+    return new BPlusTreeIndex<8>(index_id, key_schema_, buffer_pool_manager);
+  } else if (key_size <= 16) {
+    return new BPlusTreeIndex<16>(index_id, key_schema_, buffer_pool_manager);
+  } else if (key_size <= 32) {
+    return new BPlusTreeIndex<32>(index_id, key_schema_, buffer_pool_manager);
+  } else if (key_size <= 64) {
+    return new BPlusTreeIndex<64>(index_id, key_schema_, buffer_pool_manager);
+  } else if (key_size <= 128) {
+    return new BPlusTreeIndex<128>(index_id, key_schema_, buffer_pool_manager);
+  } else if (key_size <= 256) {
+    return new BPlusTreeIndex<256>(index_id, key_schema_, buffer_pool_manager);
+  }
+  LOG(ERROR) << "GenericKey size is too large";
+  return nullptr;
+}
 
-
-  if (index_type == "bptree") {
-    if (max_size <= 8)
-      max_size = 16;
-    else if (max_size <= 24)
-      max_size = 32;
-    else if (max_size <= 56)
-      max_size = 64;
-    else if (max_size <= 120)
-      max_size = 128;
-    else if (max_size <= 248)
-      max_size = 256;
-    else {
-      LOG(ERROR) << "GenericKey size is too large";
-      return nullptr;
+void IndexInfo::DropEarlierIndex(BufferPoolManager *buffer_pool_manager) {
+  auto roots_page = buffer_pool_manager->FetchPage(INDEX_ROOTS_PAGE_ID);
+  if (roots_page == nullptr) {
+    LOG(ERROR) << "Failed to fetch the index roots page, index " << meta_data_->GetIndexName() << " is not dropped";
+    return;
+  }
+  auto roots = reinterpret_cast<IndexRootsPage *>(roots_page->GetData());
+  page_id_t root_page_id = INVALID_PAGE_ID;
+  roots->GetRootId(meta_data_->index_id_, &root_page_id);
+  // earlier builds recorded their key width in every page, 16 to 256 bytes, a tree of that width finds the children
+  int key_size = 0;
+  if (root_page_id != INVALID_PAGE_ID) {
+    auto root_page = buffer_pool_manager->FetchPage(root_page_id);
+    if (root_page != nullptr) {
+      key_size = reinterpret_cast<BPlusTreePage *>(root_page->GetData())->GetKeySize();
+      buffer_pool_manager->UnpinPage(root_page_id, false);
     }
-  } else {
-    return nullptr;
   }
-  return new BPlusTreeIndex(meta_data_->index_id_, key_schema_, max_size, buffer_pool_manager);
+  if (key_size >= 16 && key_size <= 256 && (key_size & (key_size - 1)) == 0) {
+    Index *earlier_index = CreateIndex(buffer_pool_manager, "bptree", key_size);
+    earlier_index->Destroy();
+    delete earlier_index;
+  } else if (root_page_id != INVALID_PAGE_ID) {
+    LOG(ERROR) << "Failed to read the root of index " << meta_data_->GetIndexName() << ", its pages are not freed";
+  }
+  // the index starts over from an empty tree even if the pages of the earlier one could not be freed
+  roots->Update(meta_data_->index_id_, INVALID_PAGE_ID);
+  buffer_pool_manager->UnpinPage(INDEX_ROOTS_PAGE_ID, true);
 }
@@ -0,0 +1,34 @@
+#include "common/arena.h"
+
+#include <cstdint>
+
+void *Arena::Allocate(size_t bytes, size_t alignment) {
+  ASSERT(alignment <= alignof(std::max_align_t) && (alignment & (alignment - 1)) == 0, "Unsupported alignment.");
+  allocated_bytes_ += bytes;
+  if (bytes > block_size_ / 4) {
+    // the rest of the current block stays available for the small requests that follow
+    blocks_.push_back(new char[bytes]);
+    return blocks_.back();
+  }
+  auto align = [alignment](char *p) {
+    return reinterpret_cast<char *>((reinterpret_cast<uintptr_t>(p) + alignment - 1) & ~(alignment - 1));
+  };
+  char *p = align(current_);
+  if (current_ == nullptr || p + bytes > end_) {
+    blocks_.push_back(new char[block_size_]);
+    current_ = blocks_.back();
+    end_ = current_ + block_size_;
+    p = align(current_);
+  }
+  current_ = p + bytes;
+  return p;
+}
+
+void Arena::Release() {
+  for (auto block : blocks_) {
+    delete[] block;
+  }
+  blocks_.clear();
+  current_ = end_ = nullptr;
+  allocated_bytes_ = 0;
+}
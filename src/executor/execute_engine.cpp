@@ -5,6 +5,7 @@
 #include <sys/types.h>
 
 #include <chrono>
+#include <fstream>
 
 #include "common/result_writer.h"
 #include "executor/executors/delete_executor.h"
@@ -37,7 +38,13 @@ ExecuteEngine::ExecuteEngine() {
         strcmp( stdir->d_name , "..") == 0 ||
         stdir->d_name[0] == '.')
       continue;
-    dbs_[stdir->d_name] = new DBStorageEngine(stdir->d_name, false);
+    try {
+      dbs_[stdir->d_name] = new DBStorageEngine(stdir->d_name, false);
+    } catch (const std::runtime_error &e) {
+      // kept so that the file is not overwritten by a create database with the same name
+      unopened_dbs_[stdir->d_name] = e.what();
+      cout << "Cannot open database " << stdir->d_name << ": " << e.what() << endl;
+    }
   }
 
   closedir(dir);
@@ -88,10 +95,11 @@ dberr_t ExecuteEngine::ExecutePlan(const AbstractPlanNodeRef &plan, std::vector<
 
     executor->Init();
     RowId rid{};
-    Row row{};
+    // output rows and their copies in the result set live in the arena of the query
+    Row row(exec_ctx->GetArena());
     while (executor->Next(&row, &rid)) {
       if (result_set != nullptr) {
-        result_set->push_back(row);
+        result_set->push_back(std::move(row));
       }
     }
   } catch (const exception &ex) {
@@ -108,6 +116,7 @@ dberr_t ExecuteEngine::Execute(pSyntaxNode ast) {
   if (ast == nullptr) {
     return DB_FAILED;
   }
+  std::scoped_lock<std::recursive_mutex> lock(execute_latch_);
   auto start_time = std::chrono::system_clock::now();
   unique_ptr<ExecuteContext> context(nullptr);
   if (!current_db_.empty()) context = dbs_[current_db_]->MakeExecuteContext(nullptr);
@@ -142,6 +151,8 @@ dberr_t ExecuteEngine::Execute(pSyntaxNode ast) {
       return ExecuteExecfile(ast, context.get());
     case kNodeQuit:
       return ExecuteQuit(ast, context.get());
+    case kNodeVacuum:
+      return ExecuteVacuum(ast, context.get());
     default:
       break;
   }
@@ -252,7 +263,7 @@ dberr_t ExecuteEngine::ExecuteCreateDatabase(pSyntaxNode ast, ExecuteContext *co
   LOG(INFO) << "ExecuteCreateDatabase" << std::endl;
 #endif
   string db_name = ast->child_->val_;
-  if (dbs_.find(db_name) != dbs_.end()) {
+  if (dbs_.find(db_name) != dbs_.end() || unopened_dbs_.find(db_name) != unopened_dbs_.end()) {
     return DB_ALREADY_EXIST;
   }
   dbs_.insert(make_pair(db_name, new DBStorageEngine(db_name, true)));
@@ -264,6 +275,10 @@ dberr_t ExecuteEngine::ExecuteDropDatabase(pSyntaxNode ast, ExecuteContext *cont
   LOG(INFO) << "ExecuteDropDatabase" << std::endl;
 #endif
   string db_name = ast->child_->val_;
+  if (unopened_dbs_.erase(db_name) > 0) {
+    remove(("./databases/" + db_name).c_str());
+    return DB_SUCCESS;
+  }
   if (dbs_.find(db_name) == dbs_.end()) {
     return DB_NOT_EXIST;
   }
@@ -311,6 +326,11 @@ dberr_t ExecuteEngine::ExecuteUseDatabase(pSyntaxNode ast, ExecuteContext *conte
     cout << "Database changed" << endl;
     return DB_SUCCESS;
   }
+  auto unopened = unopened_dbs_.find(db_name);
+  if (unopened != unopened_dbs_.end()) {
+    cout << "Cannot open database " << db_name << ": " << unopened->second << endl;
+    return DB_FAILED;
+  }
   return DB_NOT_EXIST;
 }
 
@@ -681,3 +701,73 @@ dberr_t ExecuteEngine::ExecuteQuit(pSyntaxNode ast, ExecuteContext *context) {
 #endif
   return DB_QUIT;
 }
+
+dberr_t ExecuteEngine::ExecuteVacuum(pSyntaxNode ast, ExecuteContext *context) {
+#ifdef ENABLE_EXECUTE_DEBUG
+  LOG(INFO) << "ExecuteVacuum" << std::endl;
+#endif
+  if (current_db_.empty()) {
+    std::cout << "No database!" << endl;
+    return DB_FAILED;
+  }
+  string table_name = ast->child_->val_;
+  auto start_time = std::chrono::system_clock::now();
+  TableHeap::VacuumStats stats;
+  dberr_t dberr = context->GetCatalog()->VacuumTable(table_name, context->GetTransaction(), &stats);
+  if (dberr != DB_SUCCESS) {
+    return dberr;
+  }
+  auto stop_time = std::chrono::system_clock::now();
+  double duration_time =
+      double((std::chrono::duration_cast<std::chrono::milliseconds>(stop_time - start_time)).count());
+  cout << "Vacuum table " << table_name << ": " << stats.pages_reclaimed_ << " of " << stats.pages_before_
+       << " pages reclaimed, " << stats.rows_deleted_ << " deleted rows purged, " << stats.rows_moved_
+       << " rows moved (" << fixed << setprecision(4) << duration_time / 1000 << " sec)." << endl;
+  return DB_SUCCESS;
+}
+
+void ExecuteEngine::StartAutoVacuum(std::chrono::milliseconds interval, size_t dead_tuples) {
+  if (auto_vacuum_.joinable()) {
+    return;
+  }
+  auto_vacuum_interval_ = interval;
+  auto_vacuum_dead_tuples_ = dead_tuples;
+  auto_vacuum_stop_ = false;
+  auto_vacuum_ = std::thread(&ExecuteEngine::RunAutoVacuum, this);
+}
+
+void ExecuteEngine::StopAutoVacuum() {
+  if (!auto_vacuum_.joinable()) {
+    return;
+  }
+  {
+    std::scoped_lock<std::mutex> lock(auto_vacuum_mutex_);
+    auto_vacuum_stop_ = true;
+  }
+  auto_vacuum_cv_.notify_all();
+  auto_vacuum_.join();
+}
+
+void ExecuteEngine::RunAutoVacuum() {
+  std::unique_lock<std::mutex> lock(auto_vacuum_mutex_);
+  while (!auto_vacuum_cv_.wait_for(lock, auto_vacuum_interval_, [this] { return auto_vacuum_stop_; })) {
+    lock.unlock();
+    {
+      std::scoped_lock<std::recursive_mutex> execute_lock(execute_latch_);
+      for (auto &[db_name, db] : dbs_) {
+        std::vector<TableInfo *> tables;
+        db->catalog_mgr_->GetTables(tables);
+        for (auto table_info : tables) {
+          if (table_info->GetTableHeap()->GetDeadTupleCount() < auto_vacuum_dead_tuples_) {
+            continue;
+          }
+          TableHeap::VacuumStats stats;
+          db->catalog_mgr_->VacuumTable(table_info->GetTableName(), nullptr, &stats);
+          LOG(INFO) << "Auto vacuum " << db_name << "." << table_info->GetTableName() << ": "
+                    << stats.pages_reclaimed_ << " of " << stats.pages_before_ << " pages reclaimed" << std::endl;
+        }
+      }
+    }
+    lock.lock();
+  }
+}
@@ -65,7 +65,7 @@ vector<RowId> IndexScanExecutor::IndexScan(AbstractExpressionRef predicate) {
     }
     case ExpressionType::ComparisonExpression: {
       std::vector<RowId> ret;
-      std::vector<Field> fields{predicate->GetChildAt(1)->Evaluate(nullptr)};
+      std::vector<Field> fields{predicate->GetChildAt(1)->Evaluate(static_cast<const Row *>(nullptr))};
       Row key(fields);
       for (auto index : plan_->indexes_) {
         uint32_t col_idx = dynamic_pointer_cast<ColumnValueExpression>(predicate->GetChildAt(0))->GetColIdx();
@@ -4,6 +4,9 @@
 
 #include "executor/executors/insert_executor.h"
 
+#include <string>
+#include <unordered_set>
+
 InsertExecutor::InsertExecutor(ExecuteContext *exec_ctx, const InsertPlanNode *plan,
                                std::unique_ptr<AbstractExecutor> &&child_executor)
     : AbstractExecutor(exec_ctx), plan_(plan), child_executor_(std::move(child_executor)) {}
@@ -13,30 +16,81 @@ void InsertExecutor::Init() {
   exec_ctx_->GetCatalog()->GetTable(plan_->GetTableName(), table_info_);
   schema_ = table_info_->GetSchema();
   exec_ctx_->GetCatalog()->GetTableIndexes(table_info_->GetTableName(), index_info_);
+  inserted_ = false;
+  num_inserted_ = 0;
+}
+
+bool InsertExecutor::Next([[maybe_unused]] Row *row, [[maybe_unused]] RowId *rid) {
+  if (!inserted_) {
+    inserted_ = true;
+    InsertRows();
+  }
+  if (num_inserted_ > 0) {
+    num_inserted_--;
+    return true;
+  }
+  return false;
 }
 
-bool InsertExecutor::Next([[maybe_unused]] Row *row, RowId *rid) {
+void InsertExecutor::InsertRows() {
+  // Pull the rows up to the first one with a value too long for its column or a key that is taken, either in an
+  // index or by a row before it.
+  std::vector<Row> insert_rows;
+  std::vector<std::unordered_set<std::string>> batch_keys(index_info_.size());
   Row insert_row;
   RowId insert_rid;
-  if (child_executor_->Next(&insert_row, &insert_rid)) {
-    for (auto info: index_info_) {
+  bool rejected = false;
+  while (!rejected && child_executor_->Next(&insert_row, &insert_rid)) {
+    uint32_t too_long = insert_row.FindTooLongField(schema_);
+    if (too_long != insert_row.GetFieldCount()) {
+      std::cout << "value too long for column " << schema_->GetColumn(too_long)->GetName() << std::endl;
+      break;
+    }
+    for (size_t i = 0; i < index_info_.size(); i++) {
+      auto info = index_info_[i];
       Row key_row;
-      insert_row.GetKeyFromRow(table_info_->GetSchema(), info->GetIndexKeySchema(), key_row);
+      insert_row.GetKeyFromRow(schema_, info->GetIndexKeySchema(), key_row);
+      if (key_row.GetFields().empty()) {
+        continue;
+      }
       std::vector<RowId> result;
-      if (!key_row.GetFields().empty() &&
-          info->GetIndex()->ScanKey(key_row, result, exec_ctx_->GetTransaction()) == DB_SUCCESS) {
+      std::string key(key_row.GetSerializedSize(info->GetIndexKeySchema()), '\0');
+      key_row.SerializeTo(key.data(), info->GetIndexKeySchema());
+      if (info->GetIndex()->ScanKey(key_row, result, exec_ctx_->GetTransaction()) == DB_SUCCESS ||
+          !batch_keys[i].insert(std::move(key)).second) {
         std::cout << "key already exists" << std::endl;
-        return false;
-          }
-    }
-    if (table_info_->GetTableHeap()->InsertTuple(insert_row, exec_ctx_->GetTransaction())) {
-      Row key_row;
-      for (auto info: index_info_) {  // 更新索引
-        insert_row.GetKeyFromRow(schema_, info->GetIndexKeySchema(), key_row);
-        info->GetIndex()->InsertEntry(key_row, insert_row.GetRowId(), exec_ctx_->GetTransaction());
+        rejected = true;
+        break;
       }
-      return true;
+    }
+    if (!rejected) {
+      insert_rows.emplace_back(insert_row);
+      insert_rows.back().SetRowId(INVALID_ROWID);
     }
   }
-  return false;
-}
\ No newline at end of file
+  if (insert_rows.empty()) {
+    return;
+  }
+
+  // One row goes wherever the free space map finds room, more rows are packed page by page.
+  auto table_heap = table_info_->GetTableHeap();
+  if (insert_rows.size() == 1) {
+    if (!table_heap->InsertTuple(insert_rows[0], exec_ctx_->GetTransaction())) {
+      return;
+    }
+  } else {
+    table_heap->BulkInsert(insert_rows, exec_ctx_->GetTransaction());
+  }
+  Row key_row;
+  for (auto &inserted_row : insert_rows) {
+    // rows after the first one BulkInsert could not place have no rid
+    if (inserted_row.GetRowId().GetPageId() == INVALID_PAGE_ID) {
+      break;
+    }
+    for (auto info : index_info_) {  // 更新索引
+      inserted_row.GetKeyFromRow(schema_, info->GetIndexKeySchema(), key_row);
+      info->GetIndex()->InsertEntry(key_row, inserted_row.GetRowId(), exec_ctx_->GetTransaction());
+    }
+    num_inserted_++;
+  }
+}
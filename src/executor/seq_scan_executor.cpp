@@ -26,16 +26,14 @@ bool SeqScanExecutor::SchemaEqual(const Schema *table_schema, const Schema *outp
   return true;
 }
 
-void SeqScanExecutor::TupleTransfer(const Schema *table_schema, const Schema *output_schema, const Row *row,
+void SeqScanExecutor::TupleTransfer(const Schema *table_schema, const Schema *output_schema, const RowView &view,
                                     Row *output_row) {
-  const auto &output_columns = output_schema->GetColumns();
-  std::vector<Field> dest_row;
-  dest_row.reserve(output_columns.size());
-  for (const auto column : output_columns) {
-    auto idx = column->GetTableInd();
-    dest_row.emplace_back(*row->GetField(idx));
+  // the output row outlives the page, AddField copies the chars out of it
+  output_row->destroy();
+  output_row->SetRowId(view.GetRowId());
+  for (const auto column : output_schema->GetColumns()) {
+    output_row->AddField(view.GetField(column->GetTableInd()));
   }
-  *output_row = Row(dest_row);
 }
 
 void SeqScanExecutor::Init() {
@@ -51,20 +49,21 @@ bool SeqScanExecutor::Next(Row *row, RowId *rid) {
   auto table_schema = table_info_->GetSchema();
   TableIterator tmp = table_info_->GetTableHeap()->End();
   while (iterator_ != tmp) {
-    auto p_row = &(*iterator_);
+    // the predicate reads the row in its page, only matching rows are copied out
+    const RowView &view = iterator_.View();
     if (predicate != nullptr) {
-      if (!predicate->Evaluate(p_row).CompareEquals(Field(kTypeInt, 1))) {
-        iterator_++;
+      if (!predicate->Evaluate(&view).CompareEquals(Field(kTypeInt, 1))) {
+        ++iterator_;
         continue;
       }
     }
-    *rid = iterator_->GetRowId();
+    *rid = view.GetRowId();
     if (!is_schema_same_) {
-      TupleTransfer(table_schema, schema_, p_row, row);
+      TupleTransfer(table_schema, schema_, view, row);
     } else {
-      *row = *p_row;
+      view.ToRow(row);
     }
-    iterator_++;
+    ++iterator_;
     return true;
   }
   return false;
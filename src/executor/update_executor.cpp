@@ -20,6 +20,12 @@ bool UpdateExecutor::Next([[maybe_unused]] Row *row, RowId *rid) {
   RowId src_rid;
   if (child_executor_->Next(&src_row, &src_rid)) {
     Row dest_row = GenerateUpdatedTuple(src_row);
+    uint32_t too_long = dest_row.FindTooLongField(table_info_->GetSchema());
+    if (too_long != dest_row.GetFieldCount()) {
+      std::cout << "value too long for column " << table_info_->GetSchema()->GetColumn(too_long)->GetName()
+                << std::endl;
+      return false;
+    }
     if (!table_info_->GetTableHeap()->UpdateTuple(dest_row, src_rid, txn_)) {
       return false;
     }
@@ -49,5 +55,5 @@ Row UpdateExecutor::GenerateUpdatedTuple(const Row &src_row) {
       values.emplace_back(expr->Evaluate(&src_row));
     }
   }
-  return Row{values};
+  return Row(std::move(values));
 }
\ No newline at end of file
@@ -1,24 +1,67 @@
 #ifndef MINISQL_BUFFER_POOL_MANAGER_H
 #define MINISQL_BUFFER_POOL_MANAGER_H
 
+#include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <list>
 #include <mutex>
+#include <thread>
 #include <unordered_map>
+#include <vector>
 
-#include "buffer/lru_replacer.h"
+#include "buffer/buffer_pool_manager_instance.h"
 #include "page/disk_file_meta_page.h"
 #include "page/page.h"
 #include "storage/disk_manager.h"
 
 using namespace std;
 
+/**
+ * Reads the id of the page that follows page in a chain of pages, such as the next_page_id link of table pages.
+ */
+using NextPageFunc = page_id_t (*)(Page *page);
+
+/**
+ * BufferPoolManager splits its frames into num_instances independent BufferPoolManagerInstances. A page always lives
+ * in instance page_id % num_instances, so concurrent sessions only contend when they touch the same shard.
+ *
+ * An optional background flusher thread keeps the share of dirty frames of every instance below a high watermark by
+ * writing back unpinned pages in batches, so that foreground fetches mostly evict clean frames. Another thread, started
+ * on the first PrefetchPages() call, reads pages ahead of table scans.
+ */
 class BufferPoolManager {
  public:
-  explicit BufferPoolManager(size_t pool_size, DiskManager *disk_manager);
+  explicit BufferPoolManager(size_t pool_size, DiskManager *disk_manager, ReplacerType replacer_type = kLRUReplacer,
+                             size_t num_instances = 1);
 
   ~BufferPoolManager();
 
-  Page *FetchPage(page_id_t page_id);
+  /**
+   * Fetch a page and pin it.
+   * @param access_type kSequentialAccess for fetches issued by table scans, lets scan resistant replacers keep the
+   * page in probation
+   */
+  Page *FetchPage(page_id_t page_id, AccessType access_type = kRandomAccess);
+
+  /**
+   * Fetch and pin a page only if it is already cached, never waits for I/O.
+   * @return nullptr if the page is not in the pool yet
+   */
+  Page *TryFetchPage(page_id_t page_id, AccessType access_type = kRandomAccess);
+
+  /**
+   * Ask the prefetch thread to read pages into the pool, unpinned, and return immediately. Requests are dropped when
+   * the prefetch queue already holds pool_size pages.
+   */
+  void PrefetchPages(const vector<page_id_t> &page_ids);
+
+  /**
+   * Ask the prefetch thread to read the num_pages pages that follow page_id in the chain linked by next_page, and
+   * return immediately. The thread follows the links of the pages as it loads them, pages of the chain that are
+   * already cached are walked through without I/O. The walk stops early if page_id is no longer cached.
+   */
+  void PrefetchChain(page_id_t page_id, size_t num_pages, NextPageFunc next_page);
 
   bool UnpinPage(page_id_t page_id, bool is_dirty);
 
@@ -26,12 +69,44 @@ class BufferPoolManager {
 
   Page *NewPage(page_id_t &page_id);
 
+  /**
+   * Create a new page taken from a run of contiguous pages, so that the pages of one table or index are laid out
+   * sequentially on disk. A new run of PAGE_RUN_SIZE pages is reserved once the run is used up, a single page is
+   * allocated anywhere if no extent has room for a whole run.
+   */
+  Page *NewPage(page_id_t &page_id, PageRun &run);
+
+  /**
+   * Give the pages of a run that were never handed out back to the disk manager.
+   */
+  void ReleasePages(PageRun &run);
+
   bool DeletePage(page_id_t page_id);
 
   bool IsPageFree(page_id_t page_id);
 
   bool CheckAllUnpinned();
 
+  size_t GetPoolSize() const { return pool_size_; }
+
+  size_t GetNumInstances() const { return instances_.size(); }
+
+  /**
+   * Start the background flusher. Once more than high_watermark of the frames of an instance are dirty, it writes
+   * back unpinned pages of that instance, batch_size at a time, until at most low_watermark of them are dirty.
+   * Does nothing if the flusher is already running.
+   */
+  void StartBackgroundFlusher(double low_watermark = FLUSHER_LOW_WATERMARK,
+                              double high_watermark = FLUSHER_HIGH_WATERMARK, size_t batch_size = FLUSHER_BATCH_SIZE,
+                              std::chrono::milliseconds interval = std::chrono::milliseconds(FLUSHER_INTERVAL_MS));
+
+  /**
+   * Stop the background flusher and wait for its current batch, called by the destructor.
+   */
+  void StopBackgroundFlusher();
+
+  BufferPoolStats GetStats() const;
+
  private:
   /**
    * Allocate new page (operations like create index/table) For now just keep an increasing counter
@@ -43,16 +118,55 @@ class BufferPoolManager {
    */
   void DeallocatePage(page_id_t page_id);
 
-  frame_id_t TryToFindFreePage();
+  /**
+   * Main loop of the background flusher thread.
+   */
+  void RunBackgroundFlusher();
+
+  /**
+   * Main loop of the prefetch thread.
+   */
+  void RunPrefetcher();
+
+  void StopPrefetcher();
+
+  /**
+   * A page to prefetch, or the start of a chain of num_pages_ pages if next_page_ is set.
+   */
+  struct PrefetchRequest {
+    page_id_t page_id_;
+    size_t num_pages_;
+    NextPageFunc next_page_;
+  };
+
+  /**
+   * Load the pages of a chain request, run by the prefetch thread.
+   */
+  void LoadChain(const PrefetchRequest &request);
+
+  inline BufferPoolManagerInstance *GetInstance(page_id_t page_id) {
+    return instances_[static_cast<size_t>(page_id) % instances_.size()];
+  }
 
  private:
-  size_t pool_size_;                                 // number of pages in buffer pool
-  Page *pages_;                                      // array of pages
-  DiskManager *disk_manager_;                        // pointer to the disk manager.
-  unordered_map<page_id_t, frame_id_t> page_table_;  // to keep track of pages
-  Replacer *replacer_;                               // to find an unpinned page for replacement
-  list<frame_id_t> free_list_;                       // to find a free page for replacement
-  recursive_mutex latch_;                            // to protect shared data structure
+  size_t pool_size_;                                // number of pages in buffer pool
+  DiskManager *disk_manager_;                       // pointer to the disk manager.
+  vector<BufferPoolManagerInstance *> instances_;  // shards of the buffer pool
+  // background flusher
+  thread flusher_;
+  mutex flusher_mutex_;
+  condition_variable flusher_cv_;
+  bool flusher_stop_{false};
+  double flusher_low_watermark_{FLUSHER_LOW_WATERMARK};
+  double flusher_high_watermark_{FLUSHER_HIGH_WATERMARK};
+  size_t flusher_batch_size_{FLUSHER_BATCH_SIZE};
+  std::chrono::milliseconds flusher_interval_{FLUSHER_INTERVAL_MS};
+  // prefetch thread
+  thread prefetcher_;
+  mutex prefetch_mutex_;
+  condition_variable prefetch_cv_;
+  deque<PrefetchRequest> prefetch_queue_;
+  bool prefetch_stop_{false};
 };
 
 #endif  // MINISQL_BUFFER_POOL_MANAGER_H
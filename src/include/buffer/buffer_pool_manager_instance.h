@@ -0,0 +1,191 @@
+#ifndef MINISQL_BUFFER_POOL_MANAGER_INSTANCE_H
+#define MINISQL_BUFFER_POOL_MANAGER_INSTANCE_H
+
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <vector>
+
+#include "buffer/clock_replacer.h"
+#include "buffer/lru_replacer.h"
+#include "buffer/page_table.h"
+#include "buffer/two_queue_replacer.h"
+#include "page/page.h"
+#include "storage/disk_manager.h"
+
+using namespace std;
+
+/**
+ * Counters of a buffer pool, summed over the instances by BufferPoolManager::GetStats().
+ */
+struct BufferPoolStats {
+  size_t dirty_pages_{0};         // frames currently holding a modified page
+  size_t evictions_{0};           // pages dropped to make room for another one
+  size_t clean_evictions_{0};     // evictions that found the victim clean and did no write
+  size_t background_writes_{0};   // pages written back by the background flusher
+  size_t background_batches_{0};  // batches issued by the background flusher
+};
+
+/**
+ * BufferPoolManagerInstance is one shard of the BufferPoolManager. It caches the pages whose id maps to it, with its
+ * own frames, page table, free list, replacer and latch, so that shards never contend with each other.
+ * Page ids are allocated and released by the owning BufferPoolManager.
+ *
+ * Hits are served without the latch: the page is looked up in the lock free PageTable and pinned with a CAS on its
+ * atomic pin count, which fails while the frame is free or being evicted (pin count -1). A frame pinned this way
+ * stays in the replacer, so unpinning it needs no latch either. Only misses, evictions and the last unpin of a frame
+ * that left the replacer take the latch.
+ *
+ * The replacers are not thread safe, so latch-free hits only leave a note in pending_access_. It is replayed when the
+ * replacer picks the frame as a victim, which gives the frame a second chance instead of evicting it.
+ *
+ * FlushDirtyPages() cleans unpinned frames ahead of eviction. It copies the pages under the latch, then writes the
+ * copies without it while holding flush_latch_. Anything that is about to write or drop a frame that is in such a
+ * batch first waits for the batch, so a stale copy can never overwrite a newer version of the page. Such a waiter
+ * holds the latch, so flush_latch_ is only ever taken after the latch, never the other way around.
+ */
+class BufferPoolManagerInstance {
+ public:
+  explicit BufferPoolManagerInstance(size_t pool_size, DiskManager *disk_manager, ReplacerType replacer_type);
+
+  ~BufferPoolManagerInstance();
+
+  Page *FetchPage(page_id_t page_id, AccessType access_type);
+
+  /**
+   * Pin a page only if it is already in the pool, never does any I/O.
+   * @return nullptr if the page is not cached or is being loaded or evicted
+   */
+  Page *TryFetchPage(page_id_t page_id, AccessType access_type);
+
+  /**
+   * Load a page into the pool without pinning it, as if it had been fetched by a table scan.
+   * @return false if every frame of the instance is pinned
+   */
+  bool PrefetchPage(page_id_t page_id);
+
+  bool UnpinPage(page_id_t page_id, bool is_dirty);
+
+  bool FlushPage(page_id_t page_id);
+
+  /**
+   * Bring a freshly allocated page into the pool, zeroed out and pinned.
+   * @return nullptr if every frame of the instance is pinned
+   */
+  Page *NewPage(page_id_t page_id);
+
+  /**
+   * Drop a page from the pool, the caller is responsible for releasing the page id on disk.
+   * @return false if the page is still pinned
+   */
+  bool DeletePage(page_id_t page_id);
+
+  /**
+   * Flush every page held by the instance.
+   */
+  void FlushAllPages();
+
+  /**
+   * Write back up to max_pages dirty and unpinned pages in one batch sorted by page id, so that later evictions find
+   * clean victims. Used by the background flusher of BufferPoolManager. Pages of a batch that fails to be written
+   * are marked dirty again.
+   * @return number of pages written, 0 if the batch failed
+   */
+  size_t FlushDirtyPages(size_t max_pages);
+
+  bool CheckAllUnpinned();
+
+  size_t GetPoolSize() const { return pool_size_; }
+
+  size_t GetNumDirtyPages() const { return num_dirty_; }
+
+  /**
+   * Add the counters of this instance to stats.
+   */
+  void CollectStats(BufferPoolStats *stats) const;
+
+ private:
+  /** Bits of pending_access_. */
+  static constexpr uint8_t RANDOM_ACCESS_SEEN = 1;
+  static constexpr uint8_t SEQUENTIAL_ACCESS_SEEN = 2;
+
+  /**
+   * Find a frame for a new page, from the free list first and the replacer otherwise. Must hold the latch.
+   * @return a frame whose pin count is -1, or INVALID_FRAME_ID if every frame is pinned
+   */
+  frame_id_t TryToFindFreePage();
+
+  /**
+   * Read a page from disk into a frame taken from TryToFindFreePage(), and map it in the page table. Must hold the
+   * latch.
+   * @return the frame, its pin count is still -1, or INVALID_FRAME_ID if every frame is pinned
+   */
+  frame_id_t LoadPage(page_id_t page_id);
+
+  /**
+   * Write back the page held by a frame returned by TryToFindFreePage() if needed, and drop it from the page table.
+   * Must hold the latch.
+   */
+  void EvictFrame(frame_id_t frame_id);
+
+  /**
+   * Wait until the batch of the background flusher that holds a copy of the frame, if any, is on disk. Must hold the
+   * latch, the flusher takes the latch before flush_latch_ and writes the batch without it.
+   */
+  inline void WaitForFlush(frame_id_t frame_id) {
+    if (flushing_[frame_id]) {
+      std::scoped_lock<std::mutex> lock(flush_latch_);
+    }
+  }
+
+  inline void MarkDirty(Page &page) {
+    if (!page.is_dirty_.exchange(true)) {
+      num_dirty_++;
+    }
+  }
+
+  inline void MarkClean(Page &page) {
+    if (page.is_dirty_.exchange(false)) {
+      num_dirty_--;
+    }
+  }
+
+  /**
+   * Pin a frame found without the latch, if it still holds page_id.
+   */
+  bool TryPinFrame(frame_id_t frame_id, page_id_t page_id);
+
+  /**
+   * Drop one pin of a frame, the last unpin hands the frame back to the replacer if it is not there already.
+   * @return false if the frame was not pinned
+   */
+  bool UnpinFrame(frame_id_t frame_id);
+
+  /**
+   * Report the latch-free accesses of a frame to the replacer. Must hold the latch.
+   * @return true if there was any
+   */
+  bool ReplayPendingAccess(frame_id_t frame_id);
+
+ private:
+  size_t pool_size_;                                 // number of pages in buffer pool
+  Page *pages_;                                      // array of pages
+  DiskManager *disk_manager_;                        // pointer to the disk manager.
+  PageTable page_table_;                             // to keep track of pages
+  Replacer *replacer_;                               // to find an unpinned page for replacement
+  list<frame_id_t> free_list_;                       // to find a free page for replacement
+  vector<atomic<uint8_t>> pending_access_;           // accesses not yet reported to the replacer
+  vector<atomic<bool>> in_replacer_;                 // whether the frame is tracked by the replacer
+  vector<atomic<bool>> flushing_;                    // whether the frame is in the batch being flushed
+  recursive_mutex latch_;                            // to protect shared data structure
+  mutex flush_latch_;                                // held while a batch of the flusher is written
+  vector<char> flush_buffer_;                        // copies of the pages being flushed, under flush_latch_
+  size_t flush_cursor_{0};                           // frame the next flusher scan starts from, under latch_
+  atomic<size_t> num_dirty_{0};
+  atomic<size_t> num_evictions_{0};
+  atomic<size_t> num_clean_evictions_{0};
+  atomic<size_t> num_background_writes_{0};
+  atomic<size_t> num_background_batches_{0};
+};
+
+#endif  // MINISQL_BUFFER_POOL_MANAGER_INSTANCE_H
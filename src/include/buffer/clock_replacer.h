@@ -16,6 +16,9 @@ using namespace std;
 
 /**
  * CLOCKReplacer implements the clock replacement.
+ *
+ * Every frame owns one slot of two flat arrays: whether the frame can currently be victimized, and its reference
+ * bit. The clock hand sweeps the slots in frame order, giving frames with the reference bit set a second chance.
  */
 class CLOCKReplacer : public Replacer {
  public:
@@ -36,12 +39,16 @@ class CLOCKReplacer : public Replacer {
 
   void Unpin(frame_id_t frame_id) override;
 
+  void Remove(frame_id_t frame_id) override;
+
   size_t Size() override;
 
  private:
   size_t capacity;
-  list<frame_id_t> clock_list;               // replacer中可以被替换的数据页
-  map<frame_id_t, frame_id_t> clock_status;  // 数据页的存储状态
+  size_t size_{0};
+  size_t hand_{0};                 // next frame the clock hand looks at
+  vector<uint8_t> in_replacer_;    // 1 if the frame can be victimized
+  vector<uint8_t> ref_bits_;       // reference bit of each frame
 };
 
-#endif  // MINISQL_CLOCK_REPLACER_H
\ No newline at end of file
+#endif  // MINISQL_CLOCK_REPLACER_H
@@ -13,6 +13,10 @@ using namespace std;
 
 /**
  * LRUReplacer implements the Least Recently Used replacement policy.
+ *
+ * Unpinned frames are kept in an intrusive doubly linked list threaded through two frame-indexed arrays, so that
+ * Pin/Unpin/Victim are all O(1). The list head is the least recently unpinned frame, the tail the most recent one.
+ * Slot num_pages_ of the link arrays is the list sentinel.
  */
 class LRUReplacer : public Replacer {
  public:
@@ -33,16 +37,26 @@ class LRUReplacer : public Replacer {
 
   void Unpin(frame_id_t frame_id) override;
 
- void Remove(frame_id_t frame_id) {
-  lru_list_.erase(frame_id);
- }
+  void Remove(frame_id_t frame_id) override;
 
   size_t Size() override;
 
-private:
-  // add your own private member variables here
-  unordered_set<frame_id_t> lru_list_;
- size_t num_pages_;
+ private:
+  /** @return true if the frame is currently linked into the lru list */
+  inline bool InList(frame_id_t frame_id) const { return prev_[frame_id] != INVALID_FRAME_ID; }
+
+  /** Unlink a frame from the lru list, the frame must be in the list. */
+  void Unlink(frame_id_t frame_id);
+
+  /** Append a frame to the tail (most recently used end) of the lru list. */
+  void PushBack(frame_id_t frame_id);
+
+ private:
+  size_t num_pages_;
+  size_t size_{0};
+  frame_id_t sentinel_;
+  vector<frame_id_t> prev_;  // prev_[frame] is INVALID_FRAME_ID iff frame is not in the list
+  vector<frame_id_t> next_;
 };
 
 #endif  // MINISQL_LRU_REPLACER_H
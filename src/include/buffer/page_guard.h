@@ -0,0 +1,66 @@
+#ifndef MINISQL_PAGE_GUARD_H
+#define MINISQL_PAGE_GUARD_H
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/macros.h"
+#include "page/page.h"
+
+/**
+ * Holds one pin on a page of the buffer pool, so that pointers into the page data stay valid while the guard holds
+ * it. The page is unpinned, not dirty, when the guard is reset, moved onto or destroyed. Guards only pin, readers of
+ * the page still latch it where they need a consistent image.
+ */
+class PageGuard {
+ public:
+  PageGuard() = default;
+
+  /**
+   * Fetch and pin page_id.
+   */
+  PageGuard(BufferPoolManager *bpm, page_id_t page_id, AccessType access_type = kRandomAccess)
+      : bpm_(bpm), page_(bpm->FetchPage(page_id, access_type)) {}
+
+  PageGuard(PageGuard &&other) noexcept : bpm_(other.bpm_), page_(other.page_) { other.page_ = nullptr; }
+
+  PageGuard &operator=(PageGuard &&other) noexcept {
+    if (this != &other) {
+      Reset();
+      bpm_ = other.bpm_;
+      page_ = other.page_;
+      other.page_ = nullptr;
+    }
+    return *this;
+  }
+
+  DISALLOW_COPY(PageGuard);
+
+  ~PageGuard() { Reset(); }
+
+  /**
+   * Unpin the page, the guard is empty afterwards.
+   */
+  void Reset() {
+    if (page_ != nullptr) {
+      bpm_->UnpinPage(page_->GetPageId(), false);
+      page_ = nullptr;
+    }
+  }
+
+  /**
+   * @return nullptr if the guard is empty or the fetch failed
+   */
+  inline Page *GetPage() const { return page_; }
+
+  inline page_id_t GetPageId() const { return page_ == nullptr ? INVALID_PAGE_ID : page_->GetPageId(); }
+
+  template <class T>
+  inline T *As() const {
+    return reinterpret_cast<T *>(page_);
+  }
+
+ private:
+  BufferPoolManager *bpm_{nullptr};
+  Page *page_{nullptr};
+};
+
+#endif  // MINISQL_PAGE_GUARD_H
@@ -0,0 +1,126 @@
+#ifndef MINISQL_PAGE_TABLE_H
+#define MINISQL_PAGE_TABLE_H
+
+#include <atomic>
+#include <memory>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+/**
+ * PageTable maps page ids to frame ids with a fixed-size, open-addressed, linear probing hash table.
+ *
+ * Every slot is one 64-bit atomic word holding the (page_id, frame_id) pair, so Find() never sees a torn entry and
+ * needs no latch. Insert() and Erase() must be serialized by the caller (the buffer pool instance latch). Erase()
+ * uses backward shift deletion, so a Find() racing with it may miss an entry that is being moved: a miss is only a
+ * hint and must be confirmed under the latch, a hit must be validated against the frame's page id.
+ */
+class PageTable {
+ public:
+  /**
+   * @param num_frames number of frames of the buffer pool, the table gets at least twice as many slots
+   */
+  explicit PageTable(size_t num_frames) {
+    capacity_ = 1;
+    while (capacity_ < 2 * num_frames) {
+      capacity_ <<= 1;
+    }
+    mask_ = capacity_ - 1;
+    slots_ = std::make_unique<std::atomic<uint64_t>[]>(capacity_);
+    for (size_t i = 0; i < capacity_; i++) {
+      slots_[i].store(EMPTY_SLOT, std::memory_order_relaxed);
+    }
+  }
+
+  DISALLOW_COPY(PageTable)
+
+  /**
+   * Lock free lookup.
+   * @return true and set frame_id if page_id was found
+   */
+  bool Find(page_id_t page_id, frame_id_t *frame_id) const {
+    for (size_t i = Hash(page_id), probes = 0; probes < capacity_; i = (i + 1) & mask_, probes++) {
+      uint64_t slot = slots_[i].load(std::memory_order_acquire);
+      if (slot == EMPTY_SLOT) {
+        return false;
+      }
+      if (KeyOf(slot) == page_id) {
+        *frame_id = ValueOf(slot);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+   * Insert or overwrite a mapping. Caller must hold the buffer pool latch.
+   */
+  void Insert(page_id_t page_id, frame_id_t frame_id) {
+    size_t i = Hash(page_id);
+    while (true) {
+      uint64_t slot = slots_[i].load(std::memory_order_relaxed);
+      if (slot == EMPTY_SLOT || KeyOf(slot) == page_id) {
+        slots_[i].store(Pack(page_id, frame_id), std::memory_order_release);
+        return;
+      }
+      i = (i + 1) & mask_;
+    }
+  }
+
+  /**
+   * Remove a mapping if it exists. Caller must hold the buffer pool latch.
+   */
+  void Erase(page_id_t page_id) {
+    size_t i = Hash(page_id);
+    while (true) {
+      uint64_t slot = slots_[i].load(std::memory_order_relaxed);
+      if (slot == EMPTY_SLOT) {
+        return;
+      }
+      if (KeyOf(slot) == page_id) {
+        break;
+      }
+      i = (i + 1) & mask_;
+    }
+    // backward shift: pull later entries of the probe chain into the hole so that no tombstone is needed
+    size_t hole = i;
+    size_t j = i;
+    while (true) {
+      j = (j + 1) & mask_;
+      uint64_t slot = slots_[j].load(std::memory_order_relaxed);
+      if (slot == EMPTY_SLOT) {
+        break;
+      }
+      size_t home = Hash(KeyOf(slot));
+      // the entry can move into the hole iff its home slot is not cyclically within (hole, j]
+      if (((j - home) & mask_) >= ((j - hole) & mask_)) {
+        slots_[hole].store(slot, std::memory_order_release);
+        hole = j;
+      }
+    }
+    slots_[hole].store(EMPTY_SLOT, std::memory_order_release);
+  }
+
+ private:
+  static constexpr uint64_t EMPTY_SLOT = ~static_cast<uint64_t>(0);
+
+  static inline uint64_t Pack(page_id_t page_id, frame_id_t frame_id) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(page_id)) << 32) | static_cast<uint32_t>(frame_id);
+  }
+
+  static inline page_id_t KeyOf(uint64_t slot) { return static_cast<page_id_t>(slot >> 32); }
+
+  static inline frame_id_t ValueOf(uint64_t slot) { return static_cast<frame_id_t>(slot & 0xffffffffu); }
+
+  /** Fibonacci hashing, page ids are mostly consecutive. */
+  inline size_t Hash(page_id_t page_id) const {
+    return static_cast<size_t>((static_cast<uint32_t>(page_id) * 0x9E3779B97F4A7C15ull) >> 32) & mask_;
+  }
+
+ private:
+  size_t capacity_;
+  size_t mask_;
+  std::unique_ptr<std::atomic<uint64_t>[]> slots_;
+};
+
+#endif  // MINISQL_PAGE_TABLE_H
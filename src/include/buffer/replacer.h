@@ -5,6 +5,17 @@
 
 #include "common/config.h"
 
+/**
+ * Page replacement policies a BufferPoolManager can be built with.
+ */
+enum ReplacerType { kLRUReplacer = 0, kClockReplacer, kTwoQueueReplacer };
+
+/**
+ * How a page is being accessed. Sequential accesses come from full table scans, a replacement policy may keep such
+ * pages from displacing the frequently used ones.
+ */
+enum AccessType { kRandomAccess = 0, kSequentialAccess };
+
 /**
  * Replacer is an abstract class that tracks page usage.
  */
@@ -33,6 +44,21 @@ class Replacer {
    */
   virtual void Unpin(frame_id_t frame_id) = 0;
 
+  /**
+   * Records an access to the page held by a frame. Called on every fetch before the frame is pinned, policies that
+   * do not keep an access history simply ignore it.
+   * @param frame_id the id of the accessed frame
+   * @param access_type whether the access is part of a sequential scan
+   */
+  virtual void RecordAccess(frame_id_t /*frame_id*/, AccessType /*access_type*/) {}
+
+  /**
+   * Stops tracking a frame altogether and forgets its access history, e.g. because its page was deleted or the frame
+   * is about to hold another page.
+   * @param frame_id the id of the frame to remove
+   */
+  virtual void Remove(frame_id_t frame_id) = 0;
+
   /** @return the number of elements in the replacer that can be victimized */
   virtual size_t Size() = 0;
 };
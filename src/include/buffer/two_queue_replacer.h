@@ -0,0 +1,85 @@
+#ifndef MINISQL_TWO_QUEUE_REPLACER_H
+#define MINISQL_TWO_QUEUE_REPLACER_H
+
+#include <vector>
+
+#include "buffer/replacer.h"
+#include "common/config.h"
+
+using namespace std;
+
+/**
+ * TwoQueueReplacer implements a simplified 2Q replacement policy.
+ *
+ * A frame whose page has just been loaded starts in the probationary queue (a FIFO). It is promoted to the protected
+ * queue (an LRU) only when it is accessed again by a non-sequential access, so pages touched once, or only by table
+ * scans, never displace the pages that are used over and over (index internal pages, catalog pages...).
+ * Victims come from the probationary queue as long as it holds more than probation_size frames, and from the
+ * protected queue otherwise. A victim keeps its history until Remove() is called, which the buffer pool does once it
+ * reuses the frame for another page.
+ *
+ * Both queues are intrusive doubly linked lists threaded through frame-indexed arrays like in LRUReplacer, slots
+ * num_pages_ and num_pages_ + 1 of the link arrays are the sentinels of the two queues.
+ */
+class TwoQueueReplacer : public Replacer {
+ public:
+  /**
+   * Create a new TwoQueueReplacer.
+   * @param num_pages the maximum number of pages the TwoQueueReplacer will be required to store
+   * @param probation_size number of frames the probationary queue may hold before it becomes the only eviction
+   * source, a quarter of the pool when 0
+   */
+  explicit TwoQueueReplacer(size_t num_pages, size_t probation_size = 0);
+
+  /**
+   * Destroys the TwoQueueReplacer.
+   */
+  ~TwoQueueReplacer() override;
+
+  bool Victim(frame_id_t *frame_id) override;
+
+  void Pin(frame_id_t frame_id) override;
+
+  void Unpin(frame_id_t frame_id) override;
+
+  void RecordAccess(frame_id_t frame_id, AccessType access_type) override;
+
+  void Remove(frame_id_t frame_id) override;
+
+  size_t Size() override;
+
+ private:
+  enum FrameState : uint8_t { kUntracked = 0, kProbation, kProtected };
+
+  inline bool InList(frame_id_t frame_id) const { return prev_[frame_id] != INVALID_FRAME_ID; }
+
+  inline bool IsValid(frame_id_t frame_id) const {
+    return frame_id >= 0 && static_cast<size_t>(frame_id) < num_pages_;
+  }
+
+  /** Unlink a frame from the queue it is in. */
+  void Unlink(frame_id_t frame_id);
+
+  /** Append a frame to the tail of the queue with the given sentinel. */
+  void PushBack(frame_id_t sentinel, frame_id_t frame_id);
+
+  /** Pop the head of the queue with the given sentinel, which must not be empty. */
+  frame_id_t PopFront(frame_id_t sentinel);
+
+  /** Forget the access history of a frame. */
+  void Untrack(frame_id_t frame_id);
+
+ private:
+  size_t num_pages_;
+  size_t probation_size_;
+  size_t size_{0};
+  size_t num_probation_{0};            // frames in probation state, pinned or not
+  size_t num_probation_evictable_{0};  // frames linked into the probationary queue
+  frame_id_t probation_sentinel_;
+  frame_id_t protected_sentinel_;
+  vector<uint8_t> state_;
+  vector<frame_id_t> prev_;  // prev_[frame] is INVALID_FRAME_ID iff frame is not in a queue
+  vector<frame_id_t> next_;
+};
+
+#endif  // MINISQL_TWO_QUEUE_REPLACER_H
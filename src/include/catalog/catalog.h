@@ -103,6 +103,11 @@ class CatalogManager {
 
   dberr_t DropIndex(const std::string &table_name, const std::string &index_name);
 
+  /**
+   * Vacuum the table heap of a table and point the entries of its indexes to the tuples it moved.
+   */
+  dberr_t VacuumTable(const std::string &table_name, Txn *txn, TableHeap::VacuumStats *stats);
+
  private:
   dberr_t DropTable(table_id_t table_id);
 
@@ -112,6 +117,20 @@ class CatalogManager {
 
   dberr_t LoadIndex(const index_id_t index_id, const page_id_t page_id);
 
+  /**
+   * Convert the pages of a table created before table pages had FreeSlot and DeadSpace in their header, indexes
+   * follow the tuples that move. Records the free space map built on the way in the table metadata, which marks the
+   * table as converted.
+   */
+  dberr_t ConvertEarlierTable(const table_id_t table_id, const page_id_t page_id);
+
+  /**
+   * Insert every row of its table into an index of an earlier build, whose tree was dropped when it was loaded because
+   * its keys were serialized rows. Runs once the pages of the table are converted. Records the index as rebuilt in its
+   * metadata.
+   */
+  dberr_t RebuildEarlierIndex(const index_id_t index_id, const page_id_t page_id);
+
   dberr_t GetTable(const table_id_t table_id, TableInfo *&table_info);
 
  private:
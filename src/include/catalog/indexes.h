@@ -33,6 +33,11 @@ class IndexMetadata {
 
   inline index_id_t GetIndexId() const { return index_id_; }
 
+  /** @return false for an index of an earlier build, whose B+ tree keys are serialized rows */
+  inline bool HasNormalizedKeys() const { return normalized_keys_; }
+
+  inline void SetNormalizedKeys() { normalized_keys_ = true; }
+
  private:
   IndexMetadata() = delete;
 
@@ -41,10 +46,13 @@ class IndexMetadata {
 
  private:
   static constexpr uint32_t INDEX_METADATA_MAGIC_NUM = 344528;
+  /** Written since keys are normalized, see KeyManager. Metadata with the earlier magic is read as not normalized. */
+  static constexpr uint32_t INDEX_METADATA_NORMALIZED_KEY_MAGIC_NUM = 344529;
   index_id_t index_id_;
   std::string index_name_;
   table_id_t table_id_;
   std::vector<uint32_t> key_map_; /** The mapping of index key to tuple key */
+  bool normalized_keys_{true};
 };
 
 /**
@@ -69,11 +77,16 @@ class IndexInfo {
     // Step3: call CreateIndex to create the index
     meta_data_ = meta_data;
     key_schema_ = table_info->GetSchema()->ShallowCopySchema(table_info->GetSchema(), meta_data_->GetKeyMapping());
-    index_ = CreateIndex(buffer_pool_manager, "bptree");
+    if (!meta_data_->HasNormalizedKeys()) {
+      DropEarlierIndex(buffer_pool_manager);
+    }
+    index_ = CreateIndex(buffer_pool_manager, "bptree", KeyManager::GetNormalizedKeySize(key_schema_));
   }
 
   inline Index *GetIndex() { return index_; }
 
+  inline IndexMetadata *GetIndexMetadata() const { return meta_data_; }
+
   std::string GetIndexName() { return meta_data_->GetIndexName(); }
 
   IndexSchema *GetIndexKeySchema() { return key_schema_; }
@@ -81,7 +94,16 @@ class IndexInfo {
  private:
   explicit IndexInfo() : meta_data_{nullptr}, index_{nullptr}, key_schema_{nullptr} {}
 
-  Index *CreateIndex(BufferPoolManager *buffer_pool_manager, const string &index_type);
+  /**
+   * @param key_size bytes a key takes, the index gets the smallest key width it fits in
+   */
+  Index *CreateIndex(BufferPoolManager *buffer_pool_manager, const string &index_type, size_t key_size);
+
+  /**
+   * Free the pages of the B+ tree of an index of an earlier build. The index is empty afterwards, its rows have to be
+   * inserted again.
+   */
+  void DropEarlierIndex(BufferPoolManager *buffer_pool_manager);
 
  private:
   IndexMetadata *meta_data_;
@@ -0,0 +1,53 @@
+#ifndef MINISQL_ARENA_H
+#define MINISQL_ARENA_H
+
+#include <cstddef>
+#include <memory_resource>
+#include <vector>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+/**
+ * Bump allocator for memory that lives as long as one query. Allocations are carved out of blocks taken from the
+ * heap, ARENA_BLOCK_SIZE bytes at a time, and nothing is given back before Release() or the destruction of the arena,
+ * which free all blocks at once. Requests larger than a quarter block get a block of their own. It is a
+ * std::pmr::memory_resource so that containers can keep their storage in it. Not thread safe.
+ */
+class Arena : public std::pmr::memory_resource {
+ public:
+  explicit Arena(size_t block_size = ARENA_BLOCK_SIZE) : block_size_(block_size) {}
+
+  ~Arena() override { Release(); }
+
+  DISALLOW_COPY_AND_MOVE(Arena);
+
+  void *Allocate(size_t bytes, size_t alignment = alignof(std::max_align_t));
+
+  /**
+   * Free every block, all memory handed out before becomes invalid.
+   */
+  void Release();
+
+  /** @return bytes handed out since the last Release() */
+  inline size_t GetAllocatedBytes() const { return allocated_bytes_; }
+
+  /** @return blocks taken from the heap */
+  inline size_t GetBlockCount() const { return blocks_.size(); }
+
+ protected:
+  void *do_allocate(size_t bytes, size_t alignment) override { return Allocate(bytes, alignment); }
+
+  void do_deallocate(void *, size_t, size_t) override {}
+
+  bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override { return this == &other; }
+
+ private:
+  size_t block_size_;
+  std::vector<char *> blocks_;
+  char *current_{nullptr};  // next free byte of the block small requests are served from
+  char *end_{nullptr};
+  size_t allocated_bytes_{0};
+};
+
+#endif  // MINISQL_ARENA_H
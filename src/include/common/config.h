@@ -13,10 +13,31 @@ static constexpr int META_PAGE_ID = 0;          // physical page id of the disk
 static constexpr int CATALOG_META_PAGE_ID = 0;  // logical page id of the catalog meta data
 static constexpr int INDEX_ROOTS_PAGE_ID = 1;   // logical page id of the index roots
 
-static constexpr int PAGE_SIZE = 4096;                  // size of a data page in byte
-static constexpr int DEFAULT_BUFFER_POOL_SIZE = 20480;  // default size of buffer pool
+#ifndef MINISQL_PAGE_SIZE
+#define MINISQL_PAGE_SIZE 4096
+#endif
+
+static constexpr int PAGE_SIZE = MINISQL_PAGE_SIZE;      // size of a data page in byte, set by CMake
+static constexpr int DEFAULT_BUFFER_POOL_SIZE = 20480;   // default size of buffer pool
+static constexpr int DEFAULT_BUFFER_POOL_INSTANCES = 1;  // default number of buffer pool shards
+
+static constexpr double FLUSHER_HIGH_WATERMARK = 0.3;  // share of dirty frames above which the flusher cleans a shard
+static constexpr double FLUSHER_LOW_WATERMARK = 0.1;   // share of dirty frames the flusher cleans a shard down to
+static constexpr int FLUSHER_BATCH_SIZE = 64;          // max pages written back by the flusher in one batch
+static constexpr int FLUSHER_INTERVAL_MS = 10;         // how often the flusher checks the watermarks
+static constexpr int DEFAULT_READ_AHEAD_PAGES = 0;     // pages a table scan keeps in flight ahead of itself, 0: off
+static constexpr int DISK_IO_QUEUE_DEPTH = 128;        // max asynchronous disk requests in flight with io_uring
+static constexpr int DISK_IO_THREADS = 4;              // threads of the asynchronous disk I/O fallback
+static constexpr int PAGE_RUN_SIZE = 64;               // contiguous pages a table heap or index reserves at once
+static constexpr int AUTO_VACUUM_INTERVAL_MS = 1000;   // how often the auto vacuum looks for tables to vacuum
+static constexpr int AUTO_VACUUM_DEAD_TUPLES = 1000;   // deleted tuples of a table from which on it is vacuumed
+static constexpr int ARENA_BLOCK_SIZE = 64 * 1024;     // bytes a query memory arena takes from the heap at once
+
+static_assert(PAGE_SIZE >= 4096 && PAGE_SIZE <= 32768 && (PAGE_SIZE & (PAGE_SIZE - 1)) == 0,
+              "PAGE_SIZE must be 4096, 8192, 16384 or 32768");
 
 static constexpr uint32_t FIELD_NULL_LEN = UINT32_MAX;
+static constexpr uint32_t FIELD_INLINE_LEN = 16;  // chars up to this length are stored inside their Field
 static constexpr uint32_t VARCHAR_MAX_LEN = PAGE_SIZE / 2;  // max length of varchar
 
 // static std::string DB_META_FILE = "minisql.meta.db";
@@ -14,7 +14,9 @@
 
 class DBStorageEngine {
  public:
-  explicit DBStorageEngine(std::string db_name, bool init = true, uint32_t buffer_pool_size = DEFAULT_BUFFER_POOL_SIZE);
+  explicit DBStorageEngine(std::string db_name, bool init = true, uint32_t buffer_pool_size = DEFAULT_BUFFER_POOL_SIZE,
+                           ReplacerType replacer_type = kLRUReplacer,
+                           uint32_t buffer_pool_instances = DEFAULT_BUFFER_POOL_INSTANCES);
 
   ~DBStorageEngine();
 
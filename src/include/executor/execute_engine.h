@@ -1,8 +1,12 @@
 #ifndef MINISQL_EXECUTE_ENGINE_H
 #define MINISQL_EXECUTE_ENGINE_H
 
+#include <chrono>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <unordered_map>
 
 #include "common/dberr.h"
@@ -25,6 +29,7 @@ class ExecuteEngine {
   ExecuteEngine();
 
   ~ExecuteEngine() {
+    StopAutoVacuum();
     for (auto it : dbs_) {
       delete it.second;
     }
@@ -40,6 +45,18 @@ class ExecuteEngine {
 
   void ExecuteInformation(dberr_t result);
 
+  /**
+   * Start the auto vacuum thread. Every interval it vacuums the tables of all databases with at least dead_tuples
+   * tuples deleted since their last vacuum, between two statements. Does nothing if it is already running.
+   */
+  void StartAutoVacuum(std::chrono::milliseconds interval = std::chrono::milliseconds(AUTO_VACUUM_INTERVAL_MS),
+                       size_t dead_tuples = AUTO_VACUUM_DEAD_TUPLES);
+
+  /**
+   * Stop the auto vacuum thread and wait for its current round, called by the destructor.
+   */
+  void StopAutoVacuum();
+
  private:
   static std::unique_ptr<AbstractExecutor> CreateExecutor(ExecuteContext *exec_ctx, const AbstractPlanNodeRef &plan);
 
@@ -73,9 +90,25 @@ class ExecuteEngine {
 
   dberr_t ExecuteQuit(pSyntaxNode ast, ExecuteContext *context);
 
+  dberr_t ExecuteVacuum(pSyntaxNode ast, ExecuteContext *context);
+
+  /**
+   * Main loop of the auto vacuum thread.
+   */
+  void RunAutoVacuum();
+
  private:
-  std::unordered_map<std::string, DBStorageEngine *> dbs_; /** all opened databases */
-  std::string current_db_;                                 /** current database */
+  std::unordered_map<std::string, DBStorageEngine *> dbs_;    /** all opened databases */
+  std::unordered_map<std::string, std::string> unopened_dbs_; /** database files that failed to open, and why */
+  std::string current_db_;                                    /** current database */
+  std::recursive_mutex execute_latch_;                        /** held while a statement runs */
+  // auto vacuum
+  std::thread auto_vacuum_;
+  std::mutex auto_vacuum_mutex_;
+  std::condition_variable auto_vacuum_cv_;
+  bool auto_vacuum_stop_{false};
+  std::chrono::milliseconds auto_vacuum_interval_{AUTO_VACUUM_INTERVAL_MS};
+  size_t auto_vacuum_dead_tuples_{AUTO_VACUUM_DEAD_TUPLES};
 };
 
 #endif  // MINISQL_EXECUTE_ENGINE_H
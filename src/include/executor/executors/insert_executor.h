@@ -12,7 +12,8 @@
 /**
  * InsertExecutor executes an insert on a table.
  *
- * Inserted values are always pulled from a child executor.
+ * Inserted values are always pulled from a child executor. The first call to Next() inserts all of them, as one
+ * batch when there are several, then each call reports one inserted row.
  */
 class InsertExecutor : public AbstractExecutor {
  public:
@@ -42,12 +43,17 @@ class InsertExecutor : public AbstractExecutor {
   const Schema *GetOutputSchema() const override { return plan_->OutputSchema(); }
 
  private:
+  /** Insert the rows of the child executor into the table and its indexes, stops at the first duplicate key. */
+  void InsertRows();
+
   /** The insert plan node to be executed*/
   const InsertPlanNode *plan_;
   std::unique_ptr<AbstractExecutor> child_executor_;
   TableInfo *table_info_{};
   const Schema *schema_{};
   std::vector<IndexInfo *> index_info_;
+  bool inserted_{false};
+  size_t num_inserted_{0};
 };
 
 #endif  // MINISQL_INSERT_EXECUTOR_H
@@ -39,7 +39,7 @@ class SeqScanExecutor : public AbstractExecutor {
 
   bool SchemaEqual(const Schema *table_schema, const Schema *output_schema);
 
-  void TupleTransfer(const Schema *table_schema, const Schema *output_schema, const Row *row, Row *output_row);
+  void TupleTransfer(const Schema *table_schema, const Schema *output_schema, const RowView &view, Row *output_row);
 
  private:
   /** The sequential scan plan node to be executed */
@@ -1,6 +1,7 @@
 #ifndef MINISQL_B_PLUS_TREE_H
 #define MINISQL_B_PLUS_TREE_H
 
+#include <fstream>
 #include <queue>
 #include <string>
 #include <vector>
@@ -20,42 +21,50 @@
  * (2) support insert & remove
  * (3) The structure should shrink and grow dynamically
  * (4) Implement index iterator for range scan
+ * Keys are KeySize bytes, so that pages have a fixed stride.
  */
+INDEX_TEMPLATE_ARGUMENTS
 class BPlusTree {
-  using InternalPage = BPlusTreeInternalPage;
-  using LeafPage = BPlusTreeLeafPage;
+  using KeyType = GenericKey<KeySize>;
+  using InternalPage = BPlusTreeInternalPage<KeySize>;
+  using LeafPage = BPlusTreeLeafPage<KeySize>;
 
  public:
   explicit BPlusTree(index_id_t index_id, BufferPoolManager *buffer_pool_manager, const KeyManager &comparator,
                      int leaf_max_size = UNDEFINED_SIZE, int internal_max_size = UNDEFINED_SIZE);
 
+  // Give the pages reserved for this tree but never used back to the disk manager.
+  ~BPlusTree();
+
+  DISALLOW_COPY(BPlusTree)
+
   // Returns true if this B+ tree has no keys and values.
   bool IsEmpty() const;
 
   // Insert a key-value pair into this B+ tree.
-  bool Insert(GenericKey *key, const RowId &value, Txn *transaction = nullptr);
+  bool Insert(KeyType *key, const RowId &value, Txn *transaction = nullptr);
 
   // Remove a key and its value from this B+ tree.
-  void Remove(const GenericKey *key, Txn *transaction = nullptr);
+  void Remove(const KeyType *key, Txn *transaction = nullptr);
 
   // return the value associated with a given key
-  bool GetValue(const GenericKey *key, std::vector<RowId> &result, Txn *transaction = nullptr);
+  bool GetValue(const KeyType *key, std::vector<RowId> &result, Txn *transaction = nullptr);
 
   Page* FindRightMostLeafPage(page_id_t page_id);
 
-  IndexIterator Begin();
+  IndexIterator<KeySize> Begin();
 
-  IndexIterator Begin(const GenericKey *key);
+  IndexIterator<KeySize> Begin(const KeyType *key);
 
-  IndexIterator End();
+  IndexIterator<KeySize> End();
 
   // expose for test purpose
-  Page *FindLeafPage(const GenericKey *key, page_id_t page_id = INVALID_PAGE_ID, bool leftMost = false);
+  Page *FindLeafPage(const KeyType *key, page_id_t page_id = INVALID_PAGE_ID, bool leftMost = false);
 
   // used to check whether all pages are unpinned
   bool Check();
 
-  // destroy the b plus tree
+  // destroy the b plus tree, or the subtree under current_page_id, and free its pages
   void Destroy(page_id_t current_page_id = INVALID_PAGE_ID);
 
   inline page_id_t GetRootPageId() const {
@@ -74,11 +83,11 @@ class BPlusTree {
   }
 
  private:
-  void StartNewTree(GenericKey *key, const RowId &value);
+  void StartNewTree(KeyType *key, const RowId &value);
 
-  bool InsertIntoLeaf(GenericKey *key, const RowId &value, Txn *transaction = nullptr);
+  bool InsertIntoLeaf(KeyType *key, const RowId &value, Txn *transaction = nullptr);
 
-  void InsertIntoParent(BPlusTreePage *old_node, GenericKey *key, BPlusTreePage *new_node, Txn *transaction = nullptr);
+  void InsertIntoParent(BPlusTreePage *old_node, KeyType *key, BPlusTreePage *new_node, Txn *transaction = nullptr);
 
   LeafPage *Split(LeafPage *node, Txn *transaction);
 
@@ -115,6 +124,7 @@ class BPlusTree {
   KeyManager processor_;
   int leaf_max_size_;
   int internal_max_size_;
+  PageRun page_run_;  // new nodes are taken from this run, so that the leaf chain is mostly sequential on disk
 };
 
 #endif  // MINISQL_B_PLUS_TREE_H
@@ -5,9 +5,15 @@
 #include "index/generic_key.h"
 #include "index/index.h"
 
+/**
+ * B+ tree on keys of KeySize bytes, IndexInfo::CreateIndex picks the smallest width the keys fit in.
+ */
+INDEX_TEMPLATE_ARGUMENTS
 class BPlusTreeIndex : public Index {
+  using KeyType = GenericKey<KeySize>;
+
  public:
-  BPlusTreeIndex(index_id_t index_id, IndexSchema *key_schema, size_t key_size, BufferPoolManager *buffer_pool_manager);
+  BPlusTreeIndex(index_id_t index_id, IndexSchema *key_schema, BufferPoolManager *buffer_pool_manager);
 
   dberr_t InsertEntry(const Row &key, RowId row_id, Txn *txn) override;
 
@@ -17,19 +23,19 @@ class BPlusTreeIndex : public Index {
 
   dberr_t Destroy() override;
 
-  IndexIterator GetBeginIterator();
+  IndexIterator<KeySize> GetBeginIterator();
 
-  IndexIterator GetBeginIterator(GenericKey *key);
+  IndexIterator<KeySize> GetBeginIterator(KeyType *key);
 
-  IndexIterator GetEndIterator();
+  IndexIterator<KeySize> GetEndIterator();
 
-  BPlusTree GetContainer() { return container_; }
+  BPlusTree<KeySize> &GetContainer() { return container_; }
 
  protected:
   // comparator for key
   KeyManager processor_;
   // container
-  BPlusTree container_;
+  BPlusTree<KeySize> container_;
 };
 
 #endif  // MINISQL_B_PLUS_TREE_INDEX_H
@@ -1,73 +1,156 @@
 #ifndef MINISQL_GENERIC_KEY_H
 #define MINISQL_GENERIC_KEY_H
 
+#include <algorithm>
 #include <cstring>
+#include <string_view>
 
 #include "record/field.h"
 #include "record/row.h"
 
+/**
+ * Index key of KeySize bytes, the B+ tree is instantiated for the widths in IndexInfo::CreateIndex. Keys are plain
+ * bytes, they can live on the stack and are copied with memcpy.
+ */
+template <size_t KeySize>
 class GenericKey {
   friend class KeyManager;
-  char data[0];
+  char data[KeySize];
 };
 
+/**
+ * Keys are stored normalized, so that two keys of an index compare with a single memcmp. Every key column is a byte,
+ * 0 for null and 1 otherwise, followed by
+ *  - int: the value big-endian with the sign bit flipped
+ *  - float: the bits big-endian, all of them flipped for negative numbers and only the sign bit for the others
+ *  - char: the chars padded with zeros to the column length, then the length big-endian
+ * The value of a null is zeros, so nulls come first. Columns have a fixed width, all keys of an index have the same
+ * length, see GetNormalizedKeySize. The bytes of a GenericKey after the key are zeros.
+ */
 class KeyManager {
  public: /**/
-  [[nodiscard]] inline GenericKey *InitKey() const {
-    return (GenericKey *)malloc(key_size_);  // remember delete
+  template <size_t KeySize>
+  inline void SerializeFromKey(GenericKey<KeySize> *key_buf, const Row &key, Schema *schema) const {
+    ASSERT(key.GetFieldCount() == schema->GetColumnCount(), "field nums not match.");
+    ASSERT(GetNormalizedKeySize(schema) <= KeySize, "Index key size exceed max key size.");
+    // initialize to 0
+    memset(key_buf->data, 0, KeySize);
+    char *buf = key_buf->data;
+    for (uint32_t i = 0; i < key.GetFieldCount(); i++) {
+      const Column *column = schema->GetColumn(i);
+      const Field *field = key.GetField(i);
+      if (!field->IsNull()) {
+        buf[0] = 1;
+        EncodeField(*field, column, buf + 1);
+      }
+      buf += 1 + GetColumnKeySize(column);
+    }
   }
 
-  inline void SerializeFromKey(GenericKey *key_buf, const Row &key, Schema *schema) const {
-    // initialize to 0
-    [[maybe_unused]] uint32_t size = key.GetSerializedSize(schema);
-    ASSERT(key.GetFieldCount() == schema->GetColumnCount(), "field nums not match.");
-    ASSERT(size <= (uint32_t)key_size_, "Index key size exceed max key size.");
-    memset(key_buf->data, 0, key_size_);
-    key.SerializeTo(key_buf->data, schema);
+  template <size_t KeySize>
+  inline void DeserializeToKey(const GenericKey<KeySize> *key_buf, Row &key, Schema *schema) const {
+    ASSERT(key.GetFieldCount() == 0, "Non empty field in row.");
+    ASSERT(GetNormalizedKeySize(schema) <= KeySize, "Index key size exceed max key size.");
+    const char *buf = key_buf->data;
+    for (auto column : schema->GetColumns()) {
+      key.AddField(buf[0] == 0 ? Field(column->GetType()) : DecodeField(column, buf + 1));
+      buf += 1 + GetColumnKeySize(column);
+    }
   }
 
-  inline void DeserializeToKey(const GenericKey *key_buf, Row &key, Schema *schema) const {
-    [[maybe_unused]] uint32_t ofs = key.DeserializeFrom(const_cast<char *>(key_buf->data), schema);
-    ASSERT(ofs <= (uint32_t)key_size_, "Index key size exceed max key size.");
+  // compare, the length is a constant so that the compiler can inline the memcmp
+  template <size_t KeySize>
+  [[nodiscard]] inline int CompareKeys(const GenericKey<KeySize> *lhs, const GenericKey<KeySize> *rhs) const {
+    return memcmp(lhs->data, rhs->data, KeySize);
   }
 
-  // compare
-  [[nodiscard]] inline int CompareKeys(const GenericKey *lhs, const GenericKey *rhs) const {
-    //    ASSERT(malloc_usable_size((void *)&lhs) == malloc_usable_size((void *)&rhs), "key size not match.");
-    uint32_t column_count = key_schema_->GetColumnCount();
-    Row lhs_key(INVALID_ROWID);
-    Row rhs_key(INVALID_ROWID);
-    DeserializeToKey(lhs, lhs_key, key_schema_);
-    DeserializeToKey(rhs, rhs_key, key_schema_);
-
-    for (uint32_t i = 0; i < column_count; i++) {
-      Field *lhs_value = lhs_key.GetField(i);
-      Field *rhs_value = rhs_key.GetField(i);
-
-      if (lhs_value->CompareLessThan(*rhs_value) == CmpBool::kTrue) {
-        return -1;
-      }
+  /**
+   * @return bytes of the normalized keys of schema
+   */
+  static uint32_t GetNormalizedKeySize(const Schema *schema) {
+    uint32_t size = 0;
+    for (auto column : schema->GetColumns()) {
+      size += 1 + GetColumnKeySize(column);
+    }
+    return size;
+  }
 
-      if (lhs_value->CompareGreaterThan(*rhs_value) == CmpBool::kTrue) {
-        return 1;
-      }
+  KeyManager(const KeyManager &other) { this->key_schema_ = other.key_schema_; }
+
+  // constructor
+  explicit KeyManager(Schema *key_schema) : key_schema_(key_schema) {}
+
+ private:
+  /** bytes of the value of column in a key, without the null byte */
+  static inline uint32_t GetColumnKeySize(const Column *column) {
+    if (column->GetType() == kTypeChar) {
+      return column->GetLength() + sizeof(uint32_t);
     }
-    // equals
-    return 0;
+    return Type::GetTypeSize(column->GetType());
   }
 
-  inline int GetKeySize() const { return key_size_; }
+  static inline void WriteBigEndian(char *buf, uint32_t val) {
+    for (int i = 3; i >= 0; i--, val >>= 8) {
+      buf[i] = static_cast<char>(val & 0xff);
+    }
+  }
 
-  KeyManager(const KeyManager &other) {
-    this->key_schema_ = other.key_schema_;
-    this->key_size_ = other.key_size_;
+  static inline uint32_t ReadBigEndian(const char *buf) {
+    uint32_t val = 0;
+    for (int i = 0; i < 4; i++) {
+      val = val << 8 | static_cast<uint8_t>(buf[i]);
+    }
+    return val;
   }
 
-  // constructor
-  KeyManager(Schema *key_schema, size_t key_size) : key_size_(key_size), key_schema_(key_schema) {}
+  static inline void EncodeField(const Field &field, const Column *column, char *buf) {
+    switch (column->GetType()) {
+      case kTypeInt:
+        WriteBigEndian(buf, static_cast<uint32_t>(TypeKernel<kTypeInt>::GetValue(field)) ^ 0x80000000u);
+        break;
+      case kTypeFloat: {
+        // -0 is stored as 0, they are equal
+        float val = TypeKernel<kTypeFloat>::GetValue(field) + 0.0f;
+        uint32_t bits;
+        memcpy(&bits, &val, sizeof(bits));
+        WriteBigEndian(buf, (bits & 0x80000000u) ? ~bits : bits | 0x80000000u);
+        break;
+      }
+      case kTypeChar: {
+        // Chars longer than the column are never stored, InsertEntry rejects them. Such a lookup key is cut to the
+        // column length and keeps length + 1, so it sorts right after every stored key with the same chars and
+        // equals none of them.
+        std::string_view chars = TypeKernel<kTypeChar>::GetValue(field);
+        uint32_t len = std::min<size_t>(chars.size(), column->GetLength());
+        memcpy(buf, chars.data(), len);
+        WriteBigEndian(buf + column->GetLength(), std::min<size_t>(chars.size(), column->GetLength() + 1));
+        break;
+      }
+      default:
+        ASSERT(false, "Unknown field type.");
+    }
+  }
+
+  /** Chars are not copied, the field points into buf */
+  static inline Field DecodeField(const Column *column, const char *buf) {
+    switch (column->GetType()) {
+      case kTypeInt:
+        return Field(kTypeInt, static_cast<int32_t>(ReadBigEndian(buf) ^ 0x80000000u));
+      case kTypeFloat: {
+        uint32_t bits = ReadBigEndian(buf);
+        bits = (bits & 0x80000000u) ? bits & ~0x80000000u : ~bits;
+        float val;
+        memcpy(&val, &bits, sizeof(val));
+        return Field(kTypeFloat, val);
+      }
+      case kTypeChar:
+        return Field(kTypeChar, const_cast<char *>(buf), ReadBigEndian(buf + column->GetLength()), false);
+      default:
+        break;
+    }
+    throw "Unknown field type.";
+  }
 
- private:
-  int key_size_;
   Schema *key_schema_;
 };
 
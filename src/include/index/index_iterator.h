@@ -3,8 +3,9 @@
 
 #include "page/b_plus_tree_leaf_page.h"
 
+INDEX_TEMPLATE_ARGUMENTS
 class IndexIterator {
-  using LeafPage = BPlusTreeLeafPage;
+  using LeafPage = BPlusTreeLeafPage<KeySize>;
 
  public:
   // you may define your own constructor based on your member variables
@@ -15,7 +16,7 @@ class IndexIterator {
   ~IndexIterator();
 
   /** Return the key/value pair this iterator is currently pointing at. */
-  std::pair<GenericKey *, RowId> operator*();
+  std::pair<GenericKey<KeySize> *, RowId> operator*();
 
   /** Move to the next key/value pair.*/
   IndexIterator &operator++();
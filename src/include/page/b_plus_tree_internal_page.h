@@ -22,15 +22,17 @@
  * | HEADER | KEY(1)+PAGE_ID(1) | KEY(2)+PAGE_ID(2) | ... | KEY(n)+PAGE_ID(n) |
  *  --------------------------------------------------------------------------
  */
+INDEX_TEMPLATE_ARGUMENTS
 class BPlusTreeInternalPage : public BPlusTreePage {
+  using KeyType = GenericKey<KeySize>;
+
  public:
   // must call initialize method after "create" a new node
-  void Init(page_id_t page_id, page_id_t parent_id = INVALID_PAGE_ID, int key_size = UNDEFINED_SIZE,
-            int max_size = UNDEFINED_SIZE);
+  void Init(page_id_t page_id, page_id_t parent_id = INVALID_PAGE_ID, int max_size = UNDEFINED_SIZE);
 
-  GenericKey *KeyAt(int index);
+  KeyType *KeyAt(int index);
 
-  void SetKeyAt(int index, GenericKey *key);
+  void SetKeyAt(int index, KeyType *key);
 
   int ValueIndex(const page_id_t &value) const;
 
@@ -42,36 +44,35 @@ class BPlusTreeInternalPage : public BPlusTreePage {
 
   void PairCopy(void *dest, void *src, int pair_num = 1);
 
-  page_id_t Lookup(const GenericKey *key, const KeyManager &KP);
+  page_id_t Lookup(const KeyType *key, const KeyManager &KP);
 
-  void PopulateNewRoot(const page_id_t &old_value, GenericKey *new_key, const page_id_t &new_value);
+  void PopulateNewRoot(const page_id_t &old_value, KeyType *new_key, const page_id_t &new_value);
 
-  int InsertNodeAfter(const page_id_t &old_value, GenericKey *new_key, const page_id_t &new_value);
+  int InsertNodeAfter(const page_id_t &old_value, KeyType *new_key, const page_id_t &new_value);
 
   void Remove(int index);
 
   page_id_t RemoveAndReturnOnlyChild();
 
   // Split and Merge utility methods
-  void MoveAllTo(BPlusTreeInternalPage *recipient, GenericKey *middle_key, BufferPoolManager *buffer_pool_manager);
+  void MoveAllTo(BPlusTreeInternalPage *recipient, KeyType *middle_key, BufferPoolManager *buffer_pool_manager);
 
   void MoveHalfTo(BPlusTreeInternalPage *recipient, BufferPoolManager *buffer_pool_manager);
 
-  void MoveFirstToEndOf(BPlusTreeInternalPage *recipient, GenericKey *middle_key,
+  void MoveFirstToEndOf(BPlusTreeInternalPage *recipient, KeyType *middle_key,
                         BufferPoolManager *buffer_pool_manager);
 
-  void MoveLastToFrontOf(BPlusTreeInternalPage *recipient, GenericKey *middle_key,
+  void MoveLastToFrontOf(BPlusTreeInternalPage *recipient, KeyType *middle_key,
                          BufferPoolManager *buffer_pool_manager);
 
  private:
   void CopyNFrom(void *src, int size, BufferPoolManager *buffer_pool_manager);
 
-  void CopyLastFrom(GenericKey *key, page_id_t value, BufferPoolManager *buffer_pool_manager);
+  void CopyLastFrom(KeyType *key, page_id_t value, BufferPoolManager *buffer_pool_manager);
 
   void CopyFirstFrom(page_id_t value, BufferPoolManager *buffer_pool_manager);
 
   char data_[PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE];
 };
 
-using InternalPage = BPlusTreeInternalPage;
 #endif  // MINISQL_B_PLUS_TREE_INTERNAL_PAGE_H
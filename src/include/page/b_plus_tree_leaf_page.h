@@ -29,40 +29,42 @@
 
 #define LEAF_PAGE_HEADER_SIZE 32
 
+INDEX_TEMPLATE_ARGUMENTS
 class BPlusTreeLeafPage : public BPlusTreePage {
+  using KeyType = GenericKey<KeySize>;
+
  public:
   // After creating a new leaf page from buffer pool, must call initialize
   // method to set default values
-  void Init(page_id_t page_id, page_id_t parent_id = INVALID_PAGE_ID, int key_size = UNDEFINED_SIZE,
-            int max_size = UNDEFINED_SIZE);
+  void Init(page_id_t page_id, page_id_t parent_id = INVALID_PAGE_ID, int max_size = UNDEFINED_SIZE);
 
   // helper methods
   page_id_t GetNextPageId() const;
 
   void SetNextPageId(page_id_t next_page_id);
 
-  GenericKey *KeyAt(int index);
+  KeyType *KeyAt(int index);
 
-  void SetKeyAt(int index, GenericKey *key);
+  void SetKeyAt(int index, KeyType *key);
 
   RowId ValueAt(int index) const;
 
   void SetValueAt(int index, RowId value);
 
-  int KeyIndex(const GenericKey *key, const KeyManager &comparator);
+  int KeyIndex(const KeyType *key, const KeyManager &comparator);
 
   void *PairPtrAt(int index);
 
   void PairCopy(void *dest, void *src, int pair_num = 1);
 
-  std::pair<GenericKey *, RowId> GetItem(int index);
+  std::pair<KeyType *, RowId> GetItem(int index);
 
   // insert and delete methods
-  int Insert(GenericKey *key, const RowId &value, const KeyManager &comparator);
+  int Insert(KeyType *key, const RowId &value, const KeyManager &comparator);
 
-  bool Lookup(const GenericKey *key, RowId &value, const KeyManager &comparator);
+  bool Lookup(const KeyType *key, RowId &value, const KeyManager &comparator);
 
-  int RemoveAndDeleteRecord(const GenericKey *key, const KeyManager &comparator);
+  int RemoveAndDeleteRecord(const KeyType *key, const KeyManager &comparator);
 
   // Split and Merge utility methods
   void MoveHalfTo(BPlusTreeLeafPage *recipient);
@@ -76,14 +78,13 @@ class BPlusTreeLeafPage : public BPlusTreePage {
  private:
   void CopyNFrom(void *src, int size);
 
-  void CopyLastFrom(GenericKey *key, const RowId value);
+  void CopyLastFrom(KeyType *key, const RowId value);
 
-  void CopyFirstFrom(GenericKey *key, const RowId value);
+  void CopyFirstFrom(KeyType *key, const RowId value);
 
   page_id_t next_page_id_{INVALID_PAGE_ID};
 
   char data_[PAGE_SIZE - LEAF_PAGE_HEADER_SIZE];
 };
 
-using LeafPage = BPlusTreeLeafPage;
 #endif  // MINISQL_B_PLUS_TREE_LEAF_PAGE_H
@@ -12,6 +12,9 @@
 enum class IndexPageType { INVALID_INDEX_PAGE = 0, LEAF_PAGE, INTERNAL_PAGE };
 
 #define UNDEFINED_SIZE 0
+
+// B+ tree pages, the tree and its iterator are templates on the width of their keys, see GenericKey
+#define INDEX_TEMPLATE_ARGUMENTS template <size_t KeySize>
 /**
  * Both internal and leaf page are inherited from this page.
  *
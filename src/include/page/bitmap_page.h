@@ -20,6 +20,14 @@ class BitmapPage {
    */
   bool AllocatePage(uint32_t &page_offset);
 
+  /**
+   * Allocate the first run of n contiguous free pages, nothing is allocated if there is no such run.
+   *
+   * @param page_offsets Receives the n offsets in extent of the pages allocated, in increasing order.
+   * @return true if successfully allocate the pages.
+   */
+  bool AllocatePages(uint32_t n, uint32_t *page_offsets);
+
   /**
    * @return true if successfully de-allocate a page.
    */
@@ -40,6 +48,20 @@ class BitmapPage {
    */
   bool IsPageFreeLow(uint32_t byte_index, uint8_t bit_index) const;
 
+  /**
+   * Load 64 bits of the bitmap as a word whose most significant bit is the first of the 64 pages.
+   */
+  uint64_t LoadWord(uint32_t word_index) const;
+
+  /**
+   * Scan the bitmap a word at a time.
+   *
+   * @param from Offset of the first page to look at.
+   * @param free Whether to look for a free page or for an allocated one.
+   * @return the offset of the first page at or after from in that state, GetMaxSupportedSize() if none.
+   */
+  uint32_t FindFirst(uint32_t from, bool free) const;
+
   private:
   
   /**
@@ -61,10 +83,14 @@ class BitmapPage {
   /** Note: need to update if modify page structure. */
   static constexpr size_t MAX_CHARS = PageSize - 2 * sizeof(uint32_t);
 
+  static constexpr size_t NUM_WORDS = MAX_CHARS / sizeof(uint64_t);
+
+  static_assert(MAX_CHARS % sizeof(uint64_t) == 0, "bitmap must be made of whole words");
+
  private:
   /** The space occupied by all members of the class should be equal to the PageSize */
   [[maybe_unused]] uint32_t page_allocated_ = 0;
-  [[maybe_unused]] uint32_t next_free_page_ = 0;
+  [[maybe_unused]] uint32_t next_free_page_ = 0;  // no page before it is free
   [[maybe_unused]] unsigned char bytes[MAX_CHARS];
 };
 
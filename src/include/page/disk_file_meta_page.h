@@ -5,7 +5,44 @@
 
 #include "page/bitmap_page.h"
 
-static constexpr page_id_t MAX_VALID_PAGE_ID = (PAGE_SIZE - 8) / 4 * BitmapPage<PAGE_SIZE>::GetMaxSupportedSize();
+/** Number of extents whose used page counts fit in one meta page, between its header and its trailer. */
+static constexpr uint32_t EXTENTS_PER_META_PAGE = (PAGE_SIZE - 5 * sizeof(uint32_t)) / sizeof(uint32_t);
+
+/** Marks a first meta page that has a trailer, files of earlier builds have zeros there. */
+static constexpr uint32_t META_PAGE_MAGIC = 0x4d53514c;
+
+/**
+ * Version of the data in a database file, recorded in the trailer of its first meta page:
+ *  0: files of builds that did not record the page size. They have 4 KB pages and a single meta page without a
+ *     trailer, whose place holds the used page counts of the last extents of the group. DiskManager gives them a
+ *     trailer when they are opened, unless those extents are in use.
+ *  1: the trailer records the page size and the format version.
+ *
+ * Files of earlier builds are not all read unchanged:
+ *  - Table metadata without a free space map page id, and the table pages of such tables with a 24 byte header,
+ *    are converted when the catalog loads.
+ *  - Rows without a format version in their header are still read as version 0 rows.
+ *  - B+ tree indexes of builds that stored keys as serialized rows cannot be read, keys are now normalized and
+ *    sized by the columns of the index. Their metadata has an earlier magic, their trees are dropped when the
+ *    catalog loads and rebuilt from their tables once the table pages are converted.
+ */
+static constexpr uint32_t DISK_FORMAT_VERSION = 1;
+
+/** Physical pages of a group: a meta page and its extents. */
+static constexpr int64_t META_GROUP_PAGES =
+    1 + static_cast<int64_t>(EXTENTS_PER_META_PAGE) * (BitmapPage<PAGE_SIZE>::GetMaxSupportedSize() + 1);
+
+/**
+ * The db file is a chain of groups, each one a meta page followed by EXTENTS_PER_META_PAGE extents. With 4 KB pages a
+ * group covers about 128 GB and the limit is 16 groups, about 2 TB. Larger pages have fewer groups, so that physical
+ * page ids always fit in page_id_t.
+ */
+static constexpr uint32_t MAX_META_PAGES = INT32_MAX / META_GROUP_PAGES < 16 ? INT32_MAX / META_GROUP_PAGES : 16;
+
+static_assert(MAX_META_PAGES > 0, "a group of extents must be addressable with page_id_t");
+
+static constexpr page_id_t MAX_VALID_PAGE_ID =
+    MAX_META_PAGES * EXTENTS_PER_META_PAGE * BitmapPage<PAGE_SIZE>::GetMaxSupportedSize();
 
 class DiskFileMetaPage {
  public:
@@ -13,17 +50,34 @@ class DiskFileMetaPage {
 
   uint32_t GetAllocatedPages() { return num_allocated_pages_; }
 
+  uint32_t GetPageSize() { return page_size_; }
+
+  uint32_t GetFormatVersion() { return format_version_; }
+
+  /**
+   * @return whether the page has a trailer, false for the first meta page of a new file or of a file of an earlier
+   * build
+   */
+  bool HasTrailer() { return magic_ == META_PAGE_MAGIC; }
+
   uint32_t GetExtentUsedPage(uint32_t extent_id) {
-    if (extent_id >= num_extents_) {
+    if (extent_id >= EXTENTS_PER_META_PAGE) {
       return 0;
     }
     return extent_used_page_[extent_id];
   }
 
  public:
+  // totals of the whole file, only kept up to date in the first meta page
   uint32_t num_allocated_pages_{0};
   uint32_t num_extents_{0};  // each extent consists with a bit map and BIT_MAP_SIZE pages
-  uint32_t extent_used_page_[0];
+  uint32_t extent_used_page_[EXTENTS_PER_META_PAGE];  // used pages of the extents of this meta page's group
+  // trailer, only set in the first meta page
+  uint32_t format_version_{0};  // DISK_FORMAT_VERSION of the data in the file
+  uint32_t page_size_{0};       // PAGE_SIZE of the build that created the file
+  uint32_t magic_{0};           // META_PAGE_MAGIC once the trailer is set
 };
 
+static_assert(sizeof(DiskFileMetaPage) == PAGE_SIZE, "the trailer must end the meta page");
+
 #endif  // MINISQL_DISK_FILE_META_PAGE_H
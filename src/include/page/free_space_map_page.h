@@ -0,0 +1,78 @@
+#ifndef MINISQL_FREE_SPACE_MAP_PAGE_H
+#define MINISQL_FREE_SPACE_MAP_PAGE_H
+
+#include <algorithm>
+
+#include "common/config.h"
+
+/**
+ * Free space map of a table heap. FSM pages form a chain, the i-th entry of the chain records the i-th page of the
+ * table heap's page chain and a coarse estimate of its free space: a category is the free space in units of
+ * CATEGORY_BYTES, rounded down, so a page of a category always has at least that much room.
+ *
+ * Format (size in byte):
+ *  --------------------------------------------------------------------------------------------------
+ * | NextPageId (4) | Count (4) | PageId_1 (4) | ... | PageId_CAPACITY (4) | Category_1 (1) | ... |
+ *  --------------------------------------------------------------------------------------------------
+ */
+class FreeSpaceMapPage {
+ public:
+  static constexpr uint32_t CAPACITY = (PAGE_SIZE - 2 * sizeof(uint32_t)) / (sizeof(page_id_t) + sizeof(uint8_t));
+
+  static constexpr uint32_t CATEGORY_BYTES = PAGE_SIZE / 256;
+
+  void Init() {
+    next_page_id_ = INVALID_PAGE_ID;
+    count_ = 0;
+  }
+
+  inline page_id_t GetNextPageId() const { return next_page_id_; }
+
+  inline void SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+
+  inline uint32_t GetCount() const { return count_; }
+
+  inline bool IsFull() const { return count_ == CAPACITY; }
+
+  inline page_id_t GetPageId(uint32_t index) const { return page_ids_[index]; }
+
+  inline uint8_t GetCategory(uint32_t index) const { return GetCategories()[index]; }
+
+  inline void SetCategory(uint32_t index, uint8_t category) { GetCategories()[index] = category; }
+
+  /**
+   * Record one more page of the table heap.
+   * @return false if the page is full
+   */
+  bool Append(page_id_t page_id, uint8_t category) {
+    if (IsFull()) {
+      return false;
+    }
+    page_ids_[count_] = page_id;
+    GetCategories()[count_] = category;
+    count_++;
+    return true;
+  }
+
+  /**
+   * @return the category of a page with free_bytes free bytes
+   */
+  static inline uint8_t ToCategory(uint32_t free_bytes) { return std::min<uint32_t>(free_bytes / CATEGORY_BYTES, 255); }
+
+  /**
+   * @return the smallest category whose pages surely have bytes free bytes, more than 255 if no category is enough
+   */
+  static inline uint32_t MinCategory(uint32_t bytes) { return (bytes + CATEGORY_BYTES - 1) / CATEGORY_BYTES; }
+
+ private:
+  inline uint8_t *GetCategories() { return reinterpret_cast<uint8_t *>(page_ids_ + CAPACITY); }
+
+  inline const uint8_t *GetCategories() const { return reinterpret_cast<const uint8_t *>(page_ids_ + CAPACITY); }
+
+ private:
+  page_id_t next_page_id_;
+  uint32_t count_;
+  page_id_t page_ids_[0];
+};
+
+#endif  // MINISQL_FREE_SPACE_MAP_PAGE_H
@@ -12,9 +12,16 @@
  *  ----------------------------------------------------------------------------
  *  | PageId (4)| LSN (4)| PrevPageId (4)| NextPageId (4)| FreeSpacePointer(4) |
  *  ----------------------------------------------------------------------------
- *  ----------------------------------------------------------------
- *  | TupleCount (4) | Tuple_1 offset (4) | Tuple_1 size (4) | ... |
- *  ----------------------------------------------------------------
+ *  ----------------------------------------------------------------------------------------------------
+ *  | TupleCount (4) | FreeSlot (4) | DeadSpace (4) | Tuple_1 offset (4) | Tuple_1 size (4) | ... |
+ *  ----------------------------------------------------------------------------------------------------
+ *
+ *  Deleted tuples and the bytes a tuple shrinks by are dead space. It is only counted in DeadSpace and the tuples
+ *  are packed again when an insert or update needs the room. The slots of deleted tuples (size 0) form a list
+ *  starting at FreeSlot and linked through their offset fields, so an insert finds one without a scan.
+ *
+ *  Pages of tables created before FreeSlot and DeadSpace existed have a 24 byte header that ends with TupleCount,
+ *  their slot array starts right after it. ConvertEarlierFormat() gives them the layout above.
  **/
 
 #include <cstring>
@@ -25,6 +32,7 @@
 #include "concurrency/txn.h"
 #include "page/page.h"
 #include "record/row.h"
+#include "record/row_view.h"
 #include "recovery/log_manager.h"
 
 class TablePage : public Page {
@@ -65,10 +73,46 @@ class TablePage : public Page {
 
   bool GetTuple(Row *row, Schema *schema, Txn *txn, LockManager *lock_manager);
 
+  /**
+   * Point view at a tuple in place, nothing is copied. The view is only valid while the page stays pinned and the
+   * tuple is neither updated nor moved by a compaction.
+   */
+  bool GetTupleView(const RowId &rid, RowView *view, Schema *schema);
+
   bool GetFirstTupleRid(RowId *first_rid);
 
   bool GetNextTupleRid(const RowId &cur_rid, RowId *next_rid);
 
+  /**
+   * @return bytes an insert can use, dead space included, a new tuple takes its size plus SIZE_TUPLE of them
+   */
+  uint32_t GetFreeSpaceRemaining() { return GetContiguousFreeSpace() + GetDeadSpace(); }
+
+  /**
+   * ApplyDelete every tuple marked as deleted.
+   * @return the number of tuples deleted
+   */
+  uint32_t ApplyMarkedDeletes(Txn *txn, LogManager *log_manager);
+
+  /**
+   * @return true if no slot holds a tuple, not even one marked as deleted
+   */
+  bool IsEmpty();
+
+  /**
+   * Pack the tuples against the end of the page so that all dead space becomes contiguous free space.
+   */
+  void Compact();
+
+  /**
+   * Move the slot array of a page with the earlier 24 byte header behind the current header and link its free slots.
+   * Trailing free slots are dropped. If the page is still too full, the tuple of its last slot is taken out and its
+   * bytes become dead space, the caller has to insert it again.
+   * @param[out] row the tuple taken out, with the rid it had
+   * @return true if a tuple was taken out
+   */
+  bool ConvertEarlierFormat(Row *row, Schema *schema);
+
  private:
   uint32_t GetFreeSpacePointer() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_FREE_SPACE); }
 
@@ -83,7 +127,16 @@ class TablePage : public Page {
 
   void SetTupleCount(uint32_t tuple_count) { memcpy(GetData() + OFFSET_TUPLE_COUNT, &tuple_count, sizeof(uint32_t)); }
 
-  uint32_t GetFreeSpaceRemaining() {
+  uint32_t GetFreeSlot() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_FREE_SLOT); }
+
+  void SetFreeSlot(uint32_t slot_num) { memcpy(GetData() + OFFSET_FREE_SLOT, &slot_num, sizeof(uint32_t)); }
+
+  uint32_t GetDeadSpace() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_DEAD_SPACE); }
+
+  void SetDeadSpace(uint32_t dead_space) { memcpy(GetData() + OFFSET_DEAD_SPACE, &dead_space, sizeof(uint32_t)); }
+
+  /** @return bytes between the slot array and the tuples */
+  uint32_t GetContiguousFreeSpace() {
     return GetFreeSpacePointer() - SIZE_TABLE_PAGE_HEADER - SIZE_TUPLE * GetTupleCount();
   }
 
@@ -112,16 +165,20 @@ class TablePage : public Page {
  private:
   static_assert(sizeof(page_id_t) == 4);
   static constexpr uint64_t DELETE_MASK = (1U << (8 * sizeof(uint32_t) - 1));
-  static constexpr size_t SIZE_TABLE_PAGE_HEADER = 24;
-  static constexpr size_t SIZE_TUPLE = 8;
+  static constexpr size_t SIZE_TABLE_PAGE_HEADER = 32;
+  static constexpr size_t SIZE_EARLIER_TABLE_PAGE_HEADER = 24;
   static constexpr size_t OFFSET_PREV_PAGE_ID = 8;
   static constexpr size_t OFFSET_NEXT_PAGE_ID = 12;
   static constexpr size_t OFFSET_FREE_SPACE = 16;
   static constexpr size_t OFFSET_TUPLE_COUNT = 20;
-  static constexpr size_t OFFSET_TUPLE_OFFSET = 24;
-  static constexpr size_t OFFSET_TUPLE_SIZE = 28;
+  static constexpr size_t OFFSET_FREE_SLOT = 24;
+  static constexpr size_t OFFSET_DEAD_SPACE = 28;
+  static constexpr size_t OFFSET_TUPLE_OFFSET = 32;
+  static constexpr size_t OFFSET_TUPLE_SIZE = 36;
+  static constexpr uint32_t INVALID_SLOT = UINT32_MAX;
 
  public:
+  static constexpr size_t SIZE_TUPLE = 8;
   static constexpr size_t SIZE_MAX_ROW = PAGE_SIZE - SIZE_TABLE_PAGE_HEADER - SIZE_TUPLE;
 };
 
@@ -18,7 +18,13 @@ class ComparisonExpression : public AbstractExpression {
   /** Creates a new comparison expression representing (left comp_type right). */
   ComparisonExpression(AbstractExpressionRef left, AbstractExpressionRef right, string comp_type)
       : AbstractExpression({std::move(left), std::move(right)}, TypeId::kTypeInt, ExpressionType::ComparisonExpression),
-        comp_type_{std::move(comp_type)} {}
+        comp_type_{std::move(comp_type)} {
+    // pick the kernel once instead of for every row, is and not only look at the left side
+    CmpOp op;
+    if (Char2Op(comp_type_, &op)) {
+      comparator_ = GetFieldComparator(GetChildAt(0)->GetReturnType(), op);
+    }
+  }
 
   /** e.g. evaluate the result of id = 1 */
   Field Evaluate(const Row *row) const override {
@@ -27,6 +33,12 @@ class ComparisonExpression : public AbstractExpression {
     return Field(kTypeInt, PerformComparison(lhs, rhs));
   }
 
+  Field Evaluate(const RowView *row) const override {
+    Field lhs = GetChildAt(0)->Evaluate(row);
+    Field rhs = GetChildAt(1)->Evaluate(row);
+    return Field(kTypeInt, PerformComparison(lhs, rhs));
+  }
+
   Field EvaluateJoin(const Row *left_row, const Row *right_row) const override {
     Field lhs = GetChildAt(0)->EvaluateJoin(left_row, right_row);
     Field rhs = GetChildAt(1)->EvaluateJoin(left_row, right_row);
@@ -36,19 +48,27 @@ class ComparisonExpression : public AbstractExpression {
   std::string GetComparisonType() { return comp_type_; }
 
  private:
+  static bool Char2Op(const std::string &comp_type, CmpOp *op) {
+    if (comp_type == "=")
+      *op = CmpOp::kEquals;
+    else if (comp_type == "<>")
+      *op = CmpOp::kNotEquals;
+    else if (comp_type == "<")
+      *op = CmpOp::kLessThan;
+    else if (comp_type == "<=")
+      *op = CmpOp::kLessThanEquals;
+    else if (comp_type == ">")
+      *op = CmpOp::kGreaterThan;
+    else if (comp_type == ">=")
+      *op = CmpOp::kGreaterThanEquals;
+    else
+      return false;
+    return true;
+  }
+
   CmpBool PerformComparison(const Field &lhs, const Field &rhs) const {
-    if (comp_type_ == "=")
-      return lhs.CompareEquals(rhs);
-    else if (comp_type_ == "<>")
-      return lhs.CompareNotEquals(rhs);
-    else if (comp_type_ == "<")
-      return lhs.CompareLessThan(rhs);
-    else if (comp_type_ == "<=")
-      return lhs.CompareLessThanEquals(rhs);
-    else if (comp_type_ == ">")
-      return lhs.CompareGreaterThan(rhs);
-    else if (comp_type_ == ">=")
-      return lhs.CompareGreaterThanEquals(rhs);
+    if (comparator_ != nullptr)
+      return comparator_(lhs, rhs);
     else if (comp_type_ == "is")
       return GetCmpBool(lhs.IsNull());
     else if (comp_type_ == "not")
@@ -58,6 +78,7 @@ class ComparisonExpression : public AbstractExpression {
   }
 
   std::string comp_type_;
+  FieldComparator comparator_{nullptr};
 };
 
 #endif  // MINISQL_COMPARISON_EXPRESSION_H
@@ -31,6 +31,12 @@ class LogicExpression : public AbstractExpression {
     return Field(kTypeInt, PerformComputation(lhs, rhs));
   }
 
+  Field Evaluate(const RowView *row) const override {
+    Field lhs = GetChildAt(0)->Evaluate(row);
+    Field rhs = GetChildAt(1)->Evaluate(row);
+    return Field(kTypeInt, PerformComputation(lhs, rhs));
+  }
+
   Field EvaluateJoin(const Row *left_row, const Row *right_row) const override {
     Field lhs = GetChildAt(0)->EvaluateJoin(left_row, right_row);
     Field rhs = GetChildAt(1)->EvaluateJoin(left_row, right_row);
@@ -53,7 +59,7 @@ class LogicExpression : public AbstractExpression {
     if (val.IsNull()) {
       return CmpBool::kNull;
     }
-    if (val.CompareEquals(Field(kTypeInt, 1))) {
+    if (CompareFields<kTypeInt, CmpOp::kEquals>(val, Field(kTypeInt, 1)) == CmpBool::kTrue) {
       return CmpBool::kTrue;
     }
     return CmpBool::kFalse;
@@ -3,6 +3,7 @@
 
 #include <cstring>
 #include <string>
+#include <string_view>
 
 #include "common/config.h"
 #include "common/macros.h"
@@ -18,11 +19,14 @@ class Field {
 
   friend class TypeFloat;
 
+  template <TypeId type>
+  friend struct TypeKernel;
+
  public:
   explicit Field(const TypeId type) : type_id_(type), len_(FIELD_NULL_LEN), is_null_(true) {}
 
   ~Field() {
-    if (type_id_ == TypeId::kTypeChar && manage_data_) {
+    if (type_id_ == TypeId::kTypeChar && manage_data_ && !IsInline()) {
       delete[] value_.chars_;
     }
   }
@@ -52,8 +56,11 @@ class Field {
     } else {
       if (manage_data) {
         ASSERT(len < VARCHAR_MAX_LEN, "Field length exceeds max varchar length");
-        value_.chars_ = new char[len];
-        memcpy(value_.chars_, data, len);
+        // short chars are kept inside the field
+        if (len > FIELD_INLINE_LEN) {
+          value_.chars_ = new char[len];
+        }
+        memcpy(len > FIELD_INLINE_LEN ? value_.chars_ : value_.inline_, data, len);
       } else {
         value_.chars_ = data;
       }
@@ -67,7 +74,7 @@ class Field {
     len_ = other.len_;
     is_null_ = other.is_null_;
     manage_data_ = other.manage_data_;
-    if (type_id_ == TypeId::kTypeChar && !is_null_ && manage_data_) {
+    if (type_id_ == TypeId::kTypeChar && !is_null_ && manage_data_ && !IsInline()) {
       value_.chars_ = new char[len_];
       memcpy(value_.chars_, other.value_.chars_, len_);
     } else {
@@ -75,51 +82,61 @@ class Field {
     }
   }
 
+  // move constructor, other is left a null field
+  Field(Field &&other) noexcept
+      : value_(other.value_),
+        type_id_(other.type_id_),
+        len_(other.len_),
+        is_null_(other.is_null_),
+        manage_data_(other.manage_data_) {
+    other.manage_data_ = false;
+    other.is_null_ = true;
+  }
+
   // copy
-  Field &operator=(Field &other) {
+  Field &operator=(const Field &other) {
+    if (this != &other) {
+      Field copy(other);
+      Swap(*this, copy);
+    }
+    return *this;
+  }
+
+  // move, other gets the value of this field
+  Field &operator=(Field &&other) noexcept {
     Swap(*this, other);
     return *this;
   }
 
   inline bool IsNull() const { return is_null_; }
 
-  inline uint32_t GetLength() const { return Type::GetInstance(type_id_)->GetLength(*this); }
+  inline uint32_t GetLength() const;
 
   inline TypeId GetTypeId() const { return type_id_; }
 
-  inline const char *GetData() const { return Type::GetInstance(type_id_)->GetData(*this); }
+  inline const char *GetData() const;
 
-  inline uint32_t SerializeTo(char *buf) const { return Type::GetInstance(type_id_)->SerializeTo(*this, buf); }
+  inline uint32_t SerializeTo(char *buf) const;
 
   inline static uint32_t DeserializeFrom(char *buf, const TypeId type_id, Field **field, bool is_null) {
     return Type::GetInstance(type_id)->DeserializeFrom(buf, field, is_null);
   }
 
-  inline uint32_t GetSerializedSize() const { return Type::GetInstance(type_id_)->GetSerializedSize(*this, is_null_); }
+  inline uint32_t GetSerializedSize() const;
 
   inline bool CheckComparable(const Field &o) const { return type_id_ == o.type_id_; }
 
-  inline CmpBool CompareEquals(const Field &o) const { return Type::GetInstance(type_id_)->CompareEquals(*this, o); }
+  inline CmpBool CompareEquals(const Field &o) const { return Compare<CmpOp::kEquals>(o); }
 
-  inline CmpBool CompareNotEquals(const Field &o) const {
-    return Type::GetInstance(type_id_)->CompareNotEquals(*this, o);
-  }
+  inline CmpBool CompareNotEquals(const Field &o) const { return Compare<CmpOp::kNotEquals>(o); }
 
-  inline CmpBool CompareLessThan(const Field &o) const {
-    return Type::GetInstance(type_id_)->CompareLessThan(*this, o);
-  }
+  inline CmpBool CompareLessThan(const Field &o) const { return Compare<CmpOp::kLessThan>(o); }
 
-  inline CmpBool CompareLessThanEquals(const Field &o) const {
-    return Type::GetInstance(type_id_)->CompareLessThanEquals(*this, o);
-  }
+  inline CmpBool CompareLessThanEquals(const Field &o) const { return Compare<CmpOp::kLessThanEquals>(o); }
 
-  inline CmpBool CompareGreaterThan(const Field &o) const {
-    return Type::GetInstance(type_id_)->CompareGreaterThan(*this, o);
-  }
+  inline CmpBool CompareGreaterThan(const Field &o) const { return Compare<CmpOp::kGreaterThan>(o); }
 
-  inline CmpBool CompareGreaterThanEquals(const Field &o) const {
-    return Type::GetInstance(type_id_)->CompareGreaterThanEquals(*this, o);
-  }
+  inline CmpBool CompareGreaterThanEquals(const Field &o) const { return Compare<CmpOp::kGreaterThanEquals>(o); }
 
   friend void Swap(Field &first, Field &second) {
     std::swap(first.value_, second.value_);
@@ -137,18 +154,23 @@ class Field {
     else if (type_id_ == kTypeFloat)
       return std::to_string(value_.float_);
     else {
-      char temp[len_ + 1];
-      memcpy(temp, value_.chars_, len_);
-      temp[len_] = '\0';
-      return {temp};
+      return {GetData(), len_};
     }
   }
 
  protected:
+  /** Compare with the kernel of the type of this field, see CompareFields */
+  template <CmpOp op>
+  inline CmpBool Compare(const Field &o) const;
+
+  /** @return true if the chars are stored in value_.inline_ */
+  inline bool IsInline() const { return manage_data_ && len_ <= FIELD_INLINE_LEN; }
+
   union Val {
     int32_t integer_;
     float float_;
     char *chars_;
+    char inline_[FIELD_INLINE_LEN];
   } value_;
   TypeId type_id_;
   uint32_t len_;
@@ -156,4 +178,170 @@ class Field {
   bool manage_data_{false};
 };
 
+/**
+ * Operations on the value of a non-null field, specialized for each type. Field dispatches to them with a switch on
+ * its type for every call, code that handles many fields of the same column picks the kernel once instead, see
+ * GetFieldComparator and GetFieldOrder.
+ */
+template <TypeId type>
+struct TypeKernel;
+
+template <>
+struct TypeKernel<kTypeInt> {
+  static inline int32_t GetValue(const Field &field) { return field.value_.integer_; }
+
+  static inline uint32_t SerializeTo(const Field &field, char *buf) {
+    MACH_WRITE_TO(int32_t, buf, field.value_.integer_);
+    return sizeof(int32_t);
+  }
+
+  static inline uint32_t GetSerializedSize(const Field &) { return sizeof(int32_t); }
+};
+
+template <>
+struct TypeKernel<kTypeFloat> {
+  static inline float GetValue(const Field &field) { return field.value_.float_; }
+
+  static inline uint32_t SerializeTo(const Field &field, char *buf) {
+    MACH_WRITE_TO(float, buf, field.value_.float_);
+    return sizeof(float);
+  }
+
+  static inline uint32_t GetSerializedSize(const Field &) { return sizeof(float); }
+};
+
+template <>
+struct TypeKernel<kTypeChar> {
+  /** chars compare like memcmp, a prefix is less than the longer string */
+  static inline std::string_view GetValue(const Field &field) { return {GetData(field), field.len_}; }
+
+  static inline const char *GetData(const Field &field) {
+    return field.IsInline() ? field.value_.inline_ : field.value_.chars_;
+  }
+
+  static inline uint32_t SerializeTo(const Field &field, char *buf) {
+    MACH_WRITE_UINT32(buf, field.len_);
+    memcpy(buf + sizeof(uint32_t), GetData(field), field.len_);
+    return sizeof(uint32_t) + field.len_;
+  }
+
+  static inline uint32_t GetSerializedSize(const Field &field) { return sizeof(uint32_t) + field.len_; }
+};
+
+/**
+ * Compare two fields of the given type, kNull if either of them is null.
+ */
+template <TypeId type, CmpOp op>
+inline CmpBool CompareFields(const Field &left, const Field &right) {
+  ASSERT(left.CheckComparable(right), "Not comparable.");
+  if (left.IsNull() || right.IsNull()) {
+    return CmpBool::kNull;
+  }
+  auto lhs = TypeKernel<type>::GetValue(left);
+  auto rhs = TypeKernel<type>::GetValue(right);
+  if constexpr (op == CmpOp::kEquals) {
+    return GetCmpBool(lhs == rhs);
+  } else if constexpr (op == CmpOp::kNotEquals) {
+    return GetCmpBool(lhs != rhs);
+  } else if constexpr (op == CmpOp::kLessThan) {
+    return GetCmpBool(lhs < rhs);
+  } else if constexpr (op == CmpOp::kLessThanEquals) {
+    return GetCmpBool(lhs <= rhs);
+  } else if constexpr (op == CmpOp::kGreaterThan) {
+    return GetCmpBool(lhs > rhs);
+  } else {
+    return GetCmpBool(lhs >= rhs);
+  }
+}
+
+/**
+ * Order two fields of the given type, nulls are equal to everything.
+ * @return -1, 0 or 1 if left is less than, equal to or greater than right
+ */
+template <TypeId type>
+inline int CompareFieldOrder(const Field &left, const Field &right) {
+  ASSERT(left.CheckComparable(right), "Not comparable.");
+  if (left.IsNull() || right.IsNull()) {
+    return 0;
+  }
+  auto lhs = TypeKernel<type>::GetValue(left);
+  auto rhs = TypeKernel<type>::GetValue(right);
+  return lhs < rhs ? -1 : (rhs < lhs ? 1 : 0);
+}
+
+using FieldComparator = CmpBool (*)(const Field &, const Field &);
+
+using FieldOrder = int (*)(const Field &, const Field &);
+
+/**
+ * @return the kernel comparing fields of type with op
+ */
+FieldComparator GetFieldComparator(TypeId type, CmpOp op);
+
+/**
+ * @return the kernel ordering fields of type
+ */
+FieldOrder GetFieldOrder(TypeId type);
+
+inline uint32_t Field::GetLength() const {
+  if (type_id_ == kTypeChar) {
+    return len_;
+  }
+  return Type::GetInstance(type_id_)->GetLength(*this);
+}
+
+inline const char *Field::GetData() const {
+  if (type_id_ == kTypeChar) {
+    return TypeKernel<kTypeChar>::GetData(*this);
+  }
+  return Type::GetInstance(type_id_)->GetData(*this);
+}
+
+inline uint32_t Field::SerializeTo(char *buf) const {
+  if (is_null_) {
+    return 0;
+  }
+  switch (type_id_) {
+    case kTypeInt:
+      return TypeKernel<kTypeInt>::SerializeTo(*this, buf);
+    case kTypeFloat:
+      return TypeKernel<kTypeFloat>::SerializeTo(*this, buf);
+    case kTypeChar:
+      return TypeKernel<kTypeChar>::SerializeTo(*this, buf);
+    default:
+      return Type::GetInstance(type_id_)->SerializeTo(*this, buf);
+  }
+}
+
+inline uint32_t Field::GetSerializedSize() const {
+  if (is_null_) {
+    return 0;
+  }
+  switch (type_id_) {
+    case kTypeInt:
+      return TypeKernel<kTypeInt>::GetSerializedSize(*this);
+    case kTypeFloat:
+      return TypeKernel<kTypeFloat>::GetSerializedSize(*this);
+    case kTypeChar:
+      return TypeKernel<kTypeChar>::GetSerializedSize(*this);
+    default:
+      return Type::GetInstance(type_id_)->GetSerializedSize(*this, is_null_);
+  }
+}
+
+template <CmpOp op>
+inline CmpBool Field::Compare(const Field &o) const {
+  switch (type_id_) {
+    case kTypeInt:
+      return CompareFields<kTypeInt, op>(*this, o);
+    case kTypeFloat:
+      return CompareFields<kTypeFloat, op>(*this, o);
+    case kTypeChar:
+      return CompareFields<kTypeChar, op>(*this, o);
+    default:
+      ASSERT(false, "Compare not implemented.");
+      return CmpBool::kNull;
+  }
+}
+
 #endif  // MINISQL_FIELD_H
@@ -2,24 +2,32 @@
 #define MINISQL_ROW_H
 
 #include <memory>
+#include <memory_resource>
 #include <vector>
 
+#include "common/arena.h"
 #include "common/macros.h"
 #include "common/rowid.h"
 #include "record/field.h"
 #include "record/schema.h"
 
 /**
- *  Row format:
- * -------------------------------------------
- * | Header | Field-1 | ... | Field-N |
- * -------------------------------------------
- *  Header format:
- * --------------------------------------------
- * | Field Nums | Null bitmap |
- * -------------------------------------------
- *
+ *  Row format (version 1):
+ * ---------------------------------------------------------------------------------------------
+ * | Header (4) | Null bitmap | Fixed-width fields | Varchar end offsets (4 each) | Varchar data |
+ * ---------------------------------------------------------------------------------------------
+ *  The header holds the format version in its high byte and the field count below. Bit i % 8 of byte i / 8 of the
+ *  null bitmap is set if field i is null. Every int and float field has its bytes at the same offset in each row of a
+ *  schema, null ones are zero. A char field ends at its entry of the offset array, counted from the start of the row,
+ *  and begins where the char field before it ends, so any field is found without reading the others. Null char
+ *  fields are empty. Schema::GetColumnSlot gives the place of a field in the fixed-width part or the offset array.
  *
+ *  Version 0 rows, written by earlier releases, are still read:
+ * -------------------------------------------------------------------
+ * | Field Nums (4) | Null bitmap (4) | Field-1 | ... | Field-N |
+ * -------------------------------------------------------------------
+ *  There bit N - 1 - i of the null bitmap marks field i as null, null fields take no bytes and a char field is its
+ *  length (4) followed by the chars.
  */
 class Row {
  public:
@@ -29,21 +37,25 @@ class Row {
    */
   Row(std::vector<Field> &fields) {
     // deep copy
+    fields_.reserve(fields.size());
     for (auto &field : fields) {
-      fields_.push_back(new Field(field));
+      fields_.emplace_back(field);
     }
   }
 
-  void destroy() {
-    if (!fields_.empty()) {
-      for (auto field : fields_) {
-        delete field;
-      }
-      fields_.clear();
+  /**
+   * Row used for insert, takes the fields over
+   */
+  Row(std::vector<Field> &&fields) {
+    fields_.reserve(fields.size());
+    for (auto &field : fields) {
+      fields_.emplace_back(std::move(field));
     }
   }
 
-  ~Row() { destroy(); };
+  void destroy() { fields_.clear(); }
+
+  ~Row() = default;
 
   /**
    * Row used for deserialize
@@ -55,61 +67,120 @@ class Row {
    */
   Row(RowId rid) : rid_(rid) {}
 
+  /**
+   * Row whose field array and the chars of its fields that do not fit into a Field are allocated in arena, the row
+   * must not outlive it. Copies of the row are in the same arena.
+   */
+  explicit Row(Arena *arena) : fields_(arena), arena_(arena) {}
+
   /**
    * Row copy function, deep copy
    */
-  Row(const Row &other) {
-    destroy();
-    rid_ = other.rid_;
+  Row(const Row &other)
+      : rid_(other.rid_),
+        fields_(other.arena_ == nullptr ? std::pmr::get_default_resource() : other.arena_),
+        arena_(other.arena_) {
+    fields_.reserve(other.fields_.size());
     for (auto &field : other.fields_) {
-      fields_.push_back(new Field(*field));
+      AppendField(field, false);
     }
   }
 
   /**
-   * Assign operator, deep copy
+   * Row move function, the fields are taken over, other is left empty
+   */
+  Row(Row &&other) noexcept : rid_(other.rid_), fields_(std::move(other.fields_)), arena_(other.arena_) {}
+
+  /**
+   * Assign operator, deep copy into the storage of this row
    */
   Row &operator=(const Row &other) {
+    if (this == &other) {
+      return *this;
+    }
     destroy();
     rid_ = other.rid_;
+    fields_.reserve(other.fields_.size());
     for (auto &field : other.fields_) {
-      fields_.push_back(new Field(*field));
+      AppendField(field, other.arena_ != arena_);
     }
     return *this;
   }
 
+  /**
+   * Move assign operator, the fields are only taken over if both rows are in the same storage, else they are copied
+   */
+  Row &operator=(Row &&other) noexcept {
+    if (arena_ != other.arena_) {
+      return *this = other;
+    }
+    rid_ = other.rid_;
+    fields_ = std::move(other.fields_);
+    return *this;
+  }
+
+  /**
+   * Append a copy of field, its chars are copied too.
+   */
+  inline void AddField(const Field &field) { AppendField(field, true); }
+
   /**
    * Note: Make sure that bytes write to buf is equal to GetSerializedSize()
    */
   uint32_t SerializeTo(char *buf, Schema *schema) const;
 
+  /**
+   * Read a row of either format version.
+   */
   uint32_t DeserializeFrom(char *buf, Schema *schema);
 
   /**
-   * For empty row, return 0
-   * For non-empty row with null fields, eg: |null|null|null|, return header size only
-   * @return
+   * @return bytes SerializeTo writes, null fields still take their fixed-width bytes or varchar offset
    */
   uint32_t GetSerializedSize(Schema *schema) const;
 
   void GetKeyFromRow(const Schema *schema, const Schema *key_schema, Row &key_row);
 
+  /**
+   * @return index of the first char field with more chars than its column holds, or the field count if none
+   */
+  uint32_t FindTooLongField(const Schema *schema) const;
+
+  static constexpr uint32_t FORMAT_VERSION = 1;
+
+  static inline uint32_t GetFormatVersion(const char *buf) { return MACH_READ_UINT32(buf) >> 24; }
+
+  static inline uint32_t GetFieldCount(const char *buf) { return MACH_READ_UINT32(buf) & 0xffffff; }
+
+  /** @return bytes before the fixed-width fields of a version 1 row */
+  static inline uint32_t GetHeaderSize(uint32_t field_count) { return sizeof(uint32_t) + (field_count + 7) / 8; }
+
   inline const RowId GetRowId() const { return rid_; }
 
   inline void SetRowId(RowId rid) { rid_ = rid; }
 
-  inline std::vector<Field *> &GetFields() { return fields_; }
+  inline std::pmr::vector<Field> &GetFields() { return fields_; }
 
   inline Field *GetField(uint32_t idx) const {
     ASSERT(idx < fields_.size(), "Failed to access field");
-    return fields_[idx];
+    return const_cast<Field *>(&fields_[idx]);
   }
 
   inline size_t GetFieldCount() const { return fields_.size(); }
 
+  /** @return nullptr if the row is on the heap */
+  inline Arena *GetArena() const { return arena_; }
+
  private:
+  /**
+   * Append a copy of field in the storage of this row. Chars of the copy are only copied if copy_chars is set, or
+   * else they stay with the storage field is from.
+   */
+  void AppendField(const Field &field, bool copy_chars);
+
   RowId rid_{};
-  std::vector<Field *> fields_; /** Make sure that all field ptr are destructed*/
+  std::pmr::vector<Field> fields_; /** stored inline, short chars included */
+  Arena *arena_{nullptr};
 };
 
 #endif  // MINISQL_ROW_H
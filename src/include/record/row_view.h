@@ -0,0 +1,74 @@
+#ifndef MINISQL_ROW_VIEW_H
+#define MINISQL_ROW_VIEW_H
+
+#include <vector>
+
+#include "common/rowid.h"
+#include "record/field.h"
+#include "record/row.h"
+#include "record/schema.h"
+
+/**
+ * Read-only view of a serialized row, see Row for the formats. GetField returns a field that points into the viewed
+ * bytes instead of a copy, so reading a view does not allocate. Fields of version 1 rows are found in constant time.
+ * Version 0 rows are walked field by field the first time a field is read, the offsets found on the way are kept
+ * for later reads of the same row.
+ *
+ * The view does not own the bytes: they, and every field taken from the view, must not outlive the buffer. Views of
+ * tuples in a table page are only valid while the page stays pinned, see PageGuard.
+ */
+class RowView {
+ public:
+  RowView() = default;
+
+  RowView(const char *data, Schema *schema, RowId rid = INVALID_ROWID) { Reset(data, schema, rid); }
+
+  /**
+   * Point the view at another serialized row.
+   */
+  void Reset(const char *data, Schema *schema, RowId rid = INVALID_ROWID);
+
+  inline RowId GetRowId() const { return rid_; }
+
+  inline uint32_t GetFieldCount() const { return field_count_; }
+
+  inline bool IsNull(uint32_t idx) const {
+    ASSERT(idx < field_count_, "Failed to access field");
+    if (version_ == 0) {
+      return MACH_READ_UINT32(data_ + sizeof(uint32_t)) & (1u << (field_count_ - 1 - idx));
+    }
+    return data_[sizeof(uint32_t) + idx / 8] & (1 << (idx % 8));
+  }
+
+  /**
+   * @return the idx-th field, chars are not copied
+   */
+  Field GetField(uint32_t idx) const;
+
+  /**
+   * @return bytes of the viewed row
+   */
+  uint32_t GetSerializedSize() const;
+
+  /**
+   * Deserialize the whole row into row, which owns its fields afterwards.
+   */
+  void ToRow(Row *row) const;
+
+ private:
+  /**
+   * @return offset of the idx-th field of a version 0 row, walks the fields not located yet
+   */
+  uint32_t GetFieldOffsetV0(uint32_t idx) const;
+
+  const char *data_{nullptr};
+  Schema *schema_{nullptr};
+  RowId rid_{};
+  uint32_t version_{0};
+  uint32_t field_count_{0};
+  uint32_t fixed_begin_{0};                // version 1: offset of the fixed-width fields
+  uint32_t varchar_begin_{0};              // version 1: offset of the varchar offset array
+  mutable std::vector<uint32_t> offsets_;  // version 0: offsets of the fields located so far
+};
+
+#endif  // MINISQL_ROW_VIEW_H
@@ -13,7 +13,17 @@
 class Schema {
  public:
   explicit Schema(const std::vector<Column *> columns, bool is_manage_ = true)
-      : columns_(std::move(columns)), is_manage_(is_manage_) {}
+      : columns_(std::move(columns)), is_manage_(is_manage_) {
+    column_slots_.reserve(columns_.size());
+    for (auto column : columns_) {
+      if (column->GetType() == TypeId::kTypeChar) {
+        column_slots_.push_back(varchar_count_++);
+      } else {
+        column_slots_.push_back(fixed_size_);
+        fixed_size_ += Type::GetTypeSize(column->GetType());
+      }
+    }
+  }
 
   ~Schema() {
     if (is_manage_) {
@@ -39,6 +49,17 @@ class Schema {
 
   inline uint32_t GetColumnCount() const { return static_cast<uint32_t>(columns_.size()); }
 
+  /**
+   * Place of a column in a serialized row, see Row: the offset of a fixed-width column in the fixed-width part, the
+   * index of a char column in the varchar offset array.
+   */
+  inline uint32_t GetColumnSlot(const uint32_t column_index) const { return column_slots_[column_index]; }
+
+  /** @return bytes of the fixed-width part of a serialized row */
+  inline uint32_t GetFixedSize() const { return fixed_size_; }
+
+  inline uint32_t GetVarcharCount() const { return varchar_count_; }
+
   /**
    * Shallow copy schema, only used in index
    *
@@ -84,6 +105,9 @@ class Schema {
   static constexpr uint32_t SCHEMA_MAGIC_NUM = 200715;
   std::vector<Column *> columns_;
   bool is_manage_ = false; /** if false, don't need to delete pointer to column */
+  std::vector<uint32_t> column_slots_;
+  uint32_t fixed_size_{0};
+  uint32_t varchar_count_{0};
 };
 
 using IndexSchema = Schema;
@@ -12,6 +12,8 @@ class Field;
 
 enum CmpBool { kFalse = 0, kTrue, kNull };
 
+enum class CmpOp { kEquals, kNotEquals, kLessThan, kLessThanEquals, kGreaterThan, kGreaterThanEquals };
+
 inline CmpBool GetCmpBool(bool boolean) {
   return boolean ? CmpBool::kTrue : CmpBool::kFalse;
 }
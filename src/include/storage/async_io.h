@@ -0,0 +1,139 @@
+#ifndef MINISQL_ASYNC_IO_H
+#define MINISQL_ASYNC_IO_H
+
+#include <sys/types.h>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#define MINISQL_HAVE_IO_URING
+#endif
+
+/**
+ * One positional read or write of an AsyncIO backend. The buffer must stay valid until the callback ran.
+ */
+struct AsyncIORequest {
+  bool is_write_{false};
+  off_t offset_{0};
+  char *buf_{nullptr};
+  size_t len_{0};
+  /** Called on a completion thread with the number of bytes transferred, or -errno. */
+  std::function<void(ssize_t)> callback_;
+};
+
+/**
+ * AsyncIO submits positional reads and writes on one file descriptor and reports their completion through callbacks.
+ * Create() picks io_uring when the kernel supports it and a pool of threads doing pread/pwrite otherwise.
+ */
+class AsyncIO {
+ public:
+  enum Backend { kIoUring = 0, kThreadPool };
+
+  /**
+   * @param backend kThreadPool forces the fallback
+   */
+  static std::unique_ptr<AsyncIO> Create(int fd, Backend backend = kIoUring);
+
+  virtual ~AsyncIO() = default;
+
+  /**
+   * Submit a batch of requests at once, blocks only while the queue is full. Every request completes through its
+   * callback, with a negative errno if it could not be submitted.
+   */
+  virtual void Submit(std::vector<AsyncIORequest> &requests) = 0;
+
+  virtual Backend GetBackend() const = 0;
+};
+
+/**
+ * Fallback backend, worker threads run blocking pread/pwrite.
+ */
+class ThreadPoolAsyncIO : public AsyncIO {
+ public:
+  ThreadPoolAsyncIO(int fd, size_t num_threads);
+
+  ~ThreadPoolAsyncIO() override;
+
+  DISALLOW_COPY(ThreadPoolAsyncIO)
+
+  void Submit(std::vector<AsyncIORequest> &requests) override;
+
+  Backend GetBackend() const override { return kThreadPool; }
+
+ private:
+  void Run();
+
+  int fd_;
+  std::vector<std::thread> workers_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<AsyncIORequest> queue_;
+  bool stop_{false};
+};
+
+#ifdef MINISQL_HAVE_IO_URING
+/**
+ * io_uring backend driven through the raw system calls, so that liburing is not required. Submit() fills the
+ * submission ring under a mutex, a completion thread reaps the completion ring and runs the callbacks.
+ */
+class IoUringAsyncIO : public AsyncIO {
+ public:
+  /**
+   * @return nullptr if io_uring is not available, e.g. on old kernels or in sandboxes that forbid it
+   */
+  static std::unique_ptr<IoUringAsyncIO> Create(int fd, size_t queue_depth);
+
+  ~IoUringAsyncIO() override;
+
+  DISALLOW_COPY(IoUringAsyncIO)
+
+  void Submit(std::vector<AsyncIORequest> &requests) override;
+
+  Backend GetBackend() const override { return kIoUring; }
+
+ private:
+  explicit IoUringAsyncIO(int fd) : fd_(fd) {}
+
+  bool Init(size_t queue_depth);
+
+  /** Queue one submission entry and tell the kernel, must hold mutex_. user_data 0 stops the completion thread. */
+  void PushEntry(uint8_t opcode, off_t offset, char *buf, size_t len, uint64_t user_data);
+
+  void ReapCompletions();
+
+  int fd_;
+  int ring_fd_{-1};
+  // submission ring
+  void *sq_ring_{nullptr};
+  size_t sq_ring_size_{0};
+  unsigned *sq_tail_{nullptr};
+  unsigned *sq_mask_{nullptr};
+  unsigned *sq_array_{nullptr};
+  void *sqes_{nullptr};
+  size_t sqes_size_{0};
+  // completion ring, shares the mapping of the submission ring on recent kernels
+  void *cq_ring_{nullptr};
+  size_t cq_ring_size_{0};
+  unsigned *cq_head_{nullptr};
+  unsigned *cq_tail_{nullptr};
+  unsigned *cq_mask_{nullptr};
+  void *cqes_{nullptr};
+
+  size_t capacity_{0};  // max requests in flight, never more than the completion ring holds
+  size_t in_flight_{0};
+  std::mutex mutex_;
+  std::condition_variable not_full_;
+  std::thread reaper_;
+};
+#endif  // MINISQL_HAVE_IO_URING
+
+#endif  // MINISQL_ASYNC_IO_H
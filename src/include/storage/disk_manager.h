@@ -1,16 +1,33 @@
 #ifndef DISK_MGR_H
 #define DISK_MGR_H
 
+#include <sys/types.h>
+
 #include <atomic>
-#include <fstream>
+#include <future>
 #include <iostream>
+#include <memory>
 #include <mutex>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "common/config.h"
 #include "common/macros.h"
 #include "page/bitmap_page.h"
 #include "page/disk_file_meta_page.h"
+#include "storage/async_io.h"
+
+/**
+ * A run of contiguous pages reserved by one table heap or index. The pages of [next_, end_) are already allocated in
+ * the bitmaps, BufferPoolManager::NewPage hands them out in order and ReleasePages returns the ones left.
+ */
+struct PageRun {
+  inline bool IsEmpty() const { return next_ == end_; }
+
+  page_id_t next_{INVALID_PAGE_ID};
+  page_id_t end_{INVALID_PAGE_ID};
+};
 
 /**
  * DiskManager takes care of the allocation and de allocation of pages within a database. It performs the reading and
@@ -19,10 +36,29 @@
  * Disk page storage format: (Free Page BitMap Size = PAGE_SIZE * 8, we note it as N)
  * | Meta Page | Free Page BitMap 1 | Page 1 | Page 2 | ....
  *      | Page N | Free Page BitMap 2 | Page N+1 | ... | Page 2N | ... |
+ * One meta page records EXTENTS_PER_META_PAGE extents. Once they are all used, the next extent is preceded by another
+ * meta page, up to MAX_META_PAGES groups of | Meta Page | extents... |. Page offsets in the file are 64 bit. The first
+ * meta page ends with a trailer recording the page size and the format version, see DISK_FORMAT_VERSION.
+ *
+ * Pages are read and written with positional pread/pwrite on a plain file descriptor, so data page I/O needs no latch
+ * and concurrent readers do not serialize on a shared file cursor. db_io_latch_ only protects the meta page and the
+ * bitmaps. With direct_io the file is opened with O_DIRECT so that pages are cached by the buffer pool only, buffers
+ * that are not page aligned then go through an aligned bounce buffer.
+ *
+ * The bitmaps and the meta page are cached in memory and only written back by Checkpoint(). free_extents_ has one bit
+ * per extent that still has a free page, so the extent to allocate from is found with a few count-trailing-zeros.
+ *
+ * The *Async methods go through an AsyncIO backend (io_uring, or a thread pool where it is not available) created on
+ * first use.
  */
 class DiskManager {
  public:
-  explicit DiskManager(const std::string &db_file);
+  /**
+   * @param direct_io open the file with O_DIRECT, falls back to buffered I/O if the file system refuses it
+   * @param async_backend backend of the asynchronous page I/O
+   */
+  explicit DiskManager(const std::string &db_file, bool direct_io = false,
+                       AsyncIO::Backend async_backend = AsyncIO::kIoUring);
 
   ~DiskManager() {
     if (!closed) {
@@ -42,12 +78,49 @@ class DiskManager {
    */
   void WritePage(page_id_t logical_page_id, const char *page_data);
 
+  /**
+   * Write a batch of pages in the given order, pass them sorted by page id to keep the writes sequential.
+   */
+  void WritePages(const std::vector<std::pair<page_id_t, const char *>> &pages);
+
+  /**
+   * Asynchronous ReadPage(), page_data must stay valid until the future is ready.
+   * @return a future that becomes false on I/O error
+   */
+  std::future<bool> ReadPageAsync(page_id_t logical_page_id, char *page_data);
+
+  /**
+   * Asynchronous WritePage(), page_data must stay valid until the future is ready.
+   * @return a future that becomes false on I/O error
+   */
+  std::future<bool> WritePageAsync(page_id_t logical_page_id, const char *page_data);
+
+  /**
+   * Submit a batch of page writes at once.
+   * @return a future that becomes ready once every page is written, false if any write failed
+   */
+  std::future<bool> WritePagesAsync(const std::vector<std::pair<page_id_t, const char *>> &pages);
+
+  /**
+   * @return the backend actually used for asynchronous I/O, the requested one once the file is closed
+   */
+  AsyncIO::Backend GetAsyncIOBackend() {
+    AsyncIO *async_io = GetAsyncIO();
+    return async_io == nullptr ? async_backend_ : async_io->GetBackend();
+  }
+
   /**
    * Get next free page from disk
    * @return logical page id of allocated page
    */
   page_id_t AllocatePage();
 
+  /**
+   * Allocate n pages that are contiguous in the file, i.e. in the same extent
+   * @return logical page id of the first page allocated, INVALID_PAGE_ID if no extent has such a run
+   */
+  page_id_t AllocatePages(uint32_t n);
+
   /**
    * Free this page and reset bit map
    */
@@ -58,6 +131,11 @@ class DiskManager {
    */
   bool IsPageFree(page_id_t logical_page_id);
 
+  /**
+   * Write the modified bitmaps and meta pages back to disk, called by Close().
+   */
+  void Checkpoint();
+
   /**
    * Shut down the disk manager and close all the file resources.
    */
@@ -69,13 +147,21 @@ class DiskManager {
    */
   char *GetMetaData() { return meta_data_; }
 
+  /**
+   * @return whether the file is accessed with O_DIRECT
+   */
+  bool IsDirectIO() const { return direct_io_; }
+
   static constexpr size_t BITMAP_SIZE = BitmapPage<PAGE_SIZE>::GetMaxSupportedSize();
 
+  /** Number of extents the chain of meta pages can describe. */
+  static constexpr uint32_t MAX_EXTENTS = MAX_META_PAGES * EXTENTS_PER_META_PAGE;
+
  private:
   /**
    * Helper function to get disk file size
    */
-  int GetFileSize(const std::string &file_name);
+  off_t GetFileSize();
 
   /**
    * Read physical page from disk
@@ -87,19 +173,90 @@ class DiskManager {
    */
   void WritePhysicalPage(page_id_t physical_page_id, const char *page_data);
 
+  /**
+   * Submit asynchronous reads or writes of logical pages, the future becomes ready once all of them completed.
+   */
+  std::future<bool> SubmitAsync(bool is_write, const std::vector<std::pair<page_id_t, char *>> &pages);
+
+  /**
+   * @return the asynchronous I/O backend, created on first use, nullptr once the file is closed
+   */
+  AsyncIO *GetAsyncIO();
+
+  /**
+   * Grow the cached file size after a successful write that ends at end.
+   */
+  void GrowFileSize(off_t end);
+
+  /**
+   * Read the meta pages after the first one and build free_extents_ from them.
+   */
+  void InitFreeSpaceMap();
+
+  /**
+   * @return the meta page of a group, meta_data_ for the first one
+   */
+  DiskFileMetaPage *GetMetaPage(uint32_t meta_page_id);
+
+  /**
+   * @return the used page count of an extent, kept in the meta page of its group
+   */
+  uint32_t &ExtentUsedPages(uint32_t extent_id);
+
+  /**
+   * Update the used page count of an extent and the totals of the first meta page after pages were allocated (delta
+   * > 0) or freed (delta < 0) in it.
+   */
+  void UpdateExtentUsedPages(uint32_t extent_id, int32_t delta);
+
+  /**
+   * @return physical page id of the bitmap of an extent
+   */
+  static page_id_t BitmapPhysicalId(uint32_t extent_id);
+
+  /**
+   * @return the first extent with a free page, MAX_EXTENTS if the file is full
+   */
+  uint32_t FindFreeExtent() const;
+
+  /**
+   * Update the bit of an extent in free_extents_ after its used page count changed.
+   */
+  void UpdateFreeExtent(uint32_t extent_id);
+
+  /**
+   * @return the cached bitmap of an extent, read from disk on first use
+   */
+  BitmapPage<PAGE_SIZE> *GetBitmap(uint32_t extent_id);
+
   /**
    * Map logical page id to physical page id
    */
   page_id_t MapPageId(page_id_t logical_page_id);
 
  private:
-  // stream to write db file
-  std::fstream db_io_;
+  // descriptor of the db file
+  int db_fd_{-1};
   std::string file_name_;
-  // with multiple buffer pool instances, need to protect file access
+  bool direct_io_{false};
+  // cached size of the db file, pages past its end read as zeros
+  std::atomic<off_t> file_size_{0};
+  // asynchronous page I/O, created on first use
+  AsyncIO::Backend async_backend_;
+  std::mutex async_io_latch_;
+  std::unique_ptr<AsyncIO> async_io_;
+  // protects the meta page and the free space map
   std::recursive_mutex db_io_latch_;
   bool closed{false};
-  char meta_data_[PAGE_SIZE];
+  alignas(PAGE_SIZE) char meta_data_[PAGE_SIZE];
+  // meta pages of the groups after the first one
+  std::vector<std::unique_ptr<char[]>> meta_pages_;
+  std::vector<bool> meta_dirty_;
+  // cached bitmap pages, nullptr until an extent is used
+  std::vector<std::unique_ptr<char[]>> bitmaps_;
+  std::vector<bool> bitmap_dirty_;
+  // bit i is set iff extent i has a free page
+  std::vector<uint64_t> free_extents_;
 };
 
 #endif
\ No newline at end of file
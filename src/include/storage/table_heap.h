@@ -1,8 +1,15 @@
 #ifndef MINISQL_TABLE_HEAP_H
 #define MINISQL_TABLE_HEAP_H
 
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
 #include "buffer/buffer_pool_manager.h"
 #include "concurrency/lock_manager.h"
+#include "page/free_space_map_page.h"
 #include "page/header_page.h"
 #include "page/table_page.h"
 #include "recovery/log_manager.h"
@@ -12,26 +19,63 @@ class TableHeap {
   friend class TableIterator;
 
  public:
+  /**
+   * What a Vacuum() did.
+   */
+  struct VacuumStats {
+    size_t pages_before_{0};     // pages in the chain before
+    size_t pages_reclaimed_{0};  // pages unlinked and deleted
+    size_t rows_deleted_{0};     // tuples marked as deleted whose bytes were reclaimed
+    size_t rows_moved_{0};       // tuples moved to another page
+  };
+
+  /**
+   * Called for each tuple Vacuum() or ConvertEarlierPages() moves, row holds the new rid.
+   */
+  using MoveCallback = std::function<void(Row &row, const RowId &old_rid)>;
+
   static TableHeap *Create(BufferPoolManager *buffer_pool_manager, Schema *schema, Txn *txn, LogManager *log_manager,
                            LockManager *lock_manager) {
     return new TableHeap(buffer_pool_manager, schema, txn, log_manager, lock_manager);
   }
 
+  /**
+   * Open an existing table heap.
+   * @param fsm_page_id first page of its free space map, if invalid the map is rebuilt from the page chain on the first
+   * write and GetFreeSpaceMapPageId() returns the new one
+   */
   static TableHeap *Create(BufferPoolManager *buffer_pool_manager, page_id_t first_page_id, Schema *schema,
-                           LogManager *log_manager, LockManager *lock_manager) {
-    return new TableHeap(buffer_pool_manager, first_page_id, schema, log_manager, lock_manager);
+                           LogManager *log_manager, LockManager *lock_manager,
+                           page_id_t fsm_page_id = INVALID_PAGE_ID) {
+    return new TableHeap(buffer_pool_manager, first_page_id, schema, log_manager, lock_manager, fsm_page_id);
   }
 
-  ~TableHeap() {}
+  /**
+   * Give the pages reserved for this table but never used back to the disk manager.
+   */
+  ~TableHeap() { buffer_pool_manager_->ReleasePages(page_run_); }
+
+  DISALLOW_COPY(TableHeap)
 
   /**
    * Insert a tuple into the table. If the tuple is too large (>= page_size), return false.
+   * The free space map picks a page with enough room, a new page is appended only if there is none.
    * @param[in/out] row Tuple Row to insert, the rid of the inserted tuple is wrapped in object row
    * @param[in] txn The recovery performing the insert
    * @return true iff the insert is successful
    */
   bool InsertTuple(Row &row, Txn *txn);
 
+  /**
+   * Insert many tuples at once. They fill the last page of the table, then pages which are built before they are
+   * linked to the page chain in one step, so each page is fetched and unpinned once rather than once per tuple.
+   * Free space the map knows of in other pages is left to InsertTuple.
+   * @param[in/out] rows Tuples to insert, the rid of each inserted tuple is wrapped in its row
+   * @param[in] txn The recovery performing the insert
+   * @return true iff all tuples are inserted, false if one is too large or the buffer pool ran out of frames
+   */
+  bool BulkInsert(std::vector<Row> &rows, Txn *txn);
+
   /**
    * Mark the tuple as deleted. The actual delete will occur when ApplyDelete is called.
    * @param[in] rid Resource id of the tuple of delete
@@ -81,8 +125,32 @@ class TableHeap {
       buffer_pool_manager_->UnpinPage(old_page_id, false);
       buffer_pool_manager_->DeletePage(old_page_id);
     }
+    DeleteFreeSpaceMap();
   }
 
+  /**
+   * Reclaim the space of deleted tuples: apply the deletes of tuples marked as deleted, move all tuples of a page into
+   * the page before it when they fit there, and unlink and delete pages left empty. The first page is kept. Must not
+   * run concurrently with other operations on this table or its iterators. Stops at the first page that can not be
+   * fetched, the stats then cover the pages before it.
+   * @param on_move Called for every moved tuple so that indexes can follow it
+   */
+  VacuumStats Vacuum(Txn *txn, const MoveCallback &on_move = nullptr);
+
+  /**
+   * Convert the pages of a table created before table pages had FreeSlot and DeadSpace in their header, see
+   * TablePage::ConvertEarlierFormat(). Must run once, before any other use of the table heap.
+   * @param on_move Called for every tuple moved out of a page too full to convert in place
+   * @return false if a page could not be fetched or a tuple could not be inserted again
+   */
+  bool ConvertEarlierPages(Txn *txn, const MoveCallback &on_move = nullptr);
+
+  /**
+   * @return the number of tuples deleted or marked as deleted since the last vacuum of this table heap object, a hint
+   * for when to vacuum
+   */
+  inline size_t GetDeadTupleCount() const { return dead_tuples_; }
+
   /**
    * Free table heap and release storage in disk file
    */
@@ -103,6 +171,21 @@ class TableHeap {
    */
   inline page_id_t GetFirstPageId() const { return first_page_id_; }
 
+  /**
+   * @return the id of the first page of the free space map of this table
+   */
+  inline page_id_t GetFreeSpaceMapPageId() {
+    std::scoped_lock<std::recursive_mutex> lock(fsm_latch_);
+    LoadFreeSpaceMap();
+    return fsm_page_id_;
+  }
+
+  /**
+   * Set how many pages of the page chain iterators of this table keep in flight ahead of the page they are on,
+   * 0 disables read-ahead.
+   */
+  inline void SetReadAhead(size_t pages) { read_ahead_pages_ = pages; }
+
  private:
   /**
    * create table heap and initialize first page
@@ -113,21 +196,74 @@ class TableHeap {
         schema_(schema),
         log_manager_(log_manager),
         lock_manager_(lock_manager) {
-    auto first_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->NewPage(first_page_id_));
+    auto first_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->NewPage(first_page_id_, page_run_));
     assert(first_page != nullptr);
     first_page->WLatch();
     first_page->Init(first_page_id_, INVALID_PAGE_ID, log_manager_, txn);
+    uint32_t free_space = first_page->GetFreeSpaceRemaining();
     first_page->WUnlatch();
     buffer_pool_manager_->UnpinPage(first_page_id_, true);
+    // the map is not taken from page_run_, the run is for the pages scans read
+    CreateFreeSpaceMap();
+    AppendFreeSpace(first_page_id_, FreeSpaceMapPage::ToCategory(free_space));
   };
 
   explicit TableHeap(BufferPoolManager *buffer_pool_manager, page_id_t first_page_id, Schema *schema,
-                     LogManager *log_manager, LockManager *lock_manager)
+                     LogManager *log_manager, LockManager *lock_manager, page_id_t fsm_page_id)
       : buffer_pool_manager_(buffer_pool_manager),
         first_page_id_(first_page_id),
         schema_(schema),
         log_manager_(log_manager),
-        lock_manager_(lock_manager) {}
+        lock_manager_(lock_manager),
+        fsm_page_id_(fsm_page_id) {}
+
+  /**
+   * Read the free space map into memory, or build it from the page chain if the table has none, must hold fsm_latch_.
+   * @return false if a page could not be fetched, the map is then read again on the next call
+   */
+  bool LoadFreeSpaceMap();
+
+  /**
+   * Start an empty free space map, must hold fsm_latch_.
+   */
+  void CreateFreeSpaceMap();
+
+  /**
+   * Give the pages of the free space map back to the disk manager.
+   * @return false if a page of the map could not be fetched, the pages after it are not freed
+   */
+  bool DeleteFreeSpaceMap();
+
+  /**
+   * Forget the in-memory copy of the free space map, must hold fsm_latch_.
+   */
+  void ClearFreeSpaceMap();
+
+  /**
+   * Record a new last page of the page chain in the free space map, must hold fsm_latch_.
+   */
+  void AppendFreeSpace(page_id_t page_id, uint8_t category);
+
+  /**
+   * Record the free space left in a page after it changed.
+   */
+  void UpdateFreeSpace(page_id_t page_id, uint32_t free_space);
+
+  /**
+   * Make the free space map record exactly the given pages, keeping its first page, must hold fsm_latch_.
+   */
+  void RewriteFreeSpaceMap(const std::vector<std::pair<page_id_t, uint8_t>> &pages);
+
+  /**
+   * Set the category of the index-th page of the chain in memory and in its FSM page, must hold fsm_latch_.
+   */
+  void SetCategory(uint32_t index, uint8_t category);
+
+  /**
+   * @return index in the page chain of a page of at least min_category, starting at the last page inserted into,
+   * or -1 if there is none
+   */
+  int32_t FindFreeSpace(uint32_t min_category);
 
  private:
   BufferPoolManager *buffer_pool_manager_;
@@ -135,6 +271,21 @@ class TableHeap {
   Schema *schema_;
   [[maybe_unused]] LogManager *log_manager_;
   [[maybe_unused]] LockManager *lock_manager_;
+  size_t read_ahead_pages_{DEFAULT_READ_AHEAD_PAGES};
+  PageRun page_run_;  // pages of the table are taken from this run so that scans read the file sequentially
+
+  // in-memory copy of the free space map, loaded on the first write
+  static constexpr uint32_t FSM_BLOCK_SIZE = 64;
+  std::recursive_mutex fsm_latch_;
+  page_id_t fsm_page_id_{INVALID_PAGE_ID};
+  bool fsm_loaded_{false};
+  std::vector<page_id_t> fsm_pages_;                  // the FSM page chain
+  std::vector<page_id_t> data_pages_;                 // the page chain of the table, back() is its last page
+  std::vector<uint8_t> categories_;                   // category of each page of data_pages_
+  std::vector<uint8_t> block_max_;                    // max category of each FSM_BLOCK_SIZE pages, to skip full ones
+  std::unordered_map<page_id_t, uint32_t> page_index_;  // page id -> index in data_pages_
+  uint32_t search_hint_{0};
+  std::atomic<size_t> dead_tuples_{0};
 };
 
 #endif  // MINISQL_TABLE_HEAP_H
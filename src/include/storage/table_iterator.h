@@ -1,12 +1,20 @@
 #ifndef MINISQL_TABLE_ITERATOR_H
 #define MINISQL_TABLE_ITERATOR_H
 
+#include "buffer/page_guard.h"
 #include "common/rowid.h"
 #include "concurrency/txn.h"
 #include "record/row.h"
+#include "record/row_view.h"
 
 class TableHeap;
 
+class TablePage;
+
+/**
+ * The iterator keeps the page of the current row pinned. The row is only deserialized when it is dereferenced, View()
+ * reads it in place instead.
+ */
 class TableIterator {
 public:
  // you may define your own constructor based on your member variables
@@ -26,6 +34,11 @@ public:
 
   Row *operator->();
 
+  /**
+   * @return a view of the current row in its page, valid until the iterator moves or the row is modified
+   */
+  const RowView &View();
+
   TableIterator &operator=(const TableIterator &itr) noexcept;
 
   TableIterator &operator++();
@@ -33,10 +46,27 @@ public:
   TableIterator operator++(int);
 
 private:
+  friend class TableHeap;
+
+  /**
+   * Called when the iterator moves to page_id: once half of the table's read-ahead window was consumed, asks the
+   * buffer pool to prefetch the window's worth of pages that follow page_id in the page chain.
+   */
+  void ReadAhead(page_id_t page_id);
+
+  /**
+   * Pin the page of the current row if the guard holds another page.
+   */
+  TablePage *PinCurrentPage();
+
   // add your own private member variables here
   TableHeap* heap;
   Row row;
   Txn* txn;
+  bool row_loaded_{false};  // whether row holds the fields of the current row or just its rid
+  PageGuard page_guard_;
+  RowView view_;
+  size_t read_ahead_distance_{0};  // pages after the current one requested from the prefetcher
 };
 
 #endif  // MINISQL_TABLE_ITERATOR_H
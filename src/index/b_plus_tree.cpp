@@ -7,10 +7,13 @@
 #include "index/generic_key.h"
 #include "page/index_roots_page.h"
 
+#define BPLUSTREE_TYPE BPlusTree<KeySize>
+
 /**
  * TODO: Student Implement
  */
-BPlusTree::BPlusTree(index_id_t index_id, BufferPoolManager *buffer_pool_manager, const KeyManager &KM,
+INDEX_TEMPLATE_ARGUMENTS
+BPLUSTREE_TYPE::BPlusTree(index_id_t index_id, BufferPoolManager *buffer_pool_manager, const KeyManager &KM,
                      int leaf_max_size, int internal_max_size)
     : index_id_(index_id),
       buffer_pool_manager_(buffer_pool_manager),
@@ -30,31 +33,46 @@ BPlusTree::BPlusTree(index_id_t index_id, BufferPoolManager *buffer_pool_manager
   }
 }
 
-void BPlusTree::Destroy(page_id_t current_page_id) {
-  if(!IsEmpty()){
-    auto page = buffer_pool_manager_->FetchPage(current_page_id);
-    if(page != nullptr){
-      auto node = reinterpret_cast<BPlusTreePage *>(page->GetData());
-      if(node->IsLeafPage()){//是叶子页，下面再没有孩子页了
-        auto tmp_leaf_node = reinterpret_cast<LeafPage *>(page->GetData());
-        buffer_pool_manager_->DeletePage(current_page_id);
-      }else{
-        auto tmp_internal_node = reinterpret_cast<InternalPage *>(page->GetData());
-        for(int i = 0; i < tmp_internal_node->GetSize(); i++){
-          Destroy(tmp_internal_node->ValueAt(i));//递归删除孩子页
-        }
-        buffer_pool_manager_->DeletePage(current_page_id);
-      }
-      root_page_id_ = INVALID_PAGE_ID;
-      UpdateRootPageId(0);
+INDEX_TEMPLATE_ARGUMENTS
+BPLUSTREE_TYPE::~BPlusTree() { buffer_pool_manager_->ReleasePages(page_run_); }
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::Destroy(page_id_t current_page_id) {
+  if (current_page_id == INVALID_PAGE_ID) {  // the whole tree
+    if (root_page_id_ == INVALID_PAGE_ID) {
+      return;
+    }
+    Destroy(root_page_id_);
+    root_page_id_ = INVALID_PAGE_ID;
+    UpdateRootPageId(0);
+    return;
+  }
+  auto page = buffer_pool_manager_->FetchPage(current_page_id);
+  if (page == nullptr) {
+    LOG(ERROR) << "Failed to fetch page " << current_page_id << " of index " << index_id_ << ", it is not freed";
+    return;
+  }
+  // a page can only be deleted once it is unpinned, its children are read before
+  std::vector<page_id_t> children;
+  auto node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  if (!node->IsLeafPage()) {
+    auto internal_node = reinterpret_cast<InternalPage *>(page->GetData());
+    for (int i = 0; i < internal_node->GetSize(); i++) {
+      children.push_back(internal_node->ValueAt(i));
     }
   }
+  buffer_pool_manager_->UnpinPage(current_page_id, false);
+  buffer_pool_manager_->DeletePage(current_page_id);
+  for (auto child : children) {
+    Destroy(child);
+  }
 }
 
 /*
  * Helper function to decide whether current b+tree is empty
  */
-bool BPlusTree::IsEmpty() const {
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::IsEmpty() const {
   if(root_page_id_ == INVALID_PAGE_ID){//空索引
     return true;
   }
@@ -76,11 +94,12 @@ bool BPlusTree::IsEmpty() const {
  * This method is used for point query
  * @return : true means key exists
  */
-bool BPlusTree::GetValue(const GenericKey *key, std::vector<RowId> &result, Txn *transaction) {
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::GetValue(const KeyType *key, std::vector<RowId> &result, Txn *transaction) {
   if(!IsEmpty()){//索引不为空
     auto tmp_res_page = FindLeafPage(key, root_page_id_);
     auto tmp_leaf_page = buffer_pool_manager_->FetchPage(tmp_res_page->GetPageId());//固定该页
-    auto tmp_leaf_node = reinterpret_cast<BPlusTreeLeafPage *>(tmp_leaf_page->GetData());
+    auto tmp_leaf_node = reinterpret_cast<LeafPage *>(tmp_leaf_page->GetData());
     RowId tmp_res;
     int found = 0;
     tmp_leaf_page->RLatch();
@@ -112,7 +131,8 @@ bool BPlusTree::GetValue(const GenericKey *key, std::vector<RowId> &result, Txn
  * @return: since we only support unique key, if user try to insert duplicate
  * keys return false, otherwise return true.
  */
-bool BPlusTree::Insert(GenericKey *key, const RowId &value, Txn *transaction) {
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::Insert(KeyType *key, const RowId &value, Txn *transaction) {
   if(IsEmpty()){
     StartNewTree(key, value);
     return true;
@@ -126,14 +146,15 @@ bool BPlusTree::Insert(GenericKey *key, const RowId &value, Txn *transaction) {
  * an "out of memory" exception if returned value is nullptr), then update b+
  * tree's root page id and insert entry directly into leaf page.
  */
-void BPlusTree::StartNewTree(GenericKey *key, const RowId &value) {
-  auto page = buffer_pool_manager_->NewPage(root_page_id_);//得到一个新的页
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::StartNewTree(KeyType *key, const RowId &value) {
+  auto page = buffer_pool_manager_->NewPage(root_page_id_, page_run_);//得到一个新的页
   if(page){
     auto node = reinterpret_cast<LeafPage *>(page->GetData());
     //预留一些空间以免异常
-    leaf_max_size_ = (PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / (processor_.GetKeySize() + sizeof(RowId));
-    internal_max_size_ = (PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE) / (processor_.GetKeySize() + sizeof(RowId)) - 1;
-    node->Init(root_page_id_, INVALID_PAGE_ID, processor_.GetKeySize(), leaf_max_size_);
+    leaf_max_size_ = (PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / (KeySize + sizeof(RowId));
+    internal_max_size_ = (PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE) / (KeySize + sizeof(RowId)) - 1;
+    node->Init(root_page_id_, INVALID_PAGE_ID, leaf_max_size_);
     node->Insert(key, value, processor_);
     UpdateRootPageId(1);//新建了一个索引，应该在索引根页中插入
     buffer_pool_manager_->UnpinPage(root_page_id_, true);
@@ -150,7 +171,8 @@ void BPlusTree::StartNewTree(GenericKey *key, const RowId &value) {
  * @return: since we only support unique key, if user try to insert duplicate
  * keys return false, otherwise return true.
  */
-bool BPlusTree::InsertIntoLeaf(GenericKey *key, const RowId &value, Txn *transaction) {
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::InsertIntoLeaf(KeyType *key, const RowId &value, Txn *transaction) {
   if(IsEmpty()){//索引为空
     return false;
   }
@@ -187,19 +209,20 @@ bool BPlusTree::InsertIntoLeaf(GenericKey *key, const RowId &value, Txn *transac
  * an "out of memory" exception if returned value is nullptr), then move half
  * of key & value pairs from input page to newly created page
  */
-BPlusTreeInternalPage *BPlusTree::Split(InternalPage *node, Txn *transaction) {
+INDEX_TEMPLATE_ARGUMENTS
+BPlusTreeInternalPage<KeySize> *BPLUSTREE_TYPE::Split(InternalPage *node, Txn *transaction) {
   //把传入页的数据分一半到新申请的页中
   //该函数未维护分裂后父页数据
   auto old_page = buffer_pool_manager_->FetchPage(node->GetPageId());//固定旧页
   page_id_t new_page_id;
-  auto new_page = buffer_pool_manager_->NewPage(new_page_id);//得到新页
+  auto new_page = buffer_pool_manager_->NewPage(new_page_id, page_run_);//得到新页
   if(new_page == nullptr){
     LOG(ERROR)<<"out of memory"<<std::endl;
     return nullptr;
   }else{
     auto new_node = reinterpret_cast<InternalPage *>(new_page->GetData());
     new_node->SetPageType(IndexPageType::INTERNAL_PAGE);
-    new_node->Init(new_page_id, node->GetParentPageId(), node->GetKeySize(), internal_max_size_);
+    new_node->Init(new_page_id, node->GetParentPageId(), internal_max_size_);
     node->MoveHalfTo(new_node, buffer_pool_manager_);//把node的后半段移到new_node（一定为空）的后半段，故相当于前半段
     buffer_pool_manager_->UnpinPage(new_page_id, true);//释放旧页
     buffer_pool_manager_->UnpinPage(node->GetPageId(), true);//释放新页
@@ -207,19 +230,20 @@ BPlusTreeInternalPage *BPlusTree::Split(InternalPage *node, Txn *transaction) {
   }
 }
 
-BPlusTreeLeafPage *BPlusTree::Split(LeafPage *node, Txn *transaction) {
+INDEX_TEMPLATE_ARGUMENTS
+BPlusTreeLeafPage<KeySize> *BPLUSTREE_TYPE::Split(LeafPage *node, Txn *transaction) {
   //把传入页的数据分一半到新申请的页中
   //该函数未维护分裂后父页数据
   auto old_page = buffer_pool_manager_->FetchPage(node->GetPageId());//固定旧页
   page_id_t new_page_id;
-  auto new_page = buffer_pool_manager_->NewPage(new_page_id);//得到新页
+  auto new_page = buffer_pool_manager_->NewPage(new_page_id, page_run_);//得到新页
   if(new_page == nullptr){
     LOG(ERROR)<<"out of memory"<<std::endl;
     return nullptr;
   }else{
     auto new_node = reinterpret_cast<LeafPage *>(new_page->GetData());
     new_node->SetPageType(IndexPageType::LEAF_PAGE);
-    new_node->Init(new_page_id, node->GetParentPageId(), node->GetKeySize(), leaf_max_size_);//new_node和node性质一样
+    new_node->Init(new_page_id, node->GetParentPageId(), leaf_max_size_);//new_node和node性质一样
     node->MoveHalfTo(new_node);
     //把叶子页连起来
     new_node->SetNextPageId(node->GetNextPageId());
@@ -239,12 +263,13 @@ BPlusTreeLeafPage *BPlusTree::Split(LeafPage *node, Txn *transaction) {
  * adjusted to take info of new_node into account. Remember to deal with split
  * recursively if necessary.
  */
-void BPlusTree::InsertIntoParent(BPlusTreePage *old_node, GenericKey *key, BPlusTreePage *new_node, Txn *transaction) {
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::InsertIntoParent(BPlusTreePage *old_node, KeyType *key, BPlusTreePage *new_node, Txn *transaction) {
   if(old_node->IsRootPage()){//老根分裂了，须创建新根
-    auto new_page = buffer_pool_manager_->NewPage(root_page_id_);
+    auto new_page = buffer_pool_manager_->NewPage(root_page_id_, page_run_);
     auto new_root = reinterpret_cast<InternalPage *>(new_page->GetData());
     new_root->SetPageType(IndexPageType::INTERNAL_PAGE);
-    new_root->Init(root_page_id_, INVALID_PAGE_ID, processor_.GetKeySize(), internal_max_size_);
+    new_root->Init(root_page_id_, INVALID_PAGE_ID, internal_max_size_);
     new_root->PopulateNewRoot(old_node->GetPageId(), key, new_node->GetPageId());
     old_node->SetParentPageId(new_root->GetPageId());
     new_node->SetParentPageId(new_root->GetPageId());
@@ -277,7 +302,8 @@ void BPlusTree::InsertIntoParent(BPlusTreePage *old_node, GenericKey *key, BPlus
  * delete entry from leaf page. Remember to deal with redistribute or merge if
  * necessary.
  */
-void BPlusTree::Remove(const GenericKey *key, Txn *transaction) {
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::Remove(const KeyType *key, Txn *transaction) {
   if(IsEmpty()){
     return;
   }
@@ -309,8 +335,9 @@ void BPlusTree::Remove(const GenericKey *key, Txn *transaction) {
  * @return: true means target leaf page should be deleted, false means no
  * deletion happens
  */
+INDEX_TEMPLATE_ARGUMENTS
 template <typename N>
-bool BPlusTree::CoalesceOrRedistribute(N *&node, Txn *transaction) {
+bool BPLUSTREE_TYPE::CoalesceOrRedistribute(N *&node, Txn *transaction) {
   if(IsEmpty()){//空索引
     return false;
   }
@@ -407,7 +434,8 @@ bool BPlusTree::CoalesceOrRedistribute(N *&node, Txn *transaction) {
  * @param   parent             parent page of input "node"
  * @return  true means parent node should be deleted, false means no deletion happened
  */
-bool BPlusTree::Coalesce(LeafPage *&neighbor_node, LeafPage *&node, InternalPage *&parent, int index, Txn *transaction) {
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::Coalesce(LeafPage *&neighbor_node, LeafPage *&node, InternalPage *&parent, int index, Txn *transaction) {
   node->MoveAllTo(neighbor_node);//把node中的数据全部接到neighbor_node后面
   buffer_pool_manager_->DeletePage(node->GetPageId());
   parent->Remove(index);//更新父节点数据
@@ -418,7 +446,8 @@ bool BPlusTree::Coalesce(LeafPage *&neighbor_node, LeafPage *&node, InternalPage
   }
 }
 
-bool BPlusTree::Coalesce(InternalPage *&neighbor_node, InternalPage *&node, InternalPage *&parent, int index, Txn *transaction) {
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::Coalesce(InternalPage *&neighbor_node, InternalPage *&node, InternalPage *&parent, int index, Txn *transaction) {
   node->MoveAllTo(neighbor_node, parent->KeyAt(index), buffer_pool_manager_);
   buffer_pool_manager_->DeletePage(node->GetPageId());
   parent->Remove(index);
@@ -438,7 +467,8 @@ bool BPlusTree::Coalesce(InternalPage *&neighbor_node, InternalPage *&node, Inte
  * @param   neighbor_node      sibling page of input "node"
  * @param   node               input from method coalesceOrRedistribute()
  */
-void BPlusTree::Redistribute(LeafPage *neighbor_node, LeafPage *node, int index){//index是标志neighbor_node和node谁先谁后的
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::Redistribute(LeafPage *neighbor_node, LeafPage *node, int index){//index是标志neighbor_node和node谁先谁后的
   if(index){//neighbor_node在前，node在后
     neighbor_node->MoveLastToFrontOf(node);//要改父节点
     auto parent_node_page = buffer_pool_manager_->FetchPage(node->GetParentPageId());
@@ -453,7 +483,8 @@ void BPlusTree::Redistribute(LeafPage *neighbor_node, LeafPage *node, int index)
     buffer_pool_manager_->UnpinPage(parent_node->GetPageId(), true);
   }
 }
-void BPlusTree::Redistribute(InternalPage *neighbor_node, InternalPage *node, int index){
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::Redistribute(InternalPage *neighbor_node, InternalPage *node, int index){
   if(index){//neighbor_node在前，node在后
     auto parent_node_page = buffer_pool_manager_->FetchPage(node->GetParentPageId());
     auto parent_node = reinterpret_cast<InternalPage *>(parent_node_page->GetData());
@@ -478,7 +509,8 @@ void BPlusTree::Redistribute(InternalPage *neighbor_node, InternalPage *node, in
  * @return : true means root page should be deleted, false means no deletion
  * happened
  */
-bool BPlusTree::AdjustRoot(BPlusTreePage *old_root_node){
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::AdjustRoot(BPlusTreePage *old_root_node){
   if(old_root_node->GetSize() == 1){
     if(old_root_node->IsLeafPage()){//整个索引就剩下一个键值
       return false;//这种情况是正常的，不应删
@@ -505,12 +537,13 @@ bool BPlusTree::AdjustRoot(BPlusTreePage *old_root_node){
  * index iterator
  * @return : index iterator
  */
-IndexIterator BPlusTree::Begin() {
+INDEX_TEMPLATE_ARGUMENTS
+IndexIterator<KeySize> BPLUSTREE_TYPE::Begin() {
   auto tmp_res_page = FindLeafPage(nullptr, root_page_id_, true);
   auto leaf_node_page = buffer_pool_manager_->FetchPage(tmp_res_page->GetPageId());//固定该页
   auto leaf_node = reinterpret_cast<LeafPage *>(leaf_node_page->GetData());
   buffer_pool_manager_->UnpinPage(tmp_res_page->GetPageId(), false);
-  return IndexIterator(leaf_node->GetPageId(), buffer_pool_manager_);
+  return IndexIterator<KeySize>(leaf_node->GetPageId(), buffer_pool_manager_);
 }
 
 /*
@@ -518,12 +551,13 @@ IndexIterator BPlusTree::Begin() {
  * first, then construct index iterator
  * @return : index iterator
  */
-IndexIterator BPlusTree::Begin(const GenericKey *key) {
+INDEX_TEMPLATE_ARGUMENTS
+IndexIterator<KeySize> BPLUSTREE_TYPE::Begin(const KeyType *key) {
   auto tmp_res_page = FindLeafPage(key, root_page_id_, false);
   auto leaf_node_page = buffer_pool_manager_->FetchPage(tmp_res_page->GetPageId());//固定该页
   auto leaf_node = reinterpret_cast<LeafPage *>(leaf_node_page->GetData());
   buffer_pool_manager_->UnpinPage(tmp_res_page->GetPageId(), false);
-  return IndexIterator(leaf_node->GetPageId(), buffer_pool_manager_, leaf_node->KeyIndex(key, processor_));
+  return IndexIterator<KeySize>(leaf_node->GetPageId(), buffer_pool_manager_, leaf_node->KeyIndex(key, processor_));
 }
 
 /*
@@ -531,8 +565,9 @@ IndexIterator BPlusTree::Begin(const GenericKey *key) {
  * of the key/value pair in the leaf node
  * @return : index iterator
  */
-IndexIterator BPlusTree::End() {
-  return IndexIterator(INVALID_PAGE_ID, buffer_pool_manager_, 0);
+INDEX_TEMPLATE_ARGUMENTS
+IndexIterator<KeySize> BPLUSTREE_TYPE::End() {
+  return IndexIterator<KeySize>(INVALID_PAGE_ID, buffer_pool_manager_, 0);
 }
 
 /*****************************************************************************
@@ -543,7 +578,8 @@ IndexIterator BPlusTree::End() {
  * the left most leaf page
  * Note: the leaf page is pinned, you need to unpin it after use.
  */
-Page *BPlusTree::FindLeafPage(const GenericKey *key, page_id_t page_id, bool leftMost) {
+INDEX_TEMPLATE_ARGUMENTS
+Page *BPLUSTREE_TYPE::FindLeafPage(const KeyType *key, page_id_t page_id, bool leftMost) {
   auto tmp_page = buffer_pool_manager_->FetchPage(page_id);
   auto tmp_node = reinterpret_cast<BPlusTreePage *>(tmp_page->GetData());
   tmp_page->RLatch();
@@ -569,11 +605,11 @@ Page *BPlusTree::FindLeafPage(const GenericKey *key, page_id_t page_id, bool lef
  * insert a record <index_name, current_page_id> into header page instead of
  * updating it.
  */
-void BPlusTree::UpdateRootPageId(int insert_record) {
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::UpdateRootPageId(int insert_record) {
   auto header_page = reinterpret_cast<IndexRootsPage *>(buffer_pool_manager_->FetchPage(INDEX_ROOTS_PAGE_ID));
-  if(insert_record){
-    header_page->Insert(index_id_, root_page_id_);
-  }else{
+  // a tree that was emptied or destroyed keeps its record, with an invalid root
+  if(!insert_record || !header_page->Insert(index_id_, root_page_id_)){
     header_page->Update(index_id_, root_page_id_);
   }
   buffer_pool_manager_->UnpinPage(INDEX_ROOTS_PAGE_ID, true);
@@ -582,7 +618,8 @@ void BPlusTree::UpdateRootPageId(int insert_record) {
 /**
  * This method is used for debug only, You don't need to modify
  */
-void BPlusTree::ToGraph(BPlusTreePage *page, BufferPoolManager *bpm, std::ofstream &out, Schema *schema) const {
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::ToGraph(BPlusTreePage *page, BufferPoolManager *bpm, std::ofstream &out, Schema *schema) const {
   std::string leaf_prefix("LEAF_");
   std::string internal_prefix("INT_");
   if (page->IsLeafPage()) {
@@ -673,7 +710,8 @@ void BPlusTree::ToGraph(BPlusTreePage *page, BufferPoolManager *bpm, std::ofstre
 /**
  * This function is for debug only, you don't need to modify
  */
-void BPlusTree::ToString(BPlusTreePage *page, BufferPoolManager *bpm) const {
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::ToString(BPlusTreePage *page, BufferPoolManager *bpm) const {
   if (page->IsLeafPage()) {
     auto *leaf = reinterpret_cast<LeafPage *>(page);
     std::cout << "Leaf Page: " << leaf->GetPageId() << " parent: " << leaf->GetParentPageId()
@@ -698,7 +736,8 @@ void BPlusTree::ToString(BPlusTreePage *page, BufferPoolManager *bpm) const {
   }
 }
 
-bool BPlusTree::Check() {
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::Check() {
   bool all_unpinned = buffer_pool_manager_->CheckAllUnpinned();
   if (!all_unpinned) {
     LOG(ERROR) << "problem in page unpin" << endl;
@@ -706,3 +745,9 @@ bool BPlusTree::Check() {
   return all_unpinned;
 }
 
+template class BPlusTree<8>;
+template class BPlusTree<16>;
+template class BPlusTree<32>;
+template class BPlusTree<64>;
+template class BPlusTree<128>;
+template class BPlusTree<256>;
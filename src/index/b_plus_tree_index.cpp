@@ -2,19 +2,24 @@
 
 #include "index/generic_key.h"
 #include "utils/tree_file_mgr.h"
-BPlusTreeIndex::BPlusTreeIndex(index_id_t index_id, IndexSchema *key_schema, size_t key_size,
-                               BufferPoolManager *buffer_pool_manager)
-    : Index(index_id, key_schema),
-      processor_(key_schema_, key_size),
-      container_(index_id, buffer_pool_manager, processor_) {}
 
-dberr_t BPlusTreeIndex::InsertEntry(const Row &key, RowId row_id, Txn *txn) {
+#define BPLUSTREE_INDEX_TYPE BPlusTreeIndex<KeySize>
+
+INDEX_TEMPLATE_ARGUMENTS
+BPLUSTREE_INDEX_TYPE::BPlusTreeIndex(index_id_t index_id, IndexSchema *key_schema,
+                                     BufferPoolManager *buffer_pool_manager)
+    : Index(index_id, key_schema), processor_(key_schema_), container_(index_id, buffer_pool_manager, processor_) {}
+
+INDEX_TEMPLATE_ARGUMENTS
+dberr_t BPLUSTREE_INDEX_TYPE::InsertEntry(const Row &key, RowId row_id, Txn *txn) {
   // ASSERT(row_id.Get() != INVALID_ROWID.Get(), "Invalid row id for index insert.");
-  GenericKey *index_key = processor_.InitKey();
-  processor_.SerializeFromKey(index_key, key, key_schema_);
+  if (key.FindTooLongField(key_schema_) != key.GetFieldCount()) {
+    return DB_FAILED;
+  }
+  KeyType index_key;
+  processor_.SerializeFromKey(&index_key, key, key_schema_);
 
-  bool status = container_.Insert(index_key, row_id, txn);
-  free(index_key);
+  bool status = container_.Insert(&index_key, row_id, txn);
   //  TreeFileManagers mgr("tree_");
   //  static int i = 0;
   //  if (i % 10 == 0) container_.PrintTree(mgr[i]);
@@ -26,71 +31,82 @@ dberr_t BPlusTreeIndex::InsertEntry(const Row &key, RowId row_id, Txn *txn) {
   return DB_SUCCESS;
 }
 
-dberr_t BPlusTreeIndex::RemoveEntry(const Row &key, RowId row_id, Txn *txn) {
-  GenericKey *index_key = processor_.InitKey();
-  processor_.SerializeFromKey(index_key, key, key_schema_);
+INDEX_TEMPLATE_ARGUMENTS
+dberr_t BPLUSTREE_INDEX_TYPE::RemoveEntry(const Row &key, RowId row_id, Txn *txn) {
+  KeyType index_key;
+  processor_.SerializeFromKey(&index_key, key, key_schema_);
 
-  container_.Remove(index_key, txn);
-  free(index_key);
+  container_.Remove(&index_key, txn);
   return DB_SUCCESS;
 }
 
-dberr_t BPlusTreeIndex::ScanKey(const Row &key, vector<RowId> &result, Txn *txn, string compare_operator) {
-  GenericKey *index_key = processor_.InitKey();
-  processor_.SerializeFromKey(index_key, key, key_schema_);
+INDEX_TEMPLATE_ARGUMENTS
+dberr_t BPLUSTREE_INDEX_TYPE::ScanKey(const Row &key, vector<RowId> &result, Txn *txn, string compare_operator) {
+  KeyType index_key;
+  processor_.SerializeFromKey(&index_key, key, key_schema_);
   auto end_iter = GetEndIterator();
   if (compare_operator == "=") {
-    container_.GetValue(index_key, result, txn);
+    container_.GetValue(&index_key, result, txn);
   } else if (compare_operator == ">") {
-    auto iter = GetBeginIterator(index_key);
-    if (container_.GetValue(index_key, result, txn)) ++iter;
+    auto iter = GetBeginIterator(&index_key);
+    if (container_.GetValue(&index_key, result, txn)) ++iter;
     result.clear();
     for (; iter != end_iter; ++iter) {
       result.emplace_back((*iter).second);
     }
   } else if (compare_operator == ">=") {
-    for (auto iter = GetBeginIterator(index_key); iter != end_iter; ++iter) {
+    for (auto iter = GetBeginIterator(&index_key); iter != end_iter; ++iter) {
       result.emplace_back((*iter).second);
     }
   } else if (compare_operator == "<") {
-    auto stop_iter = GetBeginIterator(index_key);
+    auto stop_iter = GetBeginIterator(&index_key);
     for (auto iter = GetBeginIterator(); iter != stop_iter; ++iter) {
       result.emplace_back((*iter).second);
     }
   } else if (compare_operator == "<=") {
-    auto stop_iter = GetBeginIterator(index_key);
+    auto stop_iter = GetBeginIterator(&index_key);
     for (auto iter = GetBeginIterator(); iter != stop_iter; ++iter) {
       result.emplace_back((*iter).second);
     }
-    container_.GetValue(index_key, result, txn);
+    container_.GetValue(&index_key, result, txn);
   } else if (compare_operator == "<>") {
     for (auto iter = GetBeginIterator(); iter != end_iter; ++iter) {
       result.emplace_back((*iter).second);
     }
     vector<RowId> temp;
-    if (container_.GetValue(index_key, temp, txn))
+    if (container_.GetValue(&index_key, temp, txn))
       result.erase(find(result.begin(), result.end(), temp[0]));
   }
-  free(index_key);
   if (!result.empty())
     return DB_SUCCESS;
   else
     return DB_KEY_NOT_FOUND;
 }
 
-dberr_t BPlusTreeIndex::Destroy() {
+INDEX_TEMPLATE_ARGUMENTS
+dberr_t BPLUSTREE_INDEX_TYPE::Destroy() {
   container_.Destroy();
   return DB_SUCCESS;
 }
 
-IndexIterator BPlusTreeIndex::GetBeginIterator() {
+INDEX_TEMPLATE_ARGUMENTS
+IndexIterator<KeySize> BPLUSTREE_INDEX_TYPE::GetBeginIterator() {
   return container_.Begin();
 }
 
-IndexIterator BPlusTreeIndex::GetBeginIterator(GenericKey *key) {
+INDEX_TEMPLATE_ARGUMENTS
+IndexIterator<KeySize> BPLUSTREE_INDEX_TYPE::GetBeginIterator(KeyType *key) {
   return container_.Begin(key);
 }
 
-IndexIterator BPlusTreeIndex::GetEndIterator() {
+INDEX_TEMPLATE_ARGUMENTS
+IndexIterator<KeySize> BPLUSTREE_INDEX_TYPE::GetEndIterator() {
   return container_.End();
-}
\ No newline at end of file
+}
+
+template class BPlusTreeIndex<8>;
+template class BPlusTreeIndex<16>;
+template class BPlusTreeIndex<32>;
+template class BPlusTreeIndex<64>;
+template class BPlusTreeIndex<128>;
+template class BPlusTreeIndex<256>;
@@ -3,9 +3,13 @@
 #include "index/basic_comparator.h"
 #include "index/generic_key.h"
 
-IndexIterator::IndexIterator() = default;
+#define INDEX_ITERATOR_TYPE IndexIterator<KeySize>
 
-IndexIterator::IndexIterator(page_id_t page_id, BufferPoolManager *bpm, int index)
+INDEX_TEMPLATE_ARGUMENTS
+INDEX_ITERATOR_TYPE::IndexIterator() = default;
+
+INDEX_TEMPLATE_ARGUMENTS
+INDEX_ITERATOR_TYPE::IndexIterator(page_id_t page_id, BufferPoolManager *bpm, int index)
     : current_page_id(page_id), item_index(index), buffer_pool_manager(bpm) {
   if(current_page_id == INVALID_PAGE_ID){
     page = nullptr;
@@ -14,17 +18,20 @@ IndexIterator::IndexIterator(page_id_t page_id, BufferPoolManager *bpm, int inde
   }
 }
 
-IndexIterator::~IndexIterator() {
+INDEX_TEMPLATE_ARGUMENTS
+INDEX_ITERATOR_TYPE::~IndexIterator() {
   if(current_page_id != INVALID_PAGE_ID){
     buffer_pool_manager->UnpinPage(current_page_id, false);
   }
 }
 
-std::pair<GenericKey *, RowId> IndexIterator::operator*() {
+INDEX_TEMPLATE_ARGUMENTS
+std::pair<GenericKey<KeySize> *, RowId> INDEX_ITERATOR_TYPE::operator*() {
   return std::make_pair(page->KeyAt(item_index), page->ValueAt(item_index));
 }
 
-IndexIterator &IndexIterator::operator++() {
+INDEX_TEMPLATE_ARGUMENTS
+INDEX_ITERATOR_TYPE &INDEX_ITERATOR_TYPE::operator++() {
   if(item_index == (page->GetSize() - 1)){
     page_id_t next_page_id = page->GetNextPageId();
     buffer_pool_manager->UnpinPage(current_page_id, false);
@@ -32,7 +39,7 @@ IndexIterator &IndexIterator::operator++() {
     if(current_page_id == INVALID_PAGE_ID){
       page = nullptr;
     }else{
-      page = reinterpret_cast<LeafPage *>(buffer_pool_manager->FetchPage(current_page_id));
+      page = reinterpret_cast<LeafPage *>(buffer_pool_manager->FetchPage(current_page_id)->GetData());
     }
     item_index = 0;
   }else{
@@ -41,10 +48,19 @@ IndexIterator &IndexIterator::operator++() {
   return *this;
 }
 
-bool IndexIterator::operator==(const IndexIterator &itr) const {
+INDEX_TEMPLATE_ARGUMENTS
+bool INDEX_ITERATOR_TYPE::operator==(const IndexIterator &itr) const {
   return current_page_id == itr.current_page_id && item_index == itr.item_index;
 }
 
-bool IndexIterator::operator!=(const IndexIterator &itr) const {
+INDEX_TEMPLATE_ARGUMENTS
+bool INDEX_ITERATOR_TYPE::operator!=(const IndexIterator &itr) const {
   return !(*this == itr);
 }
+
+template class IndexIterator<8>;
+template class IndexIterator<16>;
+template class IndexIterator<32>;
+template class IndexIterator<64>;
+template class IndexIterator<128>;
+template class IndexIterator<256>;
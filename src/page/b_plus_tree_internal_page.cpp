@@ -2,10 +2,11 @@
 
 #include "index/generic_key.h"
 
+#define INTERNAL_PAGE_TYPE BPlusTreeInternalPage<KeySize>
 #define pairs_off (data_)//节点有效数据的起始位置
-#define pair_size (GetKeySize() + sizeof(page_id_t))
+#define pair_size (KeySize + sizeof(page_id_t))
 #define key_off 0
-#define val_off GetKeySize()
+#define val_off KeySize
 
 /**
  * TODO: Student Implement
@@ -18,9 +19,10 @@
  * Including set page type, set current size, set page id, set parent id and set
  * max page size
  */
-void InternalPage::Init(page_id_t page_id, page_id_t parent_id, int key_size, int max_size) {
+INDEX_TEMPLATE_ARGUMENTS
+void INTERNAL_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id, int max_size) {
   SetPageType(IndexPageType::INTERNAL_PAGE);
-  SetKeySize(key_size);
+  SetKeySize(KeySize);
   SetSize(0);//目前还没有任何KEY-PAGE_ID对
   SetPageId(page_id);
   SetParentPageId(parent_id);
@@ -30,23 +32,28 @@ void InternalPage::Init(page_id_t page_id, page_id_t parent_id, int key_size, in
  * Helper method to get/set the key associated with input "index"(a.k.a
  * array offset)
  */
-GenericKey *InternalPage::KeyAt(int index) {//得到内部节点的第index（从0开始）号属性
-  return reinterpret_cast<GenericKey *>(pairs_off + index * pair_size + key_off);
+INDEX_TEMPLATE_ARGUMENTS
+GenericKey<KeySize> *INTERNAL_PAGE_TYPE::KeyAt(int index) {//得到内部节点的第index（从0开始）号属性
+  return reinterpret_cast<KeyType *>(pairs_off + index * pair_size + key_off);
 }
 
-void InternalPage::SetKeyAt(int index, GenericKey *key) {//修改内部节点的第index（从0开始）号属性
-  memcpy(pairs_off + index * pair_size + key_off, key, GetKeySize());
+INDEX_TEMPLATE_ARGUMENTS
+void INTERNAL_PAGE_TYPE::SetKeyAt(int index, KeyType *key) {//修改内部节点的第index（从0开始）号属性
+  memcpy(pairs_off + index * pair_size + key_off, key, KeySize);
 }
 
-page_id_t InternalPage::ValueAt(int index) const {//得到内部节点的第index（从0开始）号孩子页号
+INDEX_TEMPLATE_ARGUMENTS
+page_id_t INTERNAL_PAGE_TYPE::ValueAt(int index) const {//得到内部节点的第index（从0开始）号孩子页号
   return *reinterpret_cast<const page_id_t *>(pairs_off + index * pair_size + val_off);
 }
 
-void InternalPage::SetValueAt(int index, page_id_t value) {//修改内部节点的第index（从0开始）号孩子页号
+INDEX_TEMPLATE_ARGUMENTS
+void INTERNAL_PAGE_TYPE::SetValueAt(int index, page_id_t value) {//修改内部节点的第index（从0开始）号孩子页号
   *reinterpret_cast<page_id_t *>(pairs_off + index * pair_size + val_off) = value;
 }
 
-int InternalPage::ValueIndex(const page_id_t &value) const {
+INDEX_TEMPLATE_ARGUMENTS
+int INTERNAL_PAGE_TYPE::ValueIndex(const page_id_t &value) const {
   for (int i = 0; i < GetSize(); ++i) {//找出该孩子页号是该内部节点中的第几号（从0开始）
     if (ValueAt(i) == value)
       return i;
@@ -54,12 +61,14 @@ int InternalPage::ValueIndex(const page_id_t &value) const {
   return -1;
 }
 
-void *InternalPage::PairPtrAt(int index) {
+INDEX_TEMPLATE_ARGUMENTS
+void *INTERNAL_PAGE_TYPE::PairPtrAt(int index) {
   return KeyAt(index);
 }
 
-void InternalPage::PairCopy(void *dest, void *src, int pair_num) {//从src到dest
-  memcpy(dest, src, pair_num * (GetKeySize() + sizeof(page_id_t)));
+INDEX_TEMPLATE_ARGUMENTS
+void INTERNAL_PAGE_TYPE::PairCopy(void *dest, void *src, int pair_num) {//从src到dest
+  memcpy(dest, src, pair_num * pair_size);
 }
 /*****************************************************************************
  * LOOKUP
@@ -70,7 +79,8 @@ void InternalPage::PairCopy(void *dest, void *src, int pair_num) {//从src到des
  * Start the search from the second key(the first key should always be invalid)
  * 用了二分查找
  */
-page_id_t InternalPage::Lookup(const GenericKey *key, const KeyManager &KM) {
+INDEX_TEMPLATE_ARGUMENTS
+page_id_t INTERNAL_PAGE_TYPE::Lookup(const KeyType *key, const KeyManager &KM) {
   int left = 1;
   int right = GetSize() - 1;
   int mid = 0;
@@ -100,7 +110,8 @@ page_id_t InternalPage::Lookup(const GenericKey *key, const KeyManager &KM) {
  * page, you should create a new root page and populate its elements.
  * NOTE: This method is only called within InsertIntoParent()(b_plus_tree.cpp)
  */
-void InternalPage::PopulateNewRoot(const page_id_t &old_value, GenericKey *new_key, const page_id_t &new_value) {
+INDEX_TEMPLATE_ARGUMENTS
+void INTERNAL_PAGE_TYPE::PopulateNewRoot(const page_id_t &old_value, KeyType *new_key, const page_id_t &new_value) {
   //填充新根
   //只在老根溢出须创建新根时调用
   SetSize(2);//现在有两个K-V对
@@ -114,10 +125,11 @@ void InternalPage::PopulateNewRoot(const page_id_t &old_value, GenericKey *new_k
  * old_value
  * @return:  new size after insertion
  */
-int InternalPage::InsertNodeAfter(const page_id_t &old_value, GenericKey *new_key, const page_id_t &new_value) {
+INDEX_TEMPLATE_ARGUMENTS
+int INTERNAL_PAGE_TYPE::InsertNodeAfter(const page_id_t &old_value, KeyType *new_key, const page_id_t &new_value) {
   int tmp_size = GetSize();
   int tmp_index = ValueIndex(old_value);
-  GenericKey* tmp_key = nullptr;
+  KeyType *tmp_key = nullptr;
   page_id_t tmp_value = 0;
   for(int i = tmp_size - 1; i > tmp_index; i--){//逐个后移
     tmp_key = KeyAt(i);
@@ -139,7 +151,8 @@ int InternalPage::InsertNodeAfter(const page_id_t &old_value, GenericKey *new_ke
  * Remove half of key & value pairs from this page to "recipient" page
  * buffer_pool_manager 是干嘛的？传给CopyNFrom()用于Fetch数据页
  */
-void InternalPage::MoveHalfTo(InternalPage *recipient, BufferPoolManager *buffer_pool_manager) {
+INDEX_TEMPLATE_ARGUMENTS
+void INTERNAL_PAGE_TYPE::MoveHalfTo(BPlusTreeInternalPage *recipient, BufferPoolManager *buffer_pool_manager) {
   int tmp_size = GetSize();
   int tmp_num = tmp_size / 2;
   int tmp_start = 0;
@@ -157,7 +170,8 @@ void InternalPage::MoveHalfTo(InternalPage *recipient, BufferPoolManager *buffer
  * So I need to 'adopt' them by changing their parent page id, which needs to be persisted with BufferPoolManger
  *
  */
-void InternalPage::CopyNFrom(void *src, int size, BufferPoolManager *buffer_pool_manager) {
+INDEX_TEMPLATE_ARGUMENTS
+void INTERNAL_PAGE_TYPE::CopyNFrom(void *src, int size, BufferPoolManager *buffer_pool_manager) {
   //谁调用就copy到谁那里
   int next_pos_index = GetSize();
   PairCopy(PairPtrAt(next_pos_index), src, size);//包括src
@@ -182,9 +196,10 @@ void InternalPage::CopyNFrom(void *src, int size, BufferPoolManager *buffer_pool
  * array offset)
  * NOTE: store key&value pair continuously after deletion
  */
-void InternalPage::Remove(int index) {
+INDEX_TEMPLATE_ARGUMENTS
+void INTERNAL_PAGE_TYPE::Remove(int index) {
   int tmp_size = GetSize();
-  GenericKey* tmp_key = nullptr;
+  KeyType *tmp_key = nullptr;
   page_id_t tmp_value = 0;
   if(index >= 0 && index < tmp_size){//判断边界条件
     for(int i = index; i < tmp_size - 1; i ++){//逐个前移
@@ -201,7 +216,8 @@ void InternalPage::Remove(int index) {
  * Remove the only key & value pair in internal page and return the value
  * NOTE: only call this method within AdjustRoot()(in b_plus_tree.cpp)
  */
-page_id_t InternalPage::RemoveAndReturnOnlyChild() {
+INDEX_TEMPLATE_ARGUMENTS
+page_id_t INTERNAL_PAGE_TYPE::RemoveAndReturnOnlyChild() {
   page_id_t tmp_value = ValueAt(0);//得到唯一的孩子页号
   SetSize(0);
   return tmp_value;
@@ -217,7 +233,8 @@ page_id_t InternalPage::RemoveAndReturnOnlyChild() {
  * You also need to use BufferPoolManager to persist changes to the parent page id for those
  * pages that are moved to the recipient
  */
-void InternalPage::MoveAllTo(InternalPage *recipient, GenericKey *middle_key, BufferPoolManager *buffer_pool_manager) {
+INDEX_TEMPLATE_ARGUMENTS
+void INTERNAL_PAGE_TYPE::MoveAllTo(BPlusTreeInternalPage *recipient, KeyType *middle_key, BufferPoolManager *buffer_pool_manager) {
   //本函数不负责维护父节点
   SetKeyAt(0, middle_key);//把我的第0号无效Key设为middle key
   int tmp_size = this->GetSize();//我的K-V对数
@@ -236,7 +253,8 @@ void InternalPage::MoveAllTo(InternalPage *recipient, GenericKey *middle_key, Bu
  * You also need to use BufferPoolManager to persist changes to the parent page id for those
  * pages that are moved to the recipient
  */
-void InternalPage::MoveFirstToEndOf(InternalPage *recipient, GenericKey *middle_key, BufferPoolManager *buffer_pool_manager) {
+INDEX_TEMPLATE_ARGUMENTS
+void INTERNAL_PAGE_TYPE::MoveFirstToEndOf(BPlusTreeInternalPage *recipient, KeyType *middle_key, BufferPoolManager *buffer_pool_manager) {
   //本函数不负责维护父节点
   SetKeyAt(0, middle_key);//把我的第0号无效Key设为middle key
   recipient->CopyNFrom(PairPtrAt(0), 1, buffer_pool_manager);
@@ -248,7 +266,8 @@ void InternalPage::MoveFirstToEndOf(InternalPage *recipient, GenericKey *middle_
  * Since it is an internal page, the moved entry(page)'s parent needs to be updated.
  * So I need to 'adopt' it by changing its parent page id, which needs to be persisted with BufferPoolManger
  */
-void InternalPage::CopyLastFrom(GenericKey *key, const page_id_t value, BufferPoolManager *buffer_pool_manager) {
+INDEX_TEMPLATE_ARGUMENTS
+void INTERNAL_PAGE_TYPE::CopyLastFrom(KeyType *key, const page_id_t value, BufferPoolManager *buffer_pool_manager) {
   int next_pos_index = GetSize();
   SetKeyAt(next_pos_index, key);
   SetValueAt(next_pos_index, value);
@@ -268,7 +287,8 @@ void InternalPage::CopyLastFrom(GenericKey *key, const page_id_t value, BufferPo
  * You also need to use BufferPoolManager to persist changes to the parent page id for those pages that are
  * moved to the recipient
  */
-void InternalPage::MoveLastToFrontOf(InternalPage *recipient, GenericKey *middle_key, BufferPoolManager *buffer_pool_manager) {
+INDEX_TEMPLATE_ARGUMENTS
+void INTERNAL_PAGE_TYPE::MoveLastToFrontOf(BPlusTreeInternalPage *recipient, KeyType *middle_key, BufferPoolManager *buffer_pool_manager) {
   //本函数不负责维护父节点
   int last_index = GetSize() - 1;
   recipient->SetKeyAt(0, middle_key);//把我的第0号无效Key设为middle key
@@ -282,9 +302,10 @@ void InternalPage::MoveLastToFrontOf(InternalPage *recipient, GenericKey *middle
  * Since it is an internal page, the moved entry(page)'s parent needs to be updated.
  * So I need to 'adopt' it by changing its parent page id, which needs to be persisted with BufferPoolManger
  */
-void InternalPage::CopyFirstFrom(const page_id_t value, BufferPoolManager *buffer_pool_manager) {
+INDEX_TEMPLATE_ARGUMENTS
+void INTERNAL_PAGE_TYPE::CopyFirstFrom(const page_id_t value, BufferPoolManager *buffer_pool_manager) {
   int tmp_size = GetSize();
-  GenericKey* tmp_key = nullptr;
+  KeyType *tmp_key = nullptr;
   page_id_t tmp_value = 0;
   for(int i = tmp_size - 1; i >= 0; i--){//逐个后移
     tmp_key = KeyAt(i);
@@ -301,3 +322,10 @@ void InternalPage::CopyFirstFrom(const page_id_t value, BufferPoolManager *buffe
   }
   IncreaseSize(1);
 }
+
+template class BPlusTreeInternalPage<8>;
+template class BPlusTreeInternalPage<16>;
+template class BPlusTreeInternalPage<32>;
+template class BPlusTreeInternalPage<64>;
+template class BPlusTreeInternalPage<128>;
+template class BPlusTreeInternalPage<256>;
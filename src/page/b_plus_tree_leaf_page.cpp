@@ -4,10 +4,11 @@
 
 #include "index/generic_key.h"
 
+#define LEAF_PAGE_TYPE BPlusTreeLeafPage<KeySize>
 #define pairs_off (data_)
-#define pair_size (GetKeySize() + sizeof(RowId))
+#define pair_size (KeySize + sizeof(RowId))
 #define key_off 0
-#define val_off GetKeySize()
+#define val_off KeySize
 /*****************************************************************************
  * HELPER METHODS AND UTILITIES
  *****************************************************************************/
@@ -21,11 +22,12 @@
  * next page id and set max size
  * 未初始化next_page_id
  */
-void LeafPage::Init(page_id_t page_id, page_id_t parent_id, int key_size, int max_size) {
+INDEX_TEMPLATE_ARGUMENTS
+void LEAF_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id, int max_size) {
   SetPageId(page_id);
   SetParentPageId(parent_id);
   SetMaxSize(max_size);
-  SetKeySize(key_size);
+  SetKeySize(KeySize);
   SetSize(0);
   SetPageType(IndexPageType :: LEAF_PAGE);
   SetNextPageId(INVALID_PAGE_ID);
@@ -34,11 +36,13 @@ void LeafPage::Init(page_id_t page_id, page_id_t parent_id, int key_size, int ma
 /**
  * Helper methods to set/get next page id
  */
-page_id_t LeafPage::GetNextPageId() const {
+INDEX_TEMPLATE_ARGUMENTS
+page_id_t LEAF_PAGE_TYPE::GetNextPageId() const {
   return next_page_id_;
 }
 
-void LeafPage::SetNextPageId(page_id_t next_page_id) {
+INDEX_TEMPLATE_ARGUMENTS
+void LEAF_PAGE_TYPE::SetNextPageId(page_id_t next_page_id) {
   next_page_id_ = next_page_id;
   if (next_page_id == 0) {
     LOG(INFO) << "Fatal error";
@@ -53,7 +57,8 @@ void LeafPage::SetNextPageId(page_id_t next_page_id) {
  * NOTE: This method is only used when generating index iterator
  * 二分查找
  */
-int LeafPage::KeyIndex(const GenericKey *key, const KeyManager &KM) {
+INDEX_TEMPLATE_ARGUMENTS
+int LEAF_PAGE_TYPE::KeyIndex(const KeyType *key, const KeyManager &KM) {
   //返回第一个Key大于等于传入key的位置（从0开始）
   int left = 0;
   int right = GetSize() - 1;
@@ -79,34 +84,41 @@ int LeafPage::KeyIndex(const GenericKey *key, const KeyManager &KM) {
  * Helper method to find and return the key associated with input "index"(a.k.a
  * array offset)
  */
-GenericKey *LeafPage::KeyAt(int index) {
-  return reinterpret_cast<GenericKey *>(pairs_off + index * pair_size + key_off);
+INDEX_TEMPLATE_ARGUMENTS
+GenericKey<KeySize> *LEAF_PAGE_TYPE::KeyAt(int index) {
+  return reinterpret_cast<KeyType *>(pairs_off + index * pair_size + key_off);
 }
 
-void LeafPage::SetKeyAt(int index, GenericKey *key) {
-  memcpy(pairs_off + index * pair_size + key_off, key, GetKeySize());
+INDEX_TEMPLATE_ARGUMENTS
+void LEAF_PAGE_TYPE::SetKeyAt(int index, KeyType *key) {
+  memcpy(pairs_off + index * pair_size + key_off, key, KeySize);
 }
 
-RowId LeafPage::ValueAt(int index) const {
+INDEX_TEMPLATE_ARGUMENTS
+RowId LEAF_PAGE_TYPE::ValueAt(int index) const {
   return *reinterpret_cast<const RowId *>(pairs_off + index * pair_size + val_off);
 }
 
-void LeafPage::SetValueAt(int index, RowId value) {
+INDEX_TEMPLATE_ARGUMENTS
+void LEAF_PAGE_TYPE::SetValueAt(int index, RowId value) {
   *reinterpret_cast<RowId *>(pairs_off + index * pair_size + val_off) = value;
 }
 
-void *LeafPage::PairPtrAt(int index) {
+INDEX_TEMPLATE_ARGUMENTS
+void *LEAF_PAGE_TYPE::PairPtrAt(int index) {
   return KeyAt(index);
 }
 
-void LeafPage::PairCopy(void *dest, void *src, int pair_num) {
-  memcpy(dest, src, pair_num * (GetKeySize() + sizeof(RowId)));
+INDEX_TEMPLATE_ARGUMENTS
+void LEAF_PAGE_TYPE::PairCopy(void *dest, void *src, int pair_num) {
+  memcpy(dest, src, pair_num * pair_size);
 }
 /*
  * Helper method to find and return the key & value pair associated with input
  * "index"(a.k.a. array offset)
  */
-std::pair<GenericKey *, RowId> LeafPage::GetItem(int index) { return {KeyAt(index), ValueAt(index)}; }
+INDEX_TEMPLATE_ARGUMENTS
+std::pair<GenericKey<KeySize> *, RowId> LEAF_PAGE_TYPE::GetItem(int index) { return {KeyAt(index), ValueAt(index)}; }
 
 /*****************************************************************************
  * INSERTION
@@ -115,7 +127,8 @@ std::pair<GenericKey *, RowId> LeafPage::GetItem(int index) { return {KeyAt(inde
  * Insert key & value pair into leaf page ordered by key
  * @return page size after insertion
  */
-int LeafPage::Insert(GenericKey *key, const RowId &value, const KeyManager &KM) {
+INDEX_TEMPLATE_ARGUMENTS
+int LEAF_PAGE_TYPE::Insert(KeyType *key, const RowId &value, const KeyManager &KM) {
   int tmp_size = GetSize();
   int target_index = KeyIndex(key, KM);//找到第一个
   if(target_index == -1){
@@ -141,7 +154,8 @@ int LeafPage::Insert(GenericKey *key, const RowId &value, const KeyManager &KM)
 /*
  * Remove half of key & value pairs from this page to "recipient" page
  */
-void LeafPage::MoveHalfTo(LeafPage *recipient) {
+INDEX_TEMPLATE_ARGUMENTS
+void LEAF_PAGE_TYPE::MoveHalfTo(BPlusTreeLeafPage *recipient) {
   int tmp_size = GetSize();
   int tmp_num = tmp_size / 2;
   int tmp_start = 0;
@@ -157,7 +171,8 @@ void LeafPage::MoveHalfTo(LeafPage *recipient) {
 /*
  * Copy starting from items, and copy {size} number of elements into me.
  */
-void LeafPage::CopyNFrom(void *src, int size) {
+INDEX_TEMPLATE_ARGUMENTS
+void LEAF_PAGE_TYPE::CopyNFrom(void *src, int size) {
   //谁调用就copy到谁那里
   int next_pos_index = GetSize();//下一个可放的位置
   PairCopy(PairPtrAt(next_pos_index), src, size);//包括src
@@ -172,7 +187,8 @@ void LeafPage::CopyNFrom(void *src, int size) {
  * does, then store its corresponding value in input "value" and return true.
  * If the key does not exist, then return false
  */
-bool LeafPage::Lookup(const GenericKey *key, RowId &value, const KeyManager &KM) {
+INDEX_TEMPLATE_ARGUMENTS
+bool LEAF_PAGE_TYPE::Lookup(const KeyType *key, RowId &value, const KeyManager &KM) {
   //此时的value指RowId
   int left = 0;
   int right = GetSize() - 1;
@@ -202,7 +218,8 @@ bool LeafPage::Lookup(const GenericKey *key, RowId &value, const KeyManager &KM)
  * NOTE: store key&value pair continuously after deletion
  * @return  page size after deletion
  */
-int LeafPage::RemoveAndDeleteRecord(const GenericKey *key, const KeyManager &KM) {
+INDEX_TEMPLATE_ARGUMENTS
+int LEAF_PAGE_TYPE::RemoveAndDeleteRecord(const KeyType *key, const KeyManager &KM) {
   int tmp_size = GetSize();
   int left = 0;
   int right = tmp_size - 1;
@@ -237,7 +254,8 @@ int LeafPage::RemoveAndDeleteRecord(const GenericKey *key, const KeyManager &KM)
  * Remove all key & value pairs from this page to "recipient" page. Don't forget
  * to update the next_page id in the sibling page
  */
-void LeafPage::MoveAllTo(LeafPage *recipient) {
+INDEX_TEMPLATE_ARGUMENTS
+void LEAF_PAGE_TYPE::MoveAllTo(BPlusTreeLeafPage *recipient) {
   recipient->CopyNFrom(PairPtrAt(0), GetSize());//src是我
   recipient->SetNextPageId(GetNextPageId());//更新接收方的NextPageId
   SetSize(0);//把我的size设为0
@@ -250,7 +268,8 @@ void LeafPage::MoveAllTo(LeafPage *recipient) {
  * Remove the first key & value pair from this page to "recipient" page.
  *
  */
-void LeafPage::MoveFirstToEndOf(LeafPage *recipient) {
+INDEX_TEMPLATE_ARGUMENTS
+void LEAF_PAGE_TYPE::MoveFirstToEndOf(BPlusTreeLeafPage *recipient) {
   int tmp_size = GetSize();
   recipient->CopyLastFrom(KeyAt(0), ValueAt(0));
   PairCopy(PairPtrAt(0), PairPtrAt(1), tmp_size - 1);//逐个前移，相当于删除第一个键值对
@@ -260,7 +279,8 @@ void LeafPage::MoveFirstToEndOf(LeafPage *recipient) {
 /*
  * Copy the item into the end of my item list. (Append item to my array)
  */
-void LeafPage::CopyLastFrom(GenericKey *key, const RowId value) {
+INDEX_TEMPLATE_ARGUMENTS
+void LEAF_PAGE_TYPE::CopyLastFrom(KeyType *key, const RowId value) {
   int tmp_size = GetSize();
   SetKeyAt(tmp_size, key);
   SetValueAt(tmp_size, value);
@@ -270,7 +290,8 @@ void LeafPage::CopyLastFrom(GenericKey *key, const RowId value) {
 /*
  * Remove the last key & value pair from this page to "recipient" page.
  */
-void LeafPage::MoveLastToFrontOf(LeafPage *recipient) {
+INDEX_TEMPLATE_ARGUMENTS
+void LEAF_PAGE_TYPE::MoveLastToFrontOf(BPlusTreeLeafPage *recipient) {
   int tmp_size = GetSize();
   recipient->CopyFirstFrom(KeyAt(tmp_size - 1), ValueAt(tmp_size - 1));
   SetSize(tmp_size - 1);
@@ -280,10 +301,18 @@ void LeafPage::MoveLastToFrontOf(LeafPage *recipient) {
  * Insert item at the front of my items. Move items accordingly.
  *
  */
-void LeafPage::CopyFirstFrom(GenericKey *key, const RowId value) {
+INDEX_TEMPLATE_ARGUMENTS
+void LEAF_PAGE_TYPE::CopyFirstFrom(KeyType *key, const RowId value) {
   int tmp_size = GetSize();
   PairCopy(PairPtrAt(1), PairPtrAt(0), tmp_size);//逐个后移，空出第0号位置
   SetKeyAt(0, key);
   SetValueAt(0, value);
   SetSize(tmp_size + 1);
 }
+
+template class BPlusTreeLeafPage<8>;
+template class BPlusTreeLeafPage<16>;
+template class BPlusTreeLeafPage<32>;
+template class BPlusTreeLeafPage<64>;
+template class BPlusTreeLeafPage<128>;
+template class BPlusTreeLeafPage<256>;
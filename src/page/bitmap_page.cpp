@@ -1,5 +1,11 @@
 #include "page/bitmap_page.h"
 
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+#include <cstring>
+
 #include "glog/logging.h"
 
 /**
@@ -11,29 +17,45 @@ bool BitmapPage<PageSize>::AllocatePage(uint32_t &page_offset) {
   if (page_allocated_ == GetMaxSupportedSize()) {
     return false;
   }
-  page_offset = next_free_page_;
-  if(!IsPageFree(page_offset) || page_offset >= GetMaxSupportedSize()) {
+  page_offset = FindFirst(next_free_page_, true);
+  if (page_offset >= GetMaxSupportedSize()) {
     return false;
   }
-  // Mark the page as allocated
-  SetPageAllocated(next_free_page_);
+  // Mark the page as allocated, the next free page is searched for by the next allocation
+  SetPageAllocated(page_offset);
   page_allocated_++;
-  // Find the next free page
-  bool flag = false;
-  for (uint32_t i = next_free_page_ + 1; i < GetMaxSupportedSize(); i++) {
-    if (IsPageFree(i)) {
-      flag = true;
-      next_free_page_ = i;
-      return true;
-    }
-  }
-  if (!flag) {
-    // If no free page is found, set next_free_page_ to the maximum value (8 * MAX_CHARS
-    next_free_page_ = GetMaxSupportedSize();
+  next_free_page_ = page_offset + 1;
+  return true;
+}
+
+template <size_t PageSize>
+bool BitmapPage<PageSize>::AllocatePages(uint32_t n, uint32_t *page_offsets) {
+  if (n == 0) {
     return true;
-  } else {
+  }
+  if (page_allocated_ + n > GetMaxSupportedSize()) {
     return false;
   }
+  uint32_t start = FindFirst(next_free_page_, true);
+  bool first_hole = true;
+  while (start + n <= GetMaxSupportedSize()) {
+    // the run of free pages starting at start ends at the next allocated page
+    uint32_t end = FindFirst(start, false);
+    if (end - start >= n) {
+      for (uint32_t i = 0; i < n; i++) {
+        SetPageAllocated(start + i);
+        page_offsets[i] = start + i;
+      }
+      page_allocated_ += n;
+      if (first_hole) {
+        next_free_page_ = start + n;
+      }
+      return true;
+    }
+    start = FindFirst(end, true);
+    first_hole = false;
+  }
+  return false;
 }
 
 /**
@@ -73,6 +95,48 @@ bool BitmapPage<PageSize>::IsPageFreeLow(uint32_t byte_index, uint8_t bit_index)
   return (bytes[byte_index] & (1 << (7 - bit_index))) == 0;
 }
 
+template <size_t PageSize>
+uint64_t BitmapPage<PageSize>::LoadWord(uint32_t word_index) const {
+  uint64_t word;
+  memcpy(&word, bytes + word_index * sizeof(uint64_t), sizeof(uint64_t));
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  // the first page of a byte is its most significant bit, swapping the bytes makes it hold for the whole word
+  word = __builtin_bswap64(word);
+#endif
+  return word;
+}
+
+template <size_t PageSize>
+uint32_t BitmapPage<PageSize>::FindFirst(uint32_t from, bool free) const {
+  if (from >= GetMaxSupportedSize()) {
+    return GetMaxSupportedSize();
+  }
+  uint32_t word_index = from / 64;
+  // bits of the word are set for the pages looked for, the pages before from are masked out
+  uint64_t word = (free ? ~LoadWord(word_index) : LoadWord(word_index)) & (~uint64_t{0} >> (from % 64));
+  while (word == 0) {
+    word_index++;
+#ifdef __AVX2__
+    // skip fully allocated runs of 256 pages at once
+    if (free) {
+      const __m256i full = _mm256_set1_epi8(-1);
+      while (word_index + 4 <= NUM_WORDS) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(bytes + word_index * sizeof(uint64_t)));
+        if (_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, full)) != -1) {
+          break;
+        }
+        word_index += 4;
+      }
+    }
+#endif
+    if (word_index >= NUM_WORDS) {
+      return GetMaxSupportedSize();
+    }
+    word = free ? ~LoadWord(word_index) : LoadWord(word_index);
+  }
+  return word_index * 64 + __builtin_clzll(word);
+}
+
 template <size_t PageSize>
 bool BitmapPage<PageSize>::SetPageAllocated(uint32_t page_offset) {
   // Set the bit to 1
@@ -99,4 +163,10 @@ template class BitmapPage<1024>;
 
 template class BitmapPage<2048>;
 
-template class BitmapPage<4096>;
\ No newline at end of file
+template class BitmapPage<4096>;
+
+template class BitmapPage<8192>;
+
+template class BitmapPage<16384>;
+
+template class BitmapPage<32768>;
\ No newline at end of file
@@ -8,36 +8,38 @@ void TablePage::Init(page_id_t page_id, page_id_t prev_id, LogManager *log_mgr,
   SetNextPageId(INVALID_PAGE_ID);
   SetFreeSpacePointer(PAGE_SIZE);
   SetTupleCount(0);
+  SetFreeSlot(INVALID_SLOT);
+  SetDeadSpace(0);
 }
 
 bool TablePage::InsertTuple(Row &row, Schema *schema, Txn *txn, LockManager *lock_manager, LogManager *log_manager) {
   uint32_t serialized_size = row.GetSerializedSize(schema);
   ASSERT(serialized_size > 0, "Can not have empty row.");
-  if (GetFreeSpaceRemaining() < serialized_size + SIZE_TUPLE) {
+  // Reuse the slot of a deleted tuple if there is one, otherwise the slot array grows.
+  uint32_t slot_num = GetFreeSlot();
+  uint32_t needed_size = serialized_size + (slot_num == INVALID_SLOT ? SIZE_TUPLE : 0);
+  if (GetFreeSpaceRemaining() < needed_size) {
     return false;
   }
-  // Try to find a free slot to reuse.
-  uint32_t i;
-  for (i = 0; i < GetTupleCount(); i++) {
-    // If the slot is empty, i.e. its tuple has size 0,
-    if (GetTupleSize(i) == 0) {
-      // Then we break out of the loop at index i.
-      break;
-    }
+  if (GetContiguousFreeSpace() < needed_size) {
+    Compact();
+  }
+  if (slot_num == INVALID_SLOT) {
+    slot_num = GetTupleCount();
+    SetTupleCount(slot_num + 1);
+  } else {
+    SetFreeSlot(GetTupleOffsetAtSlot(slot_num));
   }
-  // Otherwise we claim available free space..
+  // Claim available free space.
   SetFreeSpacePointer(GetFreeSpacePointer() - serialized_size);
   uint32_t __attribute__((unused)) write_bytes = row.SerializeTo(GetData() + GetFreeSpacePointer(), schema);
   ASSERT(write_bytes == serialized_size, "Unexpected behavior in row serialize.");
 
   // Set the tuple.
-  SetTupleOffsetAtSlot(i, GetFreeSpacePointer());
-  SetTupleSize(i, serialized_size);
+  SetTupleOffsetAtSlot(slot_num, GetFreeSpacePointer());
+  SetTupleSize(slot_num, serialized_size);
   // Set rid
-  row.SetRowId(RowId(GetTablePageId(), i));
-  if (i == GetTupleCount()) {
-    SetTupleCount(GetTupleCount() + 1);
-  }
+  row.SetRowId(RowId(GetTablePageId(), slot_num));
   return true;
 }
 
@@ -82,21 +84,23 @@ TablePage::UpdateStatus TablePage::UpdateTuple(Row &new_row, Row *old_row, Schem
   uint32_t tuple_offset = GetTupleOffsetAtSlot(slot_num);
   uint32_t __attribute__((unused)) read_bytes = old_row->DeserializeFrom(GetData() + tuple_offset, schema);
   ASSERT(tuple_size == read_bytes, "Unexpected behavior in tuple deserialize.");
-  uint32_t free_space_pointer = GetFreeSpacePointer();
-  ASSERT(tuple_offset >= free_space_pointer, "Offset should appear after current free space position.");
-  memmove(GetData() + free_space_pointer + tuple_size - serialized_size, GetData() + free_space_pointer,
-          tuple_offset - free_space_pointer);
-  SetFreeSpacePointer(free_space_pointer + tuple_size - serialized_size);
-  new_row.SerializeTo(GetData() + tuple_offset + tuple_size - serialized_size, schema);
-  SetTupleSize(slot_num, serialized_size);
-
-  // Update all tuple offsets.
-  for (uint32_t i = 0; i < GetTupleCount(); ++i) {
-    uint32_t tuple_offset_i = GetTupleOffsetAtSlot(i);
-    if (GetTupleSize(i) > 0 && tuple_offset_i < tuple_offset + tuple_size) {
-      SetTupleOffsetAtSlot(i, tuple_offset_i + tuple_size - new_row.GetSerializedSize(schema));
-    }
+  // A tuple that does not grow is overwritten in place, the bytes it shrinks by become dead space.
+  if (serialized_size <= tuple_size) {
+    new_row.SerializeTo(GetData() + tuple_offset, schema);
+    SetTupleSize(slot_num, serialized_size);
+    SetDeadSpace(GetDeadSpace() + tuple_size - serialized_size);
+    return UpdateStatus::updateSuccess;
   }
+  // Otherwise the old tuple becomes dead space and the new one is written to the free space.
+  SetTupleSize(slot_num, 0);
+  SetDeadSpace(GetDeadSpace() + tuple_size);
+  if (GetContiguousFreeSpace() < serialized_size) {
+    Compact();
+  }
+  SetFreeSpacePointer(GetFreeSpacePointer() - serialized_size);
+  new_row.SerializeTo(GetData() + GetFreeSpacePointer(), schema);
+  SetTupleOffsetAtSlot(slot_num, GetFreeSpacePointer());
+  SetTupleSize(slot_num, serialized_size);
   return UpdateStatus::updateSuccess;
 }
 
@@ -104,29 +108,103 @@ void TablePage::ApplyDelete(const RowId &rid, Txn *txn, LogManager *log_manager)
   uint32_t slot_num = rid.GetSlotNum();
   ASSERT(slot_num < GetTupleCount(), "Cannot have more slots than tuples.");
 
-  uint32_t tuple_offset = GetTupleOffsetAtSlot(slot_num);
   uint32_t tuple_size = GetTupleSize(slot_num);
+  // The slot is free already.
+  if (tuple_size == 0) {
+    return;
+  }
   // Check if this is a delete operation, i.e. commit a delete.
   if (IsDeleted(tuple_size)) {
     tuple_size = UnsetDeletedFlag(tuple_size);
   }
+  // The tuple stays where it is until the page is compacted, its slot goes to the free slot list.
+  SetDeadSpace(GetDeadSpace() + tuple_size);
+  SetTupleSize(slot_num, 0);
+  SetTupleOffsetAtSlot(slot_num, GetFreeSlot());
+  SetFreeSlot(slot_num);
+}
 
-  uint32_t free_space_pointer = GetFreeSpacePointer();
-  ASSERT(tuple_offset >= free_space_pointer, "Free space appears before tuples.");
+uint32_t TablePage::ApplyMarkedDeletes(Txn *txn, LogManager *log_manager) {
+  uint32_t deleted = 0;
+  for (uint32_t i = 0; i < GetTupleCount(); i++) {
+    uint32_t tuple_size = GetTupleSize(i);
+    if (tuple_size != 0 && IsDeleted(tuple_size)) {
+      ApplyDelete(RowId(GetTablePageId(), i), txn, log_manager);
+      deleted++;
+    }
+  }
+  return deleted;
+}
 
-  memmove(GetData() + free_space_pointer + tuple_size, GetData() + free_space_pointer,
-          tuple_offset - free_space_pointer);
-  SetFreeSpacePointer(free_space_pointer + tuple_size);
-  SetTupleSize(slot_num, 0);
-  SetTupleOffsetAtSlot(slot_num, 0);
+bool TablePage::IsEmpty() {
+  for (uint32_t i = 0; i < GetTupleCount(); i++) {
+    if (GetTupleSize(i) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
 
-  // Update all tuple offsets.
-  for (uint32_t i = 0; i < GetTupleCount(); ++i) {
-    uint32_t tuple_offset_i = GetTupleOffsetAtSlot(i);
-    if (GetTupleSize(i) != 0 && tuple_offset_i < tuple_offset) {
-      SetTupleOffsetAtSlot(i, tuple_offset_i + tuple_size);
+void TablePage::Compact() {
+  // without dead space the tuples are packed already
+  if (GetDeadSpace() == 0) {
+    return;
+  }
+  uint32_t free_space_pointer = GetFreeSpacePointer();
+  char tuples[PAGE_SIZE];
+  memcpy(tuples, GetData() + free_space_pointer, PAGE_SIZE - free_space_pointer);
+  uint32_t new_free_space_pointer = PAGE_SIZE;
+  for (uint32_t i = 0; i < GetTupleCount(); i++) {
+    uint32_t tuple_size = GetTupleSize(i);
+    // tuples marked deleted still hold their bytes
+    if (tuple_size == 0) {
+      continue;
     }
+    tuple_size = UnsetDeletedFlag(tuple_size);
+    new_free_space_pointer -= tuple_size;
+    memcpy(GetData() + new_free_space_pointer, tuples + GetTupleOffsetAtSlot(i) - free_space_pointer, tuple_size);
+    SetTupleOffsetAtSlot(i, new_free_space_pointer);
   }
+  SetFreeSpacePointer(new_free_space_pointer);
+  SetDeadSpace(0);
+}
+
+bool TablePage::ConvertEarlierFormat(Row *row, Schema *schema) {
+  // the slots are still where the earlier header ended
+  char *slots = GetData() + SIZE_EARLIER_TABLE_PAGE_HEADER;
+  auto earlier_tuple_size = [&](uint32_t slot_num) {
+    return *reinterpret_cast<uint32_t *>(slots + SIZE_TUPLE * slot_num + sizeof(uint32_t));
+  };
+  uint32_t tuple_count = GetTupleCount();
+  while (tuple_count > 0 && earlier_tuple_size(tuple_count - 1) == 0) {
+    tuple_count--;
+  }
+  uint32_t dead_space = 0;
+  bool taken_out = false;
+  constexpr uint32_t header_growth = SIZE_TABLE_PAGE_HEADER - SIZE_EARLIER_TABLE_PAGE_HEADER;
+  if (GetFreeSpacePointer() - SIZE_EARLIER_TABLE_PAGE_HEADER - SIZE_TUPLE * tuple_count < header_growth) {
+    // dropping the last slot frees SIZE_TUPLE bytes, enough for the header to grow
+    tuple_count--;
+    uint32_t offset = *reinterpret_cast<uint32_t *>(slots + SIZE_TUPLE * tuple_count);
+    dead_space = UnsetDeletedFlag(earlier_tuple_size(tuple_count));
+    // a tuple marked as deleted is not taken out, it is gone with its slot
+    if (!IsDeleted(earlier_tuple_size(tuple_count))) {
+      row->DeserializeFrom(GetData() + offset, schema);
+      row->SetRowId(RowId(GetTablePageId(), tuple_count));
+      taken_out = true;
+    }
+  }
+  memmove(GetData() + OFFSET_TUPLE_OFFSET, slots, SIZE_TUPLE * tuple_count);
+  SetTupleCount(tuple_count);
+  SetDeadSpace(dead_space);
+  SetFreeSlot(INVALID_SLOT);
+  for (uint32_t i = tuple_count; i-- > 0;) {
+    if (GetTupleSize(i) == 0) {
+      SetTupleOffsetAtSlot(i, GetFreeSlot());
+      SetFreeSlot(i);
+    }
+  }
+  return taken_out;
 }
 
 void TablePage::RollbackDelete(const RowId &rid, Txn *txn, LogManager *log_manager) {
@@ -161,6 +239,15 @@ bool TablePage::GetTuple(Row *row, Schema *schema, Txn *txn, LockManager *lock_m
   return true;
 }
 
+bool TablePage::GetTupleView(const RowId &rid, RowView *view, Schema *schema) {
+  uint32_t slot_num = rid.GetSlotNum();
+  if (slot_num >= GetTupleCount() || IsDeleted(GetTupleSize(slot_num))) {
+    return false;
+  }
+  view->Reset(GetData() + GetTupleOffsetAtSlot(slot_num), schema, rid);
+  return true;
+}
+
 bool TablePage::GetFirstTupleRid(RowId *first_rid) {
   // Find and return the first valid tuple.
   for (uint32_t i = 0; i < GetTupleCount(); i++) {
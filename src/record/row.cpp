@@ -1,97 +1,64 @@
 #include "record/row.h"
+
 #include "glog/logging.h"
+#include "record/row_view.h"
+
 /**
  * TODO: Student Implement
  */
 uint32_t Row::SerializeTo(char *buf, Schema *schema) const {
   ASSERT(schema != nullptr, "Invalid schema before serialize.");
   ASSERT(schema->GetColumnCount() == fields_.size(), "Fields size do not match schema's column size.");
-  // replace with your code here
-  auto field_num = fields_.size();
-  uint32_t bitmap = 0; // 1 in each bit indicates null, 0 indicates not null
-  // write field number
+  uint32_t field_num = fields_.size();
+  uint32_t fixed_begin = GetHeaderSize(field_num);
+  uint32_t varchar_begin = fixed_begin + schema->GetFixedSize();
+  uint32_t offset = varchar_begin + schema->GetVarcharCount() * sizeof(uint32_t);
+  // header and null bitmap
+  MACH_WRITE_UINT32(buf, FORMAT_VERSION << 24 | field_num);
+  memset(buf + sizeof(uint32_t), 0, fixed_begin - sizeof(uint32_t));
   for (uint32_t i = 0; i < field_num; i++) {
-    if (fields_[i]->IsNull()) {
-      bitmap |= (1 << (field_num - 1 - i));
+    const Field *field = &fields_[i];
+    uint32_t slot = schema->GetColumnSlot(i);
+    if (field->IsNull()) {
+      buf[sizeof(uint32_t) + i / 8] |= static_cast<char>(1 << (i % 8));
+    }
+    if (field->GetTypeId() == kTypeChar) {
+      if (!field->IsNull()) {
+        memcpy(buf + offset, field->GetData(), field->GetLength());
+        offset += field->GetLength();
+      }
+      MACH_WRITE_UINT32(buf + varchar_begin + slot * sizeof(uint32_t), offset);
+    } else if (field->IsNull()) {
+      memset(buf + fixed_begin + slot, 0, Type::GetTypeSize(field->GetTypeId()));
+    } else {
+      field->SerializeTo(buf + fixed_begin + slot);
     }
   }
-  // char null_bitmap[field_num / 8 + 1]; // 1 byte for 8 columns
-  //
-  // memset(null_bitmap, 0, sizeof(null_bitmap));
-  //
-  // for (uint32_t i = 0; i < field_num; i++) { // set null_bitmap
-  //   if (fields_[i]->IsNull()) {
-  //     null_bitmap[i / 8] |= (1 << (7 - (i % 8)));
-  //   } else {
-  //     null_bitmap[i / 8] &= ~(1 << (7 - (i % 8)));
-  //   }
-  // }
-
-  uint32_t offset = 0;
-  // write filed number
-  MACH_WRITE_UINT32(buf + offset, field_num);
-  offset += sizeof(uint32_t);
-  // LOG(INFO) << "field_num in serialization " << field_num << std::endl;
-
-  // write null bitmap
-  MACH_WRITE_UINT32(buf+offset, bitmap);
-  offset += sizeof(bitmap);
-
-  // write each field
-  for (uint32_t i = 0; i < field_num; i++) {
-    offset += fields_[i]->SerializeTo(buf + offset);
-  }
-
   return offset;
 }
 
 uint32_t Row::DeserializeFrom(char *buf, Schema *schema) {
   ASSERT(schema != nullptr, "Invalid schema before serialize.");
   ASSERT(fields_.empty(), "Non empty field in row.");
-
-  uint32_t offset = 0;
-
-  // read field number
-  uint32_t field_num = MACH_READ_UINT32(buf + offset);
-  offset += sizeof(uint32_t);
-  // LOG(INFO) << "field_num in deserialization " << field_num << std::endl;
-  uint32_t bitmap = 0;
-  // char null_bitmap[field_num / 8 + 1];
-
-  // read null bitmap
-  bitmap = MACH_READ_UINT32(buf+offset);
-  offset += sizeof(uint32_t);
-
-  fields_.resize(field_num);
-
-  // read each field
-  for (uint32_t i = 0; i < field_num; i++) {
-    if (bitmap & (1 << (field_num - 1 - i))) {
-      TypeId type = schema->GetColumn(i)->GetType();
-      offset += Field::DeserializeFrom(buf + offset, type, &fields_[i], true);
-    } else {
-      TypeId type = schema->GetColumn(i)->GetType();
-      offset += Field::DeserializeFrom(buf + offset, type, &fields_[i], false);
-    }
+  RowView view(buf, schema);
+  fields_.reserve(view.GetFieldCount());
+  for (uint32_t i = 0; i < view.GetFieldCount(); i++) {
+    AppendField(view.GetField(i), true);
   }
-
-  return offset;
+  return view.GetSerializedSize();
 }
 
 uint32_t Row::GetSerializedSize(Schema *schema) const {
   ASSERT(schema != nullptr, "Invalid schema before serialize.");
   ASSERT(schema->GetColumnCount() == fields_.size(), "Fields size do not match schema's column size.");
 
-  auto field_num = fields_.size();
-
-  uint32_t offset = 0;
-  offset += sizeof(uint32_t) + sizeof(uint32_t);
-  for (auto i : fields_)
-  {
-    offset += i->GetSerializedSize();
+  uint32_t size = GetHeaderSize(fields_.size()) + schema->GetFixedSize() + schema->GetVarcharCount() * sizeof(uint32_t);
+  for (const auto &field : fields_) {
+    if (field.GetTypeId() == kTypeChar && !field.IsNull()) {
+      size += field.GetLength();
+    }
   }
-
-  return offset;
+  return size;
 }
 
 void Row::GetKeyFromRow(const Schema *schema, const Schema *key_schema, Row &key_row) {
@@ -102,5 +69,27 @@ void Row::GetKeyFromRow(const Schema *schema, const Schema *key_schema, Row &key
     schema->GetColumnIndex(column->GetName(), idx);
     fields.emplace_back(*this->GetField(idx));
   }
-  key_row = Row(fields);
+  key_row = Row(std::move(fields));
+}
+
+uint32_t Row::FindTooLongField(const Schema *schema) const {
+  for (uint32_t i = 0; i < fields_.size(); i++) {
+    const Column *column = schema->GetColumn(i);
+    if (column->GetType() == kTypeChar && !fields_[i].IsNull() && fields_[i].GetLength() > column->GetLength()) {
+      return i;
+    }
+  }
+  return fields_.size();
+}
+
+void Row::AppendField(const Field &field, bool copy_chars) {
+  if (!copy_chars || field.GetTypeId() != kTypeChar || field.IsNull()) {
+    fields_.emplace_back(field);
+  } else if (arena_ == nullptr || field.GetLength() <= FIELD_INLINE_LEN) {
+    fields_.emplace_back(kTypeChar, const_cast<char *>(field.GetData()), field.GetLength(), true);
+  } else {
+    auto chars = static_cast<char *>(arena_->Allocate(field.GetLength(), 1));
+    memcpy(chars, field.GetData(), field.GetLength());
+    fields_.emplace_back(kTypeChar, chars, field.GetLength(), false);
+  }
 }
@@ -0,0 +1,83 @@
+#include "record/row_view.h"
+
+void RowView::Reset(const char *data, Schema *schema, RowId rid) {
+  ASSERT(data != nullptr && schema != nullptr, "Invalid row view.");
+  data_ = data;
+  schema_ = schema;
+  rid_ = rid;
+  version_ = Row::GetFormatVersion(data);
+  field_count_ = Row::GetFieldCount(data);
+  if (version_ == 0) {
+    offsets_.clear();
+    offsets_.push_back(2 * sizeof(uint32_t));
+  } else {
+    fixed_begin_ = Row::GetHeaderSize(field_count_);
+    varchar_begin_ = fixed_begin_ + schema->GetFixedSize();
+  }
+}
+
+uint32_t RowView::GetFieldOffsetV0(uint32_t idx) const {
+  while (offsets_.size() <= idx) {
+    uint32_t i = offsets_.size() - 1;
+    uint32_t offset = offsets_.back();
+    if (!IsNull(i)) {
+      TypeId type = schema_->GetColumn(i)->GetType();
+      offset += type == kTypeChar ? sizeof(uint32_t) + MACH_READ_UINT32(data_ + offset) : Type::GetTypeSize(type);
+    }
+    offsets_.push_back(offset);
+  }
+  return offsets_[idx];
+}
+
+Field RowView::GetField(uint32_t idx) const {
+  TypeId type = schema_->GetColumn(idx)->GetType();
+  if (IsNull(idx)) {
+    return Field(type);
+  }
+  const char *buf;
+  uint32_t len = 0;
+  if (version_ == 0) {
+    buf = data_ + GetFieldOffsetV0(idx);
+    if (type == kTypeChar) {
+      len = MACH_READ_UINT32(buf);
+      buf += sizeof(uint32_t);
+    }
+  } else if (type == kTypeChar) {
+    uint32_t slot = schema_->GetColumnSlot(idx);
+    const char *ends = data_ + varchar_begin_;
+    uint32_t begin = slot == 0 ? varchar_begin_ + schema_->GetVarcharCount() * sizeof(uint32_t)
+                               : MACH_READ_UINT32(ends + (slot - 1) * sizeof(uint32_t));
+    buf = data_ + begin;
+    len = MACH_READ_UINT32(ends + slot * sizeof(uint32_t)) - begin;
+  } else {
+    buf = data_ + fixed_begin_ + schema_->GetColumnSlot(idx);
+  }
+  switch (type) {
+    case kTypeInt:
+      return Field(kTypeInt, MACH_READ_FROM(int32_t, buf));
+    case kTypeFloat:
+      return Field(kTypeFloat, MACH_READ_FROM(float, buf));
+    case kTypeChar:
+      return Field(kTypeChar, const_cast<char *>(buf), len, false);
+    default:
+      break;
+  }
+  throw "Unknown field type.";
+}
+
+uint32_t RowView::GetSerializedSize() const {
+  if (version_ == 0) {
+    return GetFieldOffsetV0(field_count_);
+  }
+  uint32_t varchar_count = schema_->GetVarcharCount();
+  if (varchar_count == 0) {
+    return varchar_begin_;
+  }
+  return MACH_READ_UINT32(data_ + varchar_begin_ + (varchar_count - 1) * sizeof(uint32_t));
+}
+
+void RowView::ToRow(Row *row) const {
+  row->destroy();
+  row->SetRowId(rid_);
+  row->DeserializeFrom(const_cast<char *>(data_), schema_);
+}
@@ -3,18 +3,6 @@
 #include "common/macros.h"
 #include "record/field.h"
 
-inline int CompareStrings(const char *str1, int len1, const char *str2, int len2) {
-  assert(str1 != nullptr);
-  assert(len1 >= 0);
-  assert(str2 != nullptr);
-  assert(len2 >= 0);
-  int ret = memcmp(str1, str2, static_cast<size_t>(std::min(len1, len2)));
-  if (ret == 0 && len1 != len2) {
-    ret = len1 - len2;
-  }
-  return ret;
-}
-
 // ==============================Type=============================
 
 Type *Type::type_singletons_[] = {new Type(TypeId::kTypeInvalid), new TypeInt(), new TypeFloat(), new TypeChar()};
@@ -76,13 +64,7 @@ CmpBool Type::CompareGreaterThanEquals(const Field &left, const Field &right) co
 
 // ==============================TypeInt=================================
 
-uint32_t TypeInt::SerializeTo(const Field &field, char *buf) const {
-  if (!field.IsNull()) {
-    MACH_WRITE_TO(int32_t, buf, field.value_.integer_);
-    return GetTypeSize(type_id_);
-  }
-  return 0;
-}
+uint32_t TypeInt::SerializeTo(const Field &field, char *buf) const { return field.SerializeTo(buf); }
 
 uint32_t TypeInt::DeserializeFrom(char *storage, Field **field, bool is_null) const {
   if (is_null) {
@@ -102,62 +84,32 @@ uint32_t TypeInt::GetSerializedSize(const Field &field, bool is_null) const {
 }
 
 CmpBool TypeInt::CompareEquals(const Field &left, const Field &right) const {
-  ASSERT(left.CheckComparable(right), "Not comparable.");
-  if (left.IsNull() || right.IsNull()) {
-    return CmpBool::kNull;
-  }
-  return GetCmpBool(left.value_.integer_ == right.value_.integer_);
+  return CompareFields<kTypeInt, CmpOp::kEquals>(left, right);
 }
 
 CmpBool TypeInt::CompareNotEquals(const Field &left, const Field &right) const {
-  ASSERT(left.CheckComparable(right), "Not comparable.");
-  if (left.IsNull() || right.IsNull()) {
-    return CmpBool::kNull;
-  }
-  return GetCmpBool(left.value_.integer_ != right.value_.integer_);
+  return CompareFields<kTypeInt, CmpOp::kNotEquals>(left, right);
 }
 
 CmpBool TypeInt::CompareLessThan(const Field &left, const Field &right) const {
-  ASSERT(left.CheckComparable(right), "Not comparable.");
-  if (left.IsNull() || right.IsNull()) {
-    return CmpBool::kNull;
-  }
-  return GetCmpBool(left.value_.integer_ < right.value_.integer_);
+  return CompareFields<kTypeInt, CmpOp::kLessThan>(left, right);
 }
 
 CmpBool TypeInt::CompareLessThanEquals(const Field &left, const Field &right) const {
-  ASSERT(left.CheckComparable(right), "Not comparable.");
-  if (left.IsNull() || right.IsNull()) {
-    return CmpBool::kNull;
-  }
-  return GetCmpBool(left.value_.integer_ <= right.value_.integer_);
+  return CompareFields<kTypeInt, CmpOp::kLessThanEquals>(left, right);
 }
 
 CmpBool TypeInt::CompareGreaterThan(const Field &left, const Field &right) const {
-  ASSERT(left.CheckComparable(right), "Not comparable.");
-  if (left.IsNull() || right.IsNull()) {
-    return CmpBool::kNull;
-  }
-  return GetCmpBool(left.value_.integer_ > right.value_.integer_);
+  return CompareFields<kTypeInt, CmpOp::kGreaterThan>(left, right);
 }
 
 CmpBool TypeInt::CompareGreaterThanEquals(const Field &left, const Field &right) const {
-  ASSERT(left.CheckComparable(right), "Not comparable.");
-  if (left.IsNull() || right.IsNull()) {
-    return CmpBool::kNull;
-  }
-  return GetCmpBool(left.value_.integer_ >= right.value_.integer_);
+  return CompareFields<kTypeInt, CmpOp::kGreaterThanEquals>(left, right);
 }
 
 // ==============================TypeFloat=============================
 
-uint32_t TypeFloat::SerializeTo(const Field &field, char *buf) const {
-  if (!field.IsNull()) {
-    MACH_WRITE_TO(float_t, buf, field.value_.float_);
-    return GetTypeSize(type_id_);
-  }
-  return 0;
-}
+uint32_t TypeFloat::SerializeTo(const Field &field, char *buf) const { return field.SerializeTo(buf); }
 
 uint32_t TypeFloat::DeserializeFrom(char *storage, Field **field, bool is_null) const {
   if (is_null) {
@@ -177,63 +129,31 @@ uint32_t TypeFloat::GetSerializedSize(const Field &field, bool is_null) const {
 }
 
 CmpBool TypeFloat::CompareEquals(const Field &left, const Field &right) const {
-  ASSERT(left.CheckComparable(right), "Not comparable.");
-  if (left.IsNull() || right.IsNull()) {
-    return CmpBool::kNull;
-  }
-  return GetCmpBool(left.value_.float_ == right.value_.float_);
+  return CompareFields<kTypeFloat, CmpOp::kEquals>(left, right);
 }
 
 CmpBool TypeFloat::CompareNotEquals(const Field &left, const Field &right) const {
-  ASSERT(left.CheckComparable(right), "Not comparable.");
-  if (left.IsNull() || right.IsNull()) {
-    return CmpBool::kNull;
-  }
-  return GetCmpBool(left.value_.float_ != right.value_.float_);
+  return CompareFields<kTypeFloat, CmpOp::kNotEquals>(left, right);
 }
 
 CmpBool TypeFloat::CompareLessThan(const Field &left, const Field &right) const {
-  ASSERT(left.CheckComparable(right), "Not comparable.");
-  if (left.IsNull() || right.IsNull()) {
-    return CmpBool::kNull;
-  }
-  return GetCmpBool(left.value_.float_ < right.value_.float_);
+  return CompareFields<kTypeFloat, CmpOp::kLessThan>(left, right);
 }
 
 CmpBool TypeFloat::CompareLessThanEquals(const Field &left, const Field &right) const {
-  ASSERT(left.CheckComparable(right), "Not comparable.");
-  if (left.IsNull() || right.IsNull()) {
-    return CmpBool::kNull;
-  }
-  return GetCmpBool(left.value_.float_ <= right.value_.float_);
+  return CompareFields<kTypeFloat, CmpOp::kLessThanEquals>(left, right);
 }
 
 CmpBool TypeFloat::CompareGreaterThan(const Field &left, const Field &right) const {
-  ASSERT(left.CheckComparable(right), "Not comparable.");
-  if (left.IsNull() || right.IsNull()) {
-    return CmpBool::kNull;
-  }
-  return GetCmpBool(left.value_.float_ > right.value_.float_);
+  return CompareFields<kTypeFloat, CmpOp::kGreaterThan>(left, right);
 }
 
 CmpBool TypeFloat::CompareGreaterThanEquals(const Field &left, const Field &right) const {
-  ASSERT(left.CheckComparable(right), "Not comparable.");
-  if (left.IsNull() || right.IsNull()) {
-    return CmpBool::kNull;
-  }
-  return GetCmpBool(left.value_.float_ >= right.value_.float_);
+  return CompareFields<kTypeFloat, CmpOp::kGreaterThanEquals>(left, right);
 }
 
 // ==============================TypeChar=============================
-uint32_t TypeChar::SerializeTo(const Field &field, char *buf) const {
-  if (!field.IsNull()) {
-    uint32_t len = GetLength(field);
-    memcpy(buf, &len, sizeof(uint32_t));
-    memcpy(buf + sizeof(uint32_t), field.value_.chars_, len);
-    return len + sizeof(uint32_t);
-  }
-  return 0;
-}
+uint32_t TypeChar::SerializeTo(const Field &field, char *buf) const { return field.SerializeTo(buf); }
 
 uint32_t TypeChar::DeserializeFrom(char *storage, Field **field, bool is_null) const {
   if (is_null) {
@@ -253,58 +173,81 @@ uint32_t TypeChar::GetSerializedSize(const Field &field, bool is_null) const {
   return len + sizeof(uint32_t);
 }
 
-const char *TypeChar::GetData(const Field &val) const {
-  return val.value_.chars_;
-}
+const char *TypeChar::GetData(const Field &val) const { return TypeKernel<kTypeChar>::GetData(val); }
 
 uint32_t TypeChar::GetLength(const Field &val) const {
   return val.len_;
 }
 
 CmpBool TypeChar::CompareEquals(const Field &left, const Field &right) const {
-  ASSERT(left.CheckComparable(right), "Not comparable.");
-  if (left.IsNull() || right.IsNull()) {
-    return CmpBool::kNull;
-  }
-  return GetCmpBool(CompareStrings(left.GetData(), left.GetLength(), right.GetData(), right.GetLength()) == 0);
+  return CompareFields<kTypeChar, CmpOp::kEquals>(left, right);
 }
 
 CmpBool TypeChar::CompareNotEquals(const Field &left, const Field &right) const {
-  ASSERT(left.CheckComparable(right), "Not comparable.");
-  if (left.IsNull() || right.IsNull()) {
-    return CmpBool::kNull;
-  }
-  return GetCmpBool(CompareStrings(left.GetData(), left.GetLength(), right.GetData(), right.GetLength()) != 0);
+  return CompareFields<kTypeChar, CmpOp::kNotEquals>(left, right);
 }
 
 CmpBool TypeChar::CompareLessThan(const Field &left, const Field &right) const {
-  ASSERT(left.CheckComparable(right), "Not comparable.");
-  if (left.IsNull() || right.IsNull()) {
-    return CmpBool::kNull;
-  }
-  return GetCmpBool(CompareStrings(left.GetData(), left.GetLength(), right.GetData(), right.GetLength()) < 0);
+  return CompareFields<kTypeChar, CmpOp::kLessThan>(left, right);
 }
 
 CmpBool TypeChar::CompareLessThanEquals(const Field &left, const Field &right) const {
-  ASSERT(left.CheckComparable(right), "Not comparable.");
-  if (left.IsNull() || right.IsNull()) {
-    return CmpBool::kNull;
-  }
-  return GetCmpBool(CompareStrings(left.GetData(), left.GetLength(), right.GetData(), right.GetLength()) <= 0);
+  return CompareFields<kTypeChar, CmpOp::kLessThanEquals>(left, right);
 }
 
 CmpBool TypeChar::CompareGreaterThan(const Field &left, const Field &right) const {
-  ASSERT(left.CheckComparable(right), "Not comparable.");
-  if (left.IsNull() || right.IsNull()) {
-    return CmpBool::kNull;
-  }
-  return GetCmpBool(CompareStrings(left.GetData(), left.GetLength(), right.GetData(), right.GetLength()) > 0);
+  return CompareFields<kTypeChar, CmpOp::kGreaterThan>(left, right);
 }
 
 CmpBool TypeChar::CompareGreaterThanEquals(const Field &left, const Field &right) const {
-  ASSERT(left.CheckComparable(right), "Not comparable.");
-  if (left.IsNull() || right.IsNull()) {
-    return CmpBool::kNull;
-  }
-  return GetCmpBool(CompareStrings(left.GetData(), left.GetLength(), right.GetData(), right.GetLength()) >= 0);
+  return CompareFields<kTypeChar, CmpOp::kGreaterThanEquals>(left, right);
+}
+
+// ==============================Kernels=============================
+
+template <TypeId type>
+static FieldComparator GetComparatorOf(CmpOp op) {
+  switch (op) {
+    case CmpOp::kEquals:
+      return CompareFields<type, CmpOp::kEquals>;
+    case CmpOp::kNotEquals:
+      return CompareFields<type, CmpOp::kNotEquals>;
+    case CmpOp::kLessThan:
+      return CompareFields<type, CmpOp::kLessThan>;
+    case CmpOp::kLessThanEquals:
+      return CompareFields<type, CmpOp::kLessThanEquals>;
+    case CmpOp::kGreaterThan:
+      return CompareFields<type, CmpOp::kGreaterThan>;
+    case CmpOp::kGreaterThanEquals:
+      return CompareFields<type, CmpOp::kGreaterThanEquals>;
+  }
+  throw "Unknown comparison.";
+}
+
+FieldComparator GetFieldComparator(TypeId type, CmpOp op) {
+  switch (type) {
+    case kTypeInt:
+      return GetComparatorOf<kTypeInt>(op);
+    case kTypeFloat:
+      return GetComparatorOf<kTypeFloat>(op);
+    case kTypeChar:
+      return GetComparatorOf<kTypeChar>(op);
+    default:
+      break;
+  }
+  throw "Unknown field type.";
+}
+
+FieldOrder GetFieldOrder(TypeId type) {
+  switch (type) {
+    case kTypeInt:
+      return CompareFieldOrder<kTypeInt>;
+    case kTypeFloat:
+      return CompareFieldOrder<kTypeFloat>;
+    case kTypeChar:
+      return CompareFieldOrder<kTypeChar>;
+    default:
+      break;
+  }
+  throw "Unknown field type.";
 }
@@ -0,0 +1,259 @@
+#include "storage/async_io.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include "glog/logging.h"
+
+#ifdef MINISQL_HAVE_IO_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+std::unique_ptr<AsyncIO> AsyncIO::Create(int fd, Backend backend) {
+#ifdef MINISQL_HAVE_IO_URING
+  if (backend == kIoUring) {
+    auto io_uring = IoUringAsyncIO::Create(fd, DISK_IO_QUEUE_DEPTH);
+    if (io_uring != nullptr) {
+      return io_uring;
+    }
+    LOG(WARNING) << "io_uring not available, falling back to a thread pool" << std::endl;
+  }
+#endif
+  return std::make_unique<ThreadPoolAsyncIO>(fd, DISK_IO_THREADS);
+}
+
+/*****************************************************************************
+ * ThreadPoolAsyncIO
+ *****************************************************************************/
+ThreadPoolAsyncIO::ThreadPoolAsyncIO(int fd, size_t num_threads) : fd_(fd) {
+  for (size_t i = 0; i < num_threads; i++) {
+    workers_.emplace_back(&ThreadPoolAsyncIO::Run, this);
+  }
+}
+
+ThreadPoolAsyncIO::~ThreadPoolAsyncIO() {
+  {
+    std::scoped_lock<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  for (auto &worker : workers_) {
+    worker.join();
+  }
+}
+
+void ThreadPoolAsyncIO::Submit(std::vector<AsyncIORequest> &requests) {
+  {
+    std::scoped_lock<std::mutex> lock(mutex_);
+    for (auto &request : requests) {
+      queue_.push_back(std::move(request));
+    }
+  }
+  cv_.notify_all();
+}
+
+void ThreadPoolAsyncIO::Run() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    // requests queued before the shutdown are still served
+    cv_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+    if (queue_.empty()) {
+      return;
+    }
+    AsyncIORequest request = std::move(queue_.front());
+    queue_.pop_front();
+    lock.unlock();
+    ssize_t res = request.is_write_ ? pwrite(fd_, request.buf_, request.len_, request.offset_)
+                                    : pread(fd_, request.buf_, request.len_, request.offset_);
+    request.callback_(res < 0 ? -errno : res);
+    lock.lock();
+  }
+}
+
+#ifdef MINISQL_HAVE_IO_URING
+/*****************************************************************************
+ * IoUringAsyncIO
+ *****************************************************************************/
+std::unique_ptr<IoUringAsyncIO> IoUringAsyncIO::Create(int fd, size_t queue_depth) {
+  std::unique_ptr<IoUringAsyncIO> io_uring(new IoUringAsyncIO(fd));
+  if (!io_uring->Init(queue_depth)) {
+    return nullptr;
+  }
+  return io_uring;
+}
+
+bool IoUringAsyncIO::Init(size_t queue_depth) {
+  io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  ring_fd_ = static_cast<int>(syscall(__NR_io_uring_setup, queue_depth, &params));
+  if (ring_fd_ < 0) {
+    return false;
+  }
+  sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+  bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+  if (single_mmap) {
+    sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+  }
+  sq_ring_ = mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_,
+                  IORING_OFF_SQ_RING);
+  if (sq_ring_ == MAP_FAILED) {
+    sq_ring_ = nullptr;
+    return false;
+  }
+  if (single_mmap) {
+    cq_ring_ = sq_ring_;
+  } else {
+    cq_ring_ = mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_,
+                    IORING_OFF_CQ_RING);
+    if (cq_ring_ == MAP_FAILED) {
+      cq_ring_ = nullptr;
+      return false;
+    }
+  }
+  sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+  sqes_ = mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQES);
+  if (sqes_ == MAP_FAILED) {
+    sqes_ = nullptr;
+    return false;
+  }
+  auto sq = static_cast<char *>(sq_ring_);
+  sq_tail_ = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+  sq_mask_ = reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+  sq_array_ = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+  auto cq = static_cast<char *>(cq_ring_);
+  cq_head_ = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+  cq_tail_ = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+  cq_mask_ = reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+  cqes_ = cq + params.cq_off.cqes;
+  // keep one entry for the request that stops the completion thread
+  capacity_ = std::min(params.sq_entries, params.cq_entries) - 1;
+  reaper_ = std::thread(&IoUringAsyncIO::ReapCompletions, this);
+  return true;
+}
+
+IoUringAsyncIO::~IoUringAsyncIO() {
+  if (reaper_.joinable()) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    not_full_.wait(lock, [this] { return in_flight_ == 0; });
+    PushEntry(IORING_OP_NOP, 0, nullptr, 0, 0);
+    syscall(__NR_io_uring_enter, ring_fd_, 1, 0, 0, nullptr, 0);
+    lock.unlock();
+    reaper_.join();
+  }
+  if (sqes_ != nullptr) {
+    munmap(sqes_, sqes_size_);
+  }
+  if (cq_ring_ != nullptr && cq_ring_ != sq_ring_) {
+    munmap(cq_ring_, cq_ring_size_);
+  }
+  if (sq_ring_ != nullptr) {
+    munmap(sq_ring_, sq_ring_size_);
+  }
+  if (ring_fd_ >= 0) {
+    close(ring_fd_);
+  }
+}
+
+void IoUringAsyncIO::Submit(std::vector<AsyncIORequest> &requests) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  unsigned pending = 0;
+  // requests the kernel never took, completed once the lock is released
+  std::vector<std::pair<AsyncIORequest *, int>> failed;
+  auto enter = [&] {
+    while (pending > 0) {
+      int ret = static_cast<int>(syscall(__NR_io_uring_enter, ring_fd_, pending, 0, 0, nullptr, 0));
+      if (ret < 0) {
+        if (errno == EINTR || errno == EAGAIN || errno == EBUSY) {
+          continue;
+        }
+        int error = errno;
+        LOG(ERROR) << "io_uring_enter failed: " << strerror(error) << std::endl;
+        // the last pending entries were not consumed, take them back out of the ring
+        unsigned tail = *sq_tail_ - pending;
+        for (unsigned i = 0; i < pending; i++) {
+          auto sqe = static_cast<io_uring_sqe *>(sqes_) + ((tail + i) & *sq_mask_);
+          failed.emplace_back(reinterpret_cast<AsyncIORequest *>(sqe->user_data), -error);
+        }
+        __atomic_store_n(sq_tail_, tail, __ATOMIC_RELEASE);
+        in_flight_ -= pending;
+        pending = 0;
+        not_full_.notify_all();
+        return;
+      }
+      pending -= ret;
+    }
+  };
+  for (auto &request : requests) {
+    if (in_flight_ == capacity_) {
+      enter();
+      not_full_.wait(lock, [this] { return in_flight_ < capacity_; });
+    }
+    auto pending_request = new AsyncIORequest(std::move(request));
+    PushEntry(pending_request->is_write_ ? IORING_OP_WRITE : IORING_OP_READ, pending_request->offset_,
+              pending_request->buf_, pending_request->len_, reinterpret_cast<uint64_t>(pending_request));
+    in_flight_++;
+    pending++;
+  }
+  enter();
+  lock.unlock();
+  for (auto [request, res] : failed) {
+    request->callback_(res);
+    delete request;
+  }
+}
+
+void IoUringAsyncIO::PushEntry(uint8_t opcode, off_t offset, char *buf, size_t len, uint64_t user_data) {
+  // only the thread holding mutex_ moves the tail, entries the kernel does not consume are taken back by Submit
+  unsigned tail = *sq_tail_;
+  unsigned index = tail & *sq_mask_;
+  auto sqe = static_cast<io_uring_sqe *>(sqes_) + index;
+  memset(sqe, 0, sizeof(*sqe));
+  sqe->opcode = opcode;
+  sqe->fd = fd_;
+  sqe->off = offset;
+  sqe->addr = reinterpret_cast<uint64_t>(buf);
+  sqe->len = static_cast<uint32_t>(len);
+  sqe->user_data = user_data;
+  sq_array_[index] = index;
+  __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+}
+
+void IoUringAsyncIO::ReapCompletions() {
+  while (true) {
+    unsigned head = *cq_head_;
+    unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+    if (head == tail) {
+      syscall(__NR_io_uring_enter, ring_fd_, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+      continue;
+    }
+    bool stop = false;
+    size_t completed = 0;
+    for (; head != tail; head++) {
+      auto cqe = static_cast<io_uring_cqe *>(cqes_) + (head & *cq_mask_);
+      if (cqe->user_data == 0) {
+        stop = true;
+        continue;
+      }
+      auto request = reinterpret_cast<AsyncIORequest *>(cqe->user_data);
+      request->callback_(cqe->res);
+      delete request;
+      completed++;
+    }
+    __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+    {
+      std::scoped_lock<std::mutex> lock(mutex_);
+      in_flight_ -= completed;
+    }
+    not_full_.notify_all();
+    if (stop) {
+      return;
+    }
+  }
+}
+#endif  // MINISQL_HAVE_IO_URING
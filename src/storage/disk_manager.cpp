@@ -1,39 +1,81 @@
 #include "storage/disk_manager.h"
 
+#include <fcntl.h>
 #include <sys/stat.h>
+#include <unistd.h>
 
+#include <cstdlib>
 #include <filesystem>
 #include <stdexcept>
 
 #include "glog/logging.h"
 #include "page/bitmap_page.h"
 
-DiskManager::DiskManager(const std::string &db_file) : file_name_(db_file) {
+DiskManager::DiskManager(const std::string &db_file, bool direct_io, AsyncIO::Backend async_backend)
+    : file_name_(db_file), async_backend_(async_backend) {
   std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
-  db_io_.open(db_file, std::ios::binary | std::ios::in | std::ios::out);
-  // directory or file does not exist
-  if (!db_io_.is_open()) {
-    db_io_.clear();
-    // create a new file
-    std::filesystem::path p = db_file;
-    if (p.has_parent_path()) std::filesystem::create_directories(p.parent_path());
-    db_io_.open(db_file, std::ios::binary | std::ios::trunc | std::ios::out);
-    db_io_.close();
-    // reopen with original mode
-    db_io_.open(db_file, std::ios::binary | std::ios::in | std::ios::out);
-    if (!db_io_.is_open()) {
-      throw std::exception();
+  // directory does not exist
+  std::filesystem::path p = db_file;
+  if (p.has_parent_path()) std::filesystem::create_directories(p.parent_path());
+  if (direct_io) {
+    db_fd_ = open(db_file.c_str(), O_RDWR | O_CREAT | O_DIRECT, 0644);
+    if (db_fd_ < 0) {
+      LOG(WARNING) << "O_DIRECT not supported for " << db_file << ", falling back to buffered I/O" << std::endl;
     }
   }
+  direct_io_ = db_fd_ >= 0;
+  if (db_fd_ < 0) {
+    db_fd_ = open(db_file.c_str(), O_RDWR | O_CREAT, 0644);
+  }
+  if (db_fd_ < 0) {
+    throw std::exception();
+  }
+  file_size_ = GetFileSize();
   ReadPhysicalPage(META_PAGE_ID, meta_data_);
+  auto *meta_page = reinterpret_cast<DiskFileMetaPage *>(meta_data_);
+  if (meta_page->HasTrailer()) {
+    if (meta_page->GetPageSize() != PAGE_SIZE) {
+      close(db_fd_);
+      throw std::runtime_error(db_file + " has pages of " + std::to_string(meta_page->GetPageSize()) +
+                               " bytes, this build uses " + std::to_string(PAGE_SIZE));
+    }
+    if (meta_page->GetFormatVersion() > DISK_FORMAT_VERSION) {
+      close(db_fd_);
+      throw std::runtime_error(db_file + " has format version " + std::to_string(meta_page->GetFormatVersion()) +
+                               ", this build reads up to " + std::to_string(DISK_FORMAT_VERSION));
+    }
+  } else {
+    if (meta_page->GetAllocatedPages() != 0 || meta_page->GetExtentNums() != 0) {
+      // a file of an earlier build, the place of the trailer holds the used page counts of the last extents
+      bool trailer_used = meta_page->format_version_ != 0 || meta_page->page_size_ != 0 || meta_page->magic_ != 0;
+      if (PAGE_SIZE != 4096 || trailer_used) {
+        close(db_fd_);
+        throw std::runtime_error(db_file + " was created by an earlier build and cannot be converted, it needs " +
+                                 (PAGE_SIZE != 4096 ? std::string("4096 byte pages")
+                                                    : "the last extents of the first group to be unused"));
+      }
+      LOG(WARNING) << "Converting " << db_file << " to format version " << DISK_FORMAT_VERSION << std::endl;
+    }
+    meta_page->format_version_ = DISK_FORMAT_VERSION;
+    meta_page->page_size_ = PAGE_SIZE;
+    meta_page->magic_ = META_PAGE_MAGIC;
+  }
+  InitFreeSpaceMap();
 }
 
 void DiskManager::Close() {
   std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
-  WritePhysicalPage(META_PAGE_ID, meta_data_);
   if (!closed) {
-    db_io_.close();
-    closed = true;
+    {
+      // no asynchronous requests from now on, waits for the ones in flight
+      std::scoped_lock<std::mutex> async_io_lock(async_io_latch_);
+      closed = true;
+      async_io_.reset();
+    }
+    meta_dirty_[0] = true;
+    Checkpoint();
+    fdatasync(db_fd_);
+    close(db_fd_);
   }
 }
 
@@ -47,104 +89,183 @@ void DiskManager::WritePage(page_id_t logical_page_id, const char *page_data) {
   WritePhysicalPage(MapPageId(logical_page_id), page_data);
 }
 
-/**
- * TODO: Student Implement
- * 搜索每一个bitmap，找到第一个空闲的extent块，在该块中写入一个page
- */
-page_id_t DiskManager::AllocatePage() {
+void DiskManager::WritePages(const std::vector<std::pair<page_id_t, const char *>> &pages) {
+  for (auto &page : pages) {
+    ASSERT(page.first >= 0, "Invalid page id.");
+    WritePhysicalPage(MapPageId(page.first), page.second);
+  }
+}
 
-  DiskFileMetaPage* meta_page = reinterpret_cast<DiskFileMetaPage*>(meta_data_);
-  uint32_t i;
+std::future<bool> DiskManager::ReadPageAsync(page_id_t logical_page_id, char *page_data) {
+  return SubmitAsync(false, {{logical_page_id, page_data}});
+}
 
-  char buffer[PAGE_SIZE]; // 4k bytes
-  page_id_t physical_page_id;
-  BitmapPage<PAGE_SIZE>* bitmap;
-  uint32_t page_offset;
+std::future<bool> DiskManager::WritePageAsync(page_id_t logical_page_id, const char *page_data) {
+  return SubmitAsync(true, {{logical_page_id, const_cast<char *>(page_data)}});
+}
 
-  if (meta_page->GetAllocatedPages() >= MAX_VALID_PAGE_ID) {
-    return INVALID_PAGE_ID;
+std::future<bool> DiskManager::WritePagesAsync(const std::vector<std::pair<page_id_t, const char *>> &pages) {
+  std::vector<std::pair<page_id_t, char *>> writes;
+  writes.reserve(pages.size());
+  for (auto &page : pages) {
+    writes.emplace_back(page.first, const_cast<char *>(page.second));
   }
+  return SubmitAsync(true, writes);
+}
 
-  for (i = 0; i < meta_page->GetExtentNums(); i++) {
-    // i for extent id
-    if (meta_page->GetExtentUsedPage(i) < BITMAP_SIZE) { // 当前extent还有空闲的page
-      meta_page->num_allocated_pages_++;
-      meta_page->extent_used_page_[i]++; // 当前extent已经使用的page数+1
-
-      if (meta_page->extent_used_page_[i] == 1) {
-        meta_page->num_extents_++; //如果该扩展之前没有被使用过，则增加扩展数量的计数器
+std::future<bool> DiskManager::SubmitAsync(bool is_write, const std::vector<std::pair<page_id_t, char *>> &pages) {
+  struct Batch {
+    std::promise<bool> promise_;
+    std::atomic<size_t> remaining_;
+    std::atomic<bool> ok_{true};
+  };
+  auto batch = std::make_shared<Batch>();
+  batch->remaining_ = pages.size();
+  auto future = batch->promise_.get_future();
+  if (pages.empty()) {
+    batch->promise_.set_value(true);
+    return future;
+  }
+  AsyncIO *async_io = GetAsyncIO();
+  if (async_io == nullptr) {
+    LOG(ERROR) << "Asynchronous I/O on closed file " << file_name_;
+    batch->promise_.set_value(false);
+    return future;
+  }
+  auto finish = [batch](bool ok) {
+    if (!ok) {
+      batch->ok_ = false;
+    }
+    if (--batch->remaining_ == 0) {
+      batch->promise_.set_value(batch->ok_);
+    }
+  };
+  std::vector<AsyncIORequest> requests;
+  for (auto &page : pages) {
+    ASSERT(page.first >= 0, "Invalid page id.");
+    off_t offset = static_cast<off_t>(MapPageId(page.first)) * PAGE_SIZE;
+    char *page_data = page.second;
+    if (!is_write && offset >= file_size_) {
+      memset(page_data, 0, PAGE_SIZE);
+      finish(true);
+      continue;
+    }
+    // O_DIRECT needs page aligned buffers
+    char *bounce = nullptr;
+    if (direct_io_ && reinterpret_cast<uintptr_t>(page_data) % PAGE_SIZE != 0) {
+      bounce = static_cast<char *>(std::aligned_alloc(PAGE_SIZE, PAGE_SIZE));
+      if (is_write) {
+        memcpy(bounce, page_data, PAGE_SIZE);
       }
-
-      physical_page_id = i * (BITMAP_SIZE + 1/*bitmap page is 4kB size*/) + 1/*meta data page*/; // write a bitmap page
-      ReadPhysicalPage(physical_page_id, buffer); //读取bitmap page
-
-      bitmap = reinterpret_cast<BitmapPage<PAGE_SIZE>*>(buffer);
-      if (bitmap->AllocatePage(page_offset)) {
-
-        WritePhysicalPage(physical_page_id, buffer);
-        WritePhysicalPage(META_PAGE_ID, meta_data_); // write meta data page
-        LOG(WARNING) << "dskmgr : Allocate logical page: " << i * BITMAP_SIZE + page_offset << std::endl;
-        return i * BITMAP_SIZE + page_offset; // logical page id
+    }
+    AsyncIORequest request;
+    request.is_write_ = is_write;
+    request.offset_ = offset;
+    request.buf_ = bounce != nullptr ? bounce : page_data;
+    request.len_ = PAGE_SIZE;
+    request.callback_ = [this, is_write, offset, page_data, bounce, finish](ssize_t res) {
+      bool ok;
+      if (is_write) {
+        ok = res == PAGE_SIZE;
+        if (ok) {
+          GrowFileSize(offset + PAGE_SIZE);
+        }
       } else {
-        LOG(ERROR) << "Failed to allocate page in bitmap" << std::endl;
+        // the file may end before the page does
+        ok = res >= 0;
+        size_t read_count = ok ? res : 0;
+        char *buf = bounce != nullptr ? bounce : page_data;
+        memset(buf + read_count, 0, PAGE_SIZE - read_count);
+        if (bounce != nullptr) {
+          memcpy(page_data, bounce, PAGE_SIZE);
+        }
       }
-    }
-  } // end for
+      if (!ok) {
+        LOG(ERROR) << "I/O error while " << (is_write ? "writing" : "reading") << " asynchronously";
+      }
+      free(bounce);
+      finish(ok);
+    };
+    requests.push_back(std::move(request));
+  }
+  if (!requests.empty()) {
+    async_io->Submit(requests);
+  }
+  return future;
+}
 
-  meta_page->num_allocated_pages_++;
-  meta_page->extent_used_page_[i] = 1; // new extent
-  meta_page->num_extents_++;
+AsyncIO *DiskManager::GetAsyncIO() {
+  std::scoped_lock<std::mutex> lock(async_io_latch_);
+  if (async_io_ == nullptr && !closed) {
+    async_io_ = AsyncIO::Create(db_fd_, async_backend_);
+  }
+  return async_io_.get();
+}
 
-  physical_page_id = i * (BITMAP_SIZE + 1) + 1;
+/**
+ * TODO: Student Implement
+ * 在空闲extent位图中找到第一个还有空闲page的extent，在该块中分配一个page
+ */
+page_id_t DiskManager::AllocatePage() {
+  std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
 
-  ReadPhysicalPage(physical_page_id, buffer);
-  bitmap = reinterpret_cast<BitmapPage<PAGE_SIZE>*>(buffer);
-  if (bitmap->AllocatePage(page_offset)) {
-    WritePhysicalPage(physical_page_id, buffer);
-    WritePhysicalPage(META_PAGE_ID, meta_data_); // write meta data page
-    LOG(WARNING) << "dskmgr : Allocate logical page: " << i * BITMAP_SIZE + page_offset << std::endl;
-    return i * BITMAP_SIZE + page_offset;
-  } else {
+  auto *meta_page = reinterpret_cast<DiskFileMetaPage *>(meta_data_);
+  if (meta_page->GetAllocatedPages() >= MAX_VALID_PAGE_ID) {
+    return INVALID_PAGE_ID;
+  }
+  uint32_t extent_id = FindFreeExtent();
+  if (extent_id >= MAX_EXTENTS) {
+    return INVALID_PAGE_ID;
+  }
+  uint32_t page_offset;
+  if (!GetBitmap(extent_id)->AllocatePage(page_offset)) {
     LOG(ERROR) << "Failed to allocate page in bitmap" << std::endl;
+    return INVALID_PAGE_ID;
   }
+  bitmap_dirty_[extent_id] = true;
+  UpdateExtentUsedPages(extent_id, 1);
+  return extent_id * BITMAP_SIZE + page_offset;  // logical page id
+}
 
+page_id_t DiskManager::AllocatePages(uint32_t n) {
+  std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
+
+  auto *meta_page = reinterpret_cast<DiskFileMetaPage *>(meta_data_);
+  if (n == 0 || n > BITMAP_SIZE || meta_page->GetAllocatedPages() + n > MAX_VALID_PAGE_ID) {
+    return INVALID_PAGE_ID;
+  }
+  std::vector<uint32_t> page_offsets(n);
+  for (size_t i = 0; i < free_extents_.size(); i++) {
+    for (uint64_t word = free_extents_[i]; word != 0; word &= word - 1) {
+      uint32_t extent_id = i * 64 + __builtin_ctzll(word);
+      if (ExtentUsedPages(extent_id) + n > BITMAP_SIZE || !GetBitmap(extent_id)->AllocatePages(n, page_offsets.data())) {
+        continue;
+      }
+      bitmap_dirty_[extent_id] = true;
+      UpdateExtentUsedPages(extent_id, static_cast<int32_t>(n));
+      return extent_id * BITMAP_SIZE + page_offsets[0];
+    }
+  }
   return INVALID_PAGE_ID;
 }
 
-
 /**
  * TODO: Student Implement
  */
 void DiskManager::DeAllocatePage(page_id_t logical_page_id) {
+  std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
 
-  DiskFileMetaPage* meta_page = reinterpret_cast<DiskFileMetaPage*>(meta_data_);
   uint32_t extent_id = logical_page_id / BITMAP_SIZE;
-  uint32_t page_offset;
-
-  if (extent_id >= meta_page->GetExtentNums()) { // 0 ~ extent_num - 1
+  if (logical_page_id < 0 || extent_id >= MAX_EXTENTS || ExtentUsedPages(extent_id) == 0) {
     LOG(ERROR) << "Invalid extent id" << std::endl;
     return;
   }
-
-  char buffer[PAGE_SIZE];
-  page_id_t physical_page_id = extent_id * (BITMAP_SIZE + 1) + 1;
-  ReadPhysicalPage(physical_page_id, buffer);
-
-  BitmapPage<PAGE_SIZE>* bitmap = reinterpret_cast<BitmapPage<PAGE_SIZE>*>(buffer);
-
-  page_offset = MapPageId(logical_page_id) - physical_page_id - 1;
-
-  if (bitmap->DeAllocatePage(page_offset)) {
-    meta_page->num_allocated_pages_--;
-    meta_page->extent_used_page_[extent_id]--;
-    if (meta_page->extent_used_page_[extent_id] == 0) {
-      meta_page->num_extents_--;
-    }
-    WritePhysicalPage(physical_page_id, buffer);
-    WritePhysicalPage(META_PAGE_ID, meta_data_); // write meta data page
-  } else {
+  if (!GetBitmap(extent_id)->DeAllocatePage(logical_page_id % BITMAP_SIZE)) {
     LOG(ERROR) << "Failed to deallocate page in bitmap" << std::endl;
+    return;
   }
+  bitmap_dirty_[extent_id] = true;
+  UpdateExtentUsedPages(extent_id, -1);
 }
 
 /**
@@ -153,23 +274,108 @@ void DiskManager::DeAllocatePage(page_id_t logical_page_id) {
  * logical_page_id / BITMAP_SIZE = extent_id indicate which extent the page is located
  */
 bool DiskManager::IsPageFree(page_id_t logical_page_id) {
+  std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
 
-  char buffer[PAGE_SIZE];
-  DiskFileMetaPage* meta_page = reinterpret_cast<DiskFileMetaPage*>(meta_data_);
   uint32_t extent_id = logical_page_id / BITMAP_SIZE;
-  page_id_t physical_page_id = extent_id * (BITMAP_SIZE + 1) + 1;
-  uint32_t page_offset;
-
-  if (extent_id > meta_page->GetExtentNums()) {
+  if (logical_page_id < 0 || extent_id >= MAX_EXTENTS) {
     LOG(ERROR) << "Invalid extent id" << std::endl;
     return false;
   }
-  page_offset = MapPageId(logical_page_id) - physical_page_id - 1;
-  ReadPhysicalPage(physical_page_id, buffer);
-  BitmapPage<PAGE_SIZE>* bitmap = reinterpret_cast<BitmapPage<PAGE_SIZE>*>(buffer);
-  return bitmap->IsPageFree(page_offset);
+  // an extent without used page does not need its bitmap
+  if (ExtentUsedPages(extent_id) == 0) {
+    return true;
+  }
+  return GetBitmap(extent_id)->IsPageFree(logical_page_id % BITMAP_SIZE);
+}
 
-  return false;
+void DiskManager::Checkpoint() {
+  std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
+  for (uint32_t extent_id = 0; extent_id < bitmaps_.size(); extent_id++) {
+    if (bitmap_dirty_[extent_id]) {
+      WritePhysicalPage(BitmapPhysicalId(extent_id), bitmaps_[extent_id].get());
+      bitmap_dirty_[extent_id] = false;
+    }
+  }
+  for (uint32_t meta_page_id = 0; meta_page_id < MAX_META_PAGES; meta_page_id++) {
+    if (meta_dirty_[meta_page_id]) {
+      WritePhysicalPage(meta_page_id * META_GROUP_PAGES, reinterpret_cast<char *>(GetMetaPage(meta_page_id)));
+      meta_dirty_[meta_page_id] = false;
+    }
+  }
+}
+
+void DiskManager::InitFreeSpaceMap() {
+  meta_dirty_.assign(MAX_META_PAGES, false);
+  meta_pages_.resize(MAX_META_PAGES - 1);
+  for (uint32_t meta_page_id = 1; meta_page_id < MAX_META_PAGES; meta_page_id++) {
+    // meta pages past the end of the file read as zeros, i.e. groups without any used page
+    meta_pages_[meta_page_id - 1] = std::make_unique<char[]>(PAGE_SIZE);
+    ReadPhysicalPage(meta_page_id * META_GROUP_PAGES, meta_pages_[meta_page_id - 1].get());
+  }
+  free_extents_.assign((MAX_EXTENTS + 63) / 64, 0);
+  for (uint32_t extent_id = 0; extent_id < MAX_EXTENTS; extent_id++) {
+    UpdateFreeExtent(extent_id);
+  }
+}
+
+DiskFileMetaPage *DiskManager::GetMetaPage(uint32_t meta_page_id) {
+  char *data = meta_page_id == 0 ? meta_data_ : meta_pages_[meta_page_id - 1].get();
+  return reinterpret_cast<DiskFileMetaPage *>(data);
+}
+
+uint32_t &DiskManager::ExtentUsedPages(uint32_t extent_id) {
+  return GetMetaPage(extent_id / EXTENTS_PER_META_PAGE)->extent_used_page_[extent_id % EXTENTS_PER_META_PAGE];
+}
+
+void DiskManager::UpdateExtentUsedPages(uint32_t extent_id, int32_t delta) {
+  auto *meta_page = reinterpret_cast<DiskFileMetaPage *>(meta_data_);
+  uint32_t &used_pages = ExtentUsedPages(extent_id);
+  if (used_pages == 0) {
+    meta_page->num_extents_++;  // 该extent之前没有被使用过
+  }
+  used_pages += delta;
+  if (used_pages == 0) {
+    meta_page->num_extents_--;
+  }
+  meta_page->num_allocated_pages_ += delta;
+  meta_dirty_[0] = true;
+  meta_dirty_[extent_id / EXTENTS_PER_META_PAGE] = true;
+  UpdateFreeExtent(extent_id);
+}
+
+uint32_t DiskManager::FindFreeExtent() const {
+  for (size_t i = 0; i < free_extents_.size(); i++) {
+    if (free_extents_[i] != 0) {
+      return i * 64 + __builtin_ctzll(free_extents_[i]);
+    }
+  }
+  return MAX_EXTENTS;
+}
+
+void DiskManager::UpdateFreeExtent(uint32_t extent_id) {
+  uint64_t bit = uint64_t{1} << (extent_id % 64);
+  if (ExtentUsedPages(extent_id) < BITMAP_SIZE) {
+    free_extents_[extent_id / 64] |= bit;
+  } else {
+    free_extents_[extent_id / 64] &= ~bit;
+  }
+}
+
+BitmapPage<PAGE_SIZE> *DiskManager::GetBitmap(uint32_t extent_id) {
+  if (extent_id >= bitmaps_.size()) {
+    bitmaps_.resize(extent_id + 1);
+    bitmap_dirty_.resize(extent_id + 1, false);
+  }
+  if (bitmaps_[extent_id] == nullptr) {
+    bitmaps_[extent_id] = std::make_unique<char[]>(PAGE_SIZE);
+    ReadPhysicalPage(BitmapPhysicalId(extent_id), bitmaps_[extent_id].get());
+  }
+  return reinterpret_cast<BitmapPage<PAGE_SIZE> *>(bitmaps_[extent_id].get());
+}
+
+page_id_t DiskManager::BitmapPhysicalId(uint32_t extent_id) {
+  page_id_t group_entry = extent_id / EXTENTS_PER_META_PAGE * META_GROUP_PAGES;
+  return group_entry + 1 + extent_id % EXTENTS_PER_META_PAGE * (BITMAP_SIZE + 1);
 }
 
 /**
@@ -177,50 +383,66 @@ bool DiskManager::IsPageFree(page_id_t logical_page_id) {
  */
 page_id_t DiskManager::MapPageId(page_id_t logical_page_id) { // page_id_t in bit count
   page_id_t extent_id = logical_page_id / BITMAP_SIZE;
-  page_id_t physical_extent_entry = 1 + extent_id * (BITMAP_SIZE + 1);
+  page_id_t physical_extent_entry = BitmapPhysicalId(extent_id);
   page_id_t physical_page_id = physical_extent_entry + 1 + (logical_page_id % BITMAP_SIZE);
   return physical_page_id;
 }
 
-int DiskManager::GetFileSize(const std::string &file_name) {
+off_t DiskManager::GetFileSize() {
   struct stat stat_buf;
-  int rc = stat(file_name.c_str(), &stat_buf);
+  int rc = fstat(db_fd_, &stat_buf);
   return rc == 0 ? stat_buf.st_size : -1;
 }
 
 void DiskManager::ReadPhysicalPage(page_id_t physical_page_id, char *page_data) {
-  int offset = physical_page_id * PAGE_SIZE;
+  off_t offset = static_cast<off_t>(physical_page_id) * PAGE_SIZE;
   // check if read beyond file length
-  if (offset >= GetFileSize(file_name_)) {
+  if (offset >= file_size_) {
 #ifdef ENABLE_BPM_DEBUG
     LOG(INFO) << "Read less than a page" << std::endl;
 #endif
     memset(page_data, 0, PAGE_SIZE);
-  } else {
-    // set read cursor to offset
-    db_io_.seekp(offset);
-    db_io_.read(page_data, PAGE_SIZE);
-    // if file ends before reading PAGE_SIZE
-    int read_count = db_io_.gcount();
-    if (read_count < PAGE_SIZE) {
+    return;
+  }
+  // O_DIRECT needs page aligned buffers
+  alignas(PAGE_SIZE) static thread_local char bounce[PAGE_SIZE];
+  bool bounced = direct_io_ && reinterpret_cast<uintptr_t>(page_data) % PAGE_SIZE != 0;
+  char *buf = bounced ? bounce : page_data;
+  ssize_t read_count = pread(db_fd_, buf, PAGE_SIZE, offset);
+  if (read_count < 0) {
+    LOG(ERROR) << "I/O error while reading";
+    read_count = 0;
+  }
+  // if file ends before reading PAGE_SIZE
+  if (read_count < PAGE_SIZE) {
 #ifdef ENABLE_BPM_DEBUG
-      LOG(INFO) << "Read less than a page" << std::endl;
+    LOG(INFO) << "Read less than a page" << std::endl;
 #endif
-      memset(page_data + read_count, 0, PAGE_SIZE - read_count);
-    }
+    memset(buf + read_count, 0, PAGE_SIZE - read_count);
+  }
+  if (bounced) {
+    memcpy(page_data, bounce, PAGE_SIZE);
   }
 }
 
 void DiskManager::WritePhysicalPage(page_id_t physical_page_id, const char *page_data) {
-  size_t offset = static_cast<size_t>(physical_page_id) * PAGE_SIZE;
-  // set write cursor to offset
-  db_io_.seekp(offset);
-  db_io_.write(page_data, PAGE_SIZE);
+  off_t offset = static_cast<off_t>(physical_page_id) * PAGE_SIZE;
+  const char *buf = page_data;
+  if (direct_io_ && reinterpret_cast<uintptr_t>(page_data) % PAGE_SIZE != 0) {
+    alignas(PAGE_SIZE) static thread_local char bounce[PAGE_SIZE];
+    memcpy(bounce, page_data, PAGE_SIZE);
+    buf = bounce;
+  }
   // check for I/O error
-  if (db_io_.bad()) {
+  if (pwrite(db_fd_, buf, PAGE_SIZE, offset) != PAGE_SIZE) {
     LOG(ERROR) << "I/O error while writing";
     return;
   }
-  // needs to flush to keep disk file in sync
-  db_io_.flush();
-}
\ No newline at end of file
+  GrowFileSize(offset + PAGE_SIZE);
+}
+
+void DiskManager::GrowFileSize(off_t end) {
+  off_t size = file_size_;
+  while (size < end && !file_size_.compare_exchange_weak(size, end)) {
+  }
+}
@@ -1,53 +1,144 @@
 #include "storage/table_heap.h"
 
+#include <algorithm>
+#include <unordered_set>
+
 /**
  * TODO: Student Implement
  */
 
 bool TableHeap::InsertTuple(Row &row, Txn *txn) {
-  for (auto page_id = first_page_id_; page_id != INVALID_PAGE_ID; ) {
-
-    // fetch page from buffer pool by page_id
+  uint32_t serialized_size = row.GetSerializedSize(schema_);
+  if (serialized_size > TablePage::SIZE_MAX_ROW) {
+    return false;
+  }
+  std::scoped_lock<std::recursive_mutex> lock(fsm_latch_);
+  if (!LoadFreeSpaceMap()) {
+    return false;
+  }
+  // a page of this category surely has room for the tuple and its slot
+  int32_t index = FindFreeSpace(FreeSpaceMapPage::MinCategory(serialized_size + TablePage::SIZE_TUPLE));
+  if (index >= 0) {
+    page_id_t page_id = data_pages_[index];
     auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
-
-    if (page == nullptr)
+    if (page == nullptr) {
       return false;
+    }
     page->WLatch();
-
-    auto next_page_id = page->GetNextPageId();
-    if (page->InsertTuple(row, schema_, txn, lock_manager_, log_manager_)) {
-      page->WUnlatch();
-      buffer_pool_manager_->UnpinPage(page_id, true);
+    bool inserted = page->InsertTuple(row, schema_, txn, lock_manager_, log_manager_);
+    uint32_t free_space = page->GetFreeSpaceRemaining();
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(page_id, inserted);
+    SetCategory(index, FreeSpaceMapPage::ToCategory(free_space));
+    if (inserted) {
+      search_hint_ = index;
       return true;
-    } else {
-      page->WUnlatch();
     }
+  }
 
-    // If the page is full, then create a new page.
-    if (next_page_id == INVALID_PAGE_ID) {
-      page_id_t new_page_id;
-      auto new_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->NewPage(new_page_id));
-      if (new_page == nullptr)
-        return false;
+  // No page has enough space, append a new page to the chain.
+  page_id_t last_page_id = data_pages_.back();
+  page_id_t new_page_id;
+  auto new_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->NewPage(new_page_id, page_run_));
+  if (new_page == nullptr) {
+    return false;
+  }
+  new_page->WLatch();
+  new_page->Init(new_page_id, last_page_id, log_manager_, txn);
+  bool inserted = new_page->InsertTuple(row, schema_, txn, lock_manager_, log_manager_);
+  uint32_t free_space = new_page->GetFreeSpaceRemaining();
+  new_page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(new_page_id, true);
 
-      page->WLatch();
-      new_page->WLatch();
+  auto last_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(last_page_id));
+  ASSERT(last_page != nullptr, "Can not fetch the last page of the table.");
+  last_page->WLatch();
+  last_page->SetNextPageId(new_page_id);
+  last_page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(last_page_id, true);
 
-      new_page->Init(new_page->GetPageId(), page_id, log_manager_, txn);
-      new_page->SetPrevPageId(page_id);
-      page->SetNextPageId(new_page_id);
-      new_page->SetNextPageId(INVALID_PAGE_ID);
+  AppendFreeSpace(new_page_id, FreeSpaceMapPage::ToCategory(free_space));
+  search_hint_ = data_pages_.size() - 1;
+  return inserted;
+}
 
-      page->WUnlatch();
-      new_page->WUnlatch();
-      buffer_pool_manager_->UnpinPage(new_page_id, true);
+bool TableHeap::BulkInsert(std::vector<Row> &rows, Txn *txn) {
+  for (auto &row : rows) {
+    if (row.GetSerializedSize(schema_) > TablePage::SIZE_MAX_ROW) {
+      return false;
+    }
+  }
+  std::scoped_lock<std::recursive_mutex> lock(fsm_latch_);
+  if (!LoadFreeSpaceMap()) {
+    return false;
+  }
+  auto next_row = rows.begin();
+
+  // Fill up the last page first.
+  uint32_t last_index = data_pages_.size() - 1;
+  page_id_t last_page_id = data_pages_[last_index];
+  auto last_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(last_page_id));
+  if (last_page == nullptr) {
+    return false;
+  }
+  last_page->WLatch();
+  while (next_row != rows.end() && last_page->InsertTuple(*next_row, schema_, txn, lock_manager_, log_manager_)) {
+    ++next_row;
+  }
+  uint32_t free_space = last_page->GetFreeSpaceRemaining();
+  last_page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(last_page_id, next_row != rows.begin());
+  SetCategory(last_index, FreeSpaceMapPage::ToCategory(free_space));
+  if (next_row == rows.end()) {
+    return true;
+  }
+
+  // Build the new pages out of sight of readers, a page stays pinned until the page after it is linked.
+  page_id_t first_new_page_id = INVALID_PAGE_ID;
+  page_id_t prev_page_id = last_page_id;
+  TablePage *prev_page = nullptr;
+  bool success = true;
+  std::vector<std::pair<page_id_t, uint8_t>> new_pages;
+  while (next_row != rows.end()) {
+    page_id_t new_page_id;
+    auto new_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->NewPage(new_page_id, page_run_));
+    if (new_page == nullptr) {
+      success = false;
+      break;
+    }
+    new_page->Init(new_page_id, prev_page_id, log_manager_, txn);
+    while (next_row != rows.end() && new_page->InsertTuple(*next_row, schema_, txn, lock_manager_, log_manager_)) {
+      ++next_row;
+    }
+    if (prev_page == nullptr) {
+      first_new_page_id = new_page_id;
     } else {
-      buffer_pool_manager_->UnpinPage(page_id, false);
-      page_id = next_page_id;
+      prev_page->SetNextPageId(new_page_id);
+      buffer_pool_manager_->UnpinPage(prev_page_id, true);
     }
+    new_pages.emplace_back(new_page_id, FreeSpaceMapPage::ToCategory(new_page->GetFreeSpaceRemaining()));
+    prev_page_id = new_page_id;
+    prev_page = new_page;
+  }
+  if (prev_page != nullptr) {
+    buffer_pool_manager_->UnpinPage(prev_page_id, true);
+  }
+  if (first_new_page_id == INVALID_PAGE_ID) {
+    return false;
   }
 
-  return false;
+  // Link the new pages to the page chain.
+  last_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(last_page_id));
+  ASSERT(last_page != nullptr, "Can not fetch the last page of the table.");
+  last_page->WLatch();
+  last_page->SetNextPageId(first_new_page_id);
+  last_page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(last_page_id, true);
+  for (auto &[page_id, category] : new_pages) {
+    AppendFreeSpace(page_id, category);
+  }
+  search_hint_ = data_pages_.size() - 1;
+  return success;
 }
 
 bool TableHeap::MarkDelete(const RowId &rid, Txn *txn) {
@@ -59,7 +150,9 @@ bool TableHeap::MarkDelete(const RowId &rid, Txn *txn) {
   }
   // Otherwise, mark the tuple as deleted.
   page->WLatch();
-  page->MarkDelete(rid, txn, lock_manager_, log_manager_);
+  if (page->MarkDelete(rid, txn, lock_manager_, log_manager_)) {
+    dead_tuples_++;
+  }
   page->WUnlatch();
   buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
   return true;
@@ -80,13 +173,17 @@ bool TableHeap::UpdateTuple(Row &row, const RowId &rid, Txn *txn) {
 
   TablePage::UpdateStatus status = page->UpdateTuple(row, &old_row, schema_, txn, lock_manager_, log_manager_);
   if (status == TablePage::UpdateStatus::updateSuccess) {
+    uint32_t free_space = page->GetFreeSpaceRemaining();
     page->WUnlatch();
     buffer_pool_manager_->UnpinPage(rid.GetPageId(), true);
+    UpdateFreeSpace(rid.GetPageId(), free_space);
     return true;
   } else if (status == TablePage::UpdateStatus::notEnoughSpace) {
     page->ApplyDelete(rid, txn, log_manager_);
+    uint32_t free_space = page->GetFreeSpaceRemaining();
     page->WUnlatch();
     buffer_pool_manager_->UnpinPage(rid.GetPageId(), true);
+    UpdateFreeSpace(rid.GetPageId(), free_space);
     if (InsertTuple(row, txn)) {
       return true;
     } else {
@@ -115,8 +212,10 @@ void TableHeap::ApplyDelete(const RowId &rid, Txn *txn) {
   }
   page->WLatch();
   page->ApplyDelete(rid, txn, log_manager_);
+  uint32_t free_space = page->GetFreeSpaceRemaining();
   page->WUnlatch();
   buffer_pool_manager_->UnpinPage(rid.GetPageId(), true);
+  UpdateFreeSpace(rid.GetPageId(), free_space);
 }
 void TableHeap::RollbackDelete(const RowId &rid, Txn *txn) {
   // Find the page which contains the tuple.
@@ -126,6 +225,9 @@ void TableHeap::RollbackDelete(const RowId &rid, Txn *txn) {
   page->WLatch();
   page->RollbackDelete(rid, txn, log_manager_);
   page->WUnlatch();
+  if (dead_tuples_ > 0) {
+    dead_tuples_--;
+  }
   buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
 }
 
@@ -169,7 +271,344 @@ void TableHeap::DeleteTable(page_id_t page_id) {
     buffer_pool_manager_->DeletePage(page_id);
   } else {
     DeleteTable(first_page_id_);
+    DeleteFreeSpaceMap();
+  }
+}
+
+bool TableHeap::ConvertEarlierPages(Txn *txn, const MoveCallback &on_move) {
+  std::vector<Row> taken_out;
+  for (auto page_id = first_page_id_; page_id != INVALID_PAGE_ID;) {
+    auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+    if (page == nullptr) {
+      return false;
+    }
+    page->WLatch();
+    Row row;
+    if (page->ConvertEarlierFormat(&row, schema_)) {
+      taken_out.emplace_back(std::move(row));
+    }
+    auto next_page_id = page->GetNextPageId();
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(page_id, true);
+    page_id = next_page_id;
+  }
+  for (auto &row : taken_out) {
+    RowId old_rid = row.GetRowId();
+    if (!InsertTuple(row, txn)) {
+      return false;
+    }
+    if (on_move) {
+      on_move(row, old_rid);
+    }
+  }
+  return true;
+}
+
+TableHeap::VacuumStats TableHeap::Vacuum(Txn *txn, const MoveCallback &on_move) {
+  std::scoped_lock<std::recursive_mutex> lock(fsm_latch_);
+  VacuumStats stats;
+  if (!LoadFreeSpaceMap()) {
+    return stats;
+  }
+  // the last page kept, tuples of the pages after it move into it when they fit
+  page_id_t target_page_id = INVALID_PAGE_ID;
+  TablePage *target_page = nullptr;
+  std::vector<std::pair<page_id_t, uint8_t>> kept_pages;
+  std::vector<std::pair<Row, RowId>> moved_rows;
+  std::unordered_set<page_id_t> visited_pages;
+  page_id_t stop_page_id = INVALID_PAGE_ID;
+  auto keep_target = [&]() {
+    target_page->Compact();
+    kept_pages.emplace_back(target_page_id, FreeSpaceMapPage::ToCategory(target_page->GetFreeSpaceRemaining()));
+    target_page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(target_page_id, true);
+  };
+  for (auto page_id = first_page_id_; page_id != INVALID_PAGE_ID;) {
+    auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+    if (page == nullptr) {
+      // the pool is full, the pages from here on are left as they are
+      LOG(WARNING) << "Vacuum stopped at page " << page_id << " of the table, it can not be fetched";
+      stop_page_id = page_id;
+      break;
+    }
+    stats.pages_before_++;
+    visited_pages.insert(page_id);
+    page->WLatch();
+    auto next_page_id = page->GetNextPageId();
+    stats.rows_deleted_ += page->ApplyMarkedDeletes(txn, log_manager_);
+    if (target_page != nullptr) {
+      page->SetPrevPageId(target_page_id);
+      // Move all tuples of the page if they fit, a page is never split over two others.
+      std::vector<Row> rows;
+      uint32_t needed_space = 0;
+      RowId rid;
+      for (bool found = page->GetFirstTupleRid(&rid); found; found = page->GetNextTupleRid(rid, &rid)) {
+        rows.emplace_back(rid);
+        page->GetTuple(&rows.back(), schema_, txn, lock_manager_);
+        needed_space += rows.back().GetSerializedSize(schema_) + TablePage::SIZE_TUPLE;
+      }
+      if (needed_space <= target_page->GetFreeSpaceRemaining()) {
+        for (auto &row : rows) {
+          RowId old_rid = row.GetRowId();
+          bool __attribute__((unused)) inserted =
+              target_page->InsertTuple(row, schema_, txn, lock_manager_, log_manager_);
+          ASSERT(inserted, "Tuple does not fit in the page it is moved to.");
+          page->ApplyDelete(old_rid, txn, log_manager_);
+          moved_rows.emplace_back(std::move(row), old_rid);
+        }
+        stats.rows_moved_ += rows.size();
+      }
+    }
+    // The first page stays even if it is empty, its id is the id of the table heap.
+    if (target_page != nullptr && page->IsEmpty()) {
+      target_page->SetNextPageId(next_page_id);
+      page->WUnlatch();
+      buffer_pool_manager_->UnpinPage(page_id, false);
+      buffer_pool_manager_->DeletePage(page_id);
+      stats.pages_reclaimed_++;
+    } else {
+      if (target_page != nullptr) {
+        keep_target();
+      }
+      target_page_id = page_id;
+      target_page = page;
+    }
+    page_id = next_page_id;
   }
+  if (target_page == nullptr) {
+    return stats;
+  }
+  keep_target();
+  if (stop_page_id != INVALID_PAGE_ID) {
+    // The target links to the page it stopped at. Only the back link of that page may still name a deleted page, the
+    // frame the target held makes room to fix it.
+    auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(stop_page_id));
+    if (page != nullptr) {
+      page->WLatch();
+      page->SetPrevPageId(target_page_id);
+      page->WUnlatch();
+      buffer_pool_manager_->UnpinPage(stop_page_id, true);
+    }
+    // the pages not reached keep their entries
+    for (size_t i = 0; i < data_pages_.size(); i++) {
+      if (visited_pages.count(data_pages_[i]) == 0) {
+        kept_pages.emplace_back(data_pages_[i], categories_[i]);
+      }
+    }
+  } else {
+    dead_tuples_ = 0;
+  }
+  RewriteFreeSpaceMap(kept_pages);
+  if (on_move) {
+    for (auto &[row, old_rid] : moved_rows) {
+      on_move(row, old_rid);
+    }
+  }
+  return stats;
+}
+
+bool TableHeap::LoadFreeSpaceMap() {
+  if (fsm_loaded_) {
+    return true;
+  }
+  fsm_loaded_ = true;
+  if (fsm_page_id_ != INVALID_PAGE_ID) {
+    for (auto page_id = fsm_page_id_; page_id != INVALID_PAGE_ID;) {
+      auto page = buffer_pool_manager_->FetchPage(page_id);
+      if (page == nullptr) {
+        ClearFreeSpaceMap();
+        return false;
+      }
+      auto fsm_page = reinterpret_cast<FreeSpaceMapPage *>(page->GetData());
+      fsm_pages_.push_back(page_id);
+      for (uint32_t i = 0; i < fsm_page->GetCount(); i++) {
+        page_index_[fsm_page->GetPageId(i)] = data_pages_.size();
+        data_pages_.push_back(fsm_page->GetPageId(i));
+        categories_.push_back(fsm_page->GetCategory(i));
+      }
+      auto next_page_id = fsm_page->GetNextPageId();
+      buffer_pool_manager_->UnpinPage(page_id, false);
+      page_id = next_page_id;
+    }
+    block_max_.assign((categories_.size() + FSM_BLOCK_SIZE - 1) / FSM_BLOCK_SIZE, 0);
+    for (uint32_t i = 0; i < categories_.size(); i++) {
+      block_max_[i / FSM_BLOCK_SIZE] = std::max(block_max_[i / FSM_BLOCK_SIZE], categories_[i]);
+    }
+    return true;
+  }
+  // Tables written before the free space map existed, walk the page chain once.
+  CreateFreeSpaceMap();
+  for (auto page_id = first_page_id_; page_id != INVALID_PAGE_ID;) {
+    auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+    if (page == nullptr) {
+      // try again on the next write, from scratch
+      DeleteFreeSpaceMap();
+      return false;
+    }
+    page->RLatch();
+    uint32_t free_space = page->GetFreeSpaceRemaining();
+    auto next_page_id = page->GetNextPageId();
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    AppendFreeSpace(page_id, FreeSpaceMapPage::ToCategory(free_space));
+    page_id = next_page_id;
+  }
+  return true;
+}
+
+void TableHeap::CreateFreeSpaceMap() {
+  auto page = buffer_pool_manager_->NewPage(fsm_page_id_);
+  ASSERT(page != nullptr, "Can not allocate the free space map.");
+  reinterpret_cast<FreeSpaceMapPage *>(page->GetData())->Init();
+  buffer_pool_manager_->UnpinPage(fsm_page_id_, true);
+  fsm_pages_.push_back(fsm_page_id_);
+  fsm_loaded_ = true;
+}
+
+bool TableHeap::DeleteFreeSpaceMap() {
+  std::scoped_lock<std::recursive_mutex> lock(fsm_latch_);
+  bool deleted = true;
+  if (fsm_loaded_) {
+    // the pages are known, no need to read them
+    for (auto page_id : fsm_pages_) {
+      buffer_pool_manager_->DeletePage(page_id);
+    }
+  } else {
+    for (auto page_id = fsm_page_id_; page_id != INVALID_PAGE_ID;) {
+      auto page = buffer_pool_manager_->FetchPage(page_id);
+      if (page == nullptr) {
+        deleted = false;
+        break;
+      }
+      auto next_page_id = reinterpret_cast<FreeSpaceMapPage *>(page->GetData())->GetNextPageId();
+      buffer_pool_manager_->UnpinPage(page_id, false);
+      buffer_pool_manager_->DeletePage(page_id);
+      page_id = next_page_id;
+    }
+  }
+  fsm_page_id_ = INVALID_PAGE_ID;
+  ClearFreeSpaceMap();
+  return deleted;
+}
+
+void TableHeap::ClearFreeSpaceMap() {
+  fsm_loaded_ = false;
+  fsm_pages_.clear();
+  data_pages_.clear();
+  categories_.clear();
+  block_max_.clear();
+  page_index_.clear();
+  search_hint_ = 0;
+}
+
+void TableHeap::AppendFreeSpace(page_id_t page_id, uint8_t category) {
+  uint32_t index = data_pages_.size();
+  if (index == fsm_pages_.size() * FreeSpaceMapPage::CAPACITY) {
+    // the last FSM page is full, chain a new one
+    page_id_t new_page_id;
+    auto new_page = buffer_pool_manager_->NewPage(new_page_id);
+    ASSERT(new_page != nullptr, "Can not allocate the free space map.");
+    reinterpret_cast<FreeSpaceMapPage *>(new_page->GetData())->Init();
+    buffer_pool_manager_->UnpinPage(new_page_id, true);
+    auto last_page = buffer_pool_manager_->FetchPage(fsm_pages_.back());
+    ASSERT(last_page != nullptr, "Can not fetch the free space map.");
+    reinterpret_cast<FreeSpaceMapPage *>(last_page->GetData())->SetNextPageId(new_page_id);
+    buffer_pool_manager_->UnpinPage(fsm_pages_.back(), true);
+    fsm_pages_.push_back(new_page_id);
+  }
+  auto page = buffer_pool_manager_->FetchPage(fsm_pages_.back());
+  ASSERT(page != nullptr, "Can not fetch the free space map.");
+  reinterpret_cast<FreeSpaceMapPage *>(page->GetData())->Append(page_id, category);
+  buffer_pool_manager_->UnpinPage(fsm_pages_.back(), true);
+
+  page_index_[page_id] = index;
+  data_pages_.push_back(page_id);
+  categories_.push_back(category);
+  if (index % FSM_BLOCK_SIZE == 0) {
+    block_max_.push_back(category);
+  } else {
+    block_max_.back() = std::max(block_max_.back(), category);
+  }
+}
+
+void TableHeap::UpdateFreeSpace(page_id_t page_id, uint32_t free_space) {
+  std::scoped_lock<std::recursive_mutex> lock(fsm_latch_);
+  if (!LoadFreeSpaceMap()) {
+    return;
+  }
+  auto iter = page_index_.find(page_id);
+  if (iter != page_index_.end()) {
+    SetCategory(iter->second, FreeSpaceMapPage::ToCategory(free_space));
+  }
+}
+
+void TableHeap::RewriteFreeSpaceMap(const std::vector<std::pair<page_id_t, uint8_t>> &pages) {
+  auto page = buffer_pool_manager_->FetchPage(fsm_page_id_);
+  ASSERT(page != nullptr, "Can not fetch the free space map.");
+  reinterpret_cast<FreeSpaceMapPage *>(page->GetData())->Init();
+  buffer_pool_manager_->UnpinPage(fsm_page_id_, true);
+  for (size_t i = 1; i < fsm_pages_.size(); i++) {
+    buffer_pool_manager_->DeletePage(fsm_pages_[i]);
+  }
+  fsm_pages_.resize(1);
+  data_pages_.clear();
+  categories_.clear();
+  block_max_.clear();
+  page_index_.clear();
+  search_hint_ = 0;
+  for (auto &[page_id, category] : pages) {
+    AppendFreeSpace(page_id, category);
+  }
+}
+
+void TableHeap::SetCategory(uint32_t index, uint8_t category) {
+  uint8_t old_category = categories_[index];
+  if (category == old_category) {
+    return;
+  }
+  categories_[index] = category;
+  uint32_t block = index / FSM_BLOCK_SIZE;
+  if (category > block_max_[block]) {
+    block_max_[block] = category;
+  } else if (old_category == block_max_[block]) {
+    uint32_t begin = block * FSM_BLOCK_SIZE;
+    uint32_t end = std::min<uint32_t>(begin + FSM_BLOCK_SIZE, categories_.size());
+    block_max_[block] = *std::max_element(categories_.begin() + begin, categories_.begin() + end);
+  }
+  page_id_t fsm_page_id = fsm_pages_[index / FreeSpaceMapPage::CAPACITY];
+  auto page = buffer_pool_manager_->FetchPage(fsm_page_id);
+  if (page == nullptr) {
+    // categories are hints, a stale one only costs a failed insert attempt after a reload
+    return;
+  }
+  reinterpret_cast<FreeSpaceMapPage *>(page->GetData())->SetCategory(index % FreeSpaceMapPage::CAPACITY, category);
+  buffer_pool_manager_->UnpinPage(fsm_page_id, true);
+}
+
+int32_t TableHeap::FindFreeSpace(uint32_t min_category) {
+  if (min_category > UINT8_MAX || categories_.empty()) {
+    return -1;
+  }
+  if (search_hint_ < categories_.size() && categories_[search_hint_] >= min_category) {
+    return search_hint_;
+  }
+  // skip whole blocks of full pages, wrap around to the pages before the hint
+  uint32_t num_blocks = block_max_.size();
+  uint32_t first_block = std::min<uint32_t>(search_hint_, categories_.size() - 1) / FSM_BLOCK_SIZE;
+  for (uint32_t i = 0; i < num_blocks; i++) {
+    uint32_t block = (first_block + i) % num_blocks;
+    if (block_max_[block] < min_category) {
+      continue;
+    }
+    uint32_t begin = block * FSM_BLOCK_SIZE;
+    uint32_t end = std::min<uint32_t>(begin + FSM_BLOCK_SIZE, categories_.size());
+    for (uint32_t index = begin; index < end; index++) {
+      if (categories_[index] >= min_category) {
+        return index;
+      }
+    }
+  }
+  return -1;
 }
 
 /**
@@ -202,22 +641,19 @@ TableIterator TableHeap::Begin(Txn *txn) {
     {
       return End();
     }
-    auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+    auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id, kSequentialAccess));
+    page_id_t next_page_id = page->GetNextPageId();
     if(page->GetFirstTupleRid(&result_rid))
     {
       buffer_pool_manager_->UnpinPage(page_id, false);
-      break;
+      // the row is read when the iterator is dereferenced
+      TableIterator itr(this, Row(result_rid), txn);
+      itr.ReadAhead(page_id);
+      return TableIterator(itr);
     }
     buffer_pool_manager_->UnpinPage(page_id, false);
-    page_id = page->GetNextPageId();
-  }
-  if(page_id != INVALID_PAGE_ID)
-  {
-    Row* result_row = new Row(result_rid);
-    GetTuple(result_row, txn);
-    return TableIterator(this, *result_row, txn);
+    page_id = next_page_id;
   }
-  return End();
 }
 
 /**
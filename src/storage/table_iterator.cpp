@@ -7,12 +7,14 @@
  * TODO: Student Implement
  */
 TableIterator::TableIterator(TableHeap *table_heap, Row row, Txn *txn)
-  : heap(table_heap), row(row), txn(txn) {}
+  : heap(table_heap), row(row), txn(txn), row_loaded_(row.GetFieldCount() > 0) {}
 
 TableIterator::TableIterator(const TableIterator &other) {
   heap = other.heap;
   row = other.row;
   txn = other.txn;
+  row_loaded_ = other.row_loaded_;
+  read_ahead_distance_ = other.read_ahead_distance_;
 }
 
 TableIterator::TableIterator() {
@@ -34,58 +36,94 @@ bool TableIterator::operator!=(const TableIterator &itr) const {
 }
 
 const Row &TableIterator::operator*() {
+  if (!row_loaded_) {
+    auto page = PinCurrentPage();
+    page->RLatch();
+    row.destroy();
+    page->GetTuple(&row, heap->schema_, txn, heap->lock_manager_);
+    page->RUnlatch();
+    row_loaded_ = true;
+  }
   return row;
 }
 
 Row *TableIterator::operator->() {
-  return &row;
+  return const_cast<Row *>(&operator*());
+}
+
+const RowView &TableIterator::View() {
+  auto page = PinCurrentPage();
+  page->RLatch();
+  page->GetTupleView(row.GetRowId(), &view_, heap->schema_);
+  page->RUnlatch();
+  return view_;
 }
 
 TableIterator &TableIterator::operator=(const TableIterator &itr) noexcept {
   heap = itr.heap;
   row = itr.row;
   txn = itr.txn;
+  row_loaded_ = itr.row_loaded_;
+  page_guard_.Reset();
+  read_ahead_distance_ = itr.read_ahead_distance_;
   return *this;
 }
 
+TablePage *TableIterator::PinCurrentPage() {
+  page_id_t page_id = row.GetRowId().GetPageId();
+  if (page_guard_.GetPageId() != page_id) {
+    // scan fetches are tagged so that scan resistant replacers keep these pages in probation
+    page_guard_ = PageGuard(heap->buffer_pool_manager_, page_id, kSequentialAccess);
+  }
+  return page_guard_.As<TablePage>();
+}
+
 // ++iter
 TableIterator &TableIterator::operator++() {
   if (*this == heap->End()) {
     return *this;
   }
   RowId next_rid;
-  auto page = reinterpret_cast<TablePage *>(heap->buffer_pool_manager_->FetchPage(row.GetRowId().GetPageId()));
+  auto page = PinCurrentPage();
   page->RLatch();
-  if (page->GetNextTupleRid(row.GetRowId(), &next_rid)) {
-    row.destroy();
-    row.SetRowId(next_rid);
-    page->GetTuple(&row, heap->schema_, txn, heap->lock_manager_);
+  bool found = page->GetNextTupleRid(row.GetRowId(), &next_rid);
+  page_id_t next_page_id = page->GetNextPageId();
+  page->RUnlatch();
+  // the rows after the current one are on the following pages
+  while (!found && next_page_id != INVALID_PAGE_ID) {
+    page_guard_ = PageGuard(heap->buffer_pool_manager_, next_page_id, kSequentialAccess);
+    page = page_guard_.As<TablePage>();
+    page->RLatch();
+    ReadAhead(next_page_id);
+    found = page->GetFirstTupleRid(&next_rid);
+    next_page_id = page->GetNextPageId();
     page->RUnlatch();
-    heap->buffer_pool_manager_->UnpinPage(page->GetTablePageId(), false);
+  }
+  if (!found) {
+    *this = heap->End();
     return *this;
-  } else { // no next tuple in this page
-
-    page_id_t next_page_id = page->GetNextPageId();
-    while (next_page_id != INVALID_PAGE_ID) { // find next page
-      page->RUnlatch();
-      heap->buffer_pool_manager_->UnpinPage(page->GetTablePageId(), false);
-      page = reinterpret_cast<TablePage *>(heap->buffer_pool_manager_->FetchPage(next_page_id));
-      page->RLatch();
-      if (page->GetFirstTupleRid(&next_rid)) {
-        row.destroy();
-        row.SetRowId(next_rid);
-        page->GetTuple(&row, heap->schema_, txn, heap->lock_manager_);
-        page->RUnlatch();
-        heap->buffer_pool_manager_->UnpinPage(page->GetTablePageId(), false);
-        return *this;
-      }
-    }
   }
-  page->RUnlatch();
-  heap->buffer_pool_manager_->UnpinPage(page->GetTablePageId(), false);
-  *this = heap->End();
+  row.destroy();
+  row.SetRowId(next_rid);
+  row_loaded_ = false;
   return *this;
+}
+
+// the prefetcher follows the links of table pages
+static page_id_t NextTablePage(Page *page) { return reinterpret_cast<TablePage *>(page)->GetNextPageId(); }
 
+void TableIterator::ReadAhead(page_id_t page_id) {
+  if (heap->read_ahead_pages_ == 0) {
+    return;
+  }
+  if (read_ahead_distance_ > 0) {
+    read_ahead_distance_--;
+  }
+  // refill once half of the window was consumed, the walk passes the pages already requested without I/O
+  if (read_ahead_distance_ <= heap->read_ahead_pages_ / 2) {
+    heap->buffer_pool_manager_->PrefetchChain(page_id, heap->read_ahead_pages_, NextTablePage);
+    read_ahead_distance_ = heap->read_ahead_pages_;
+  }
 }
 
 // iter++
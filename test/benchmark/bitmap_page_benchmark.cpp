@@ -0,0 +1,87 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "glog/logging.h"
+#include "page/bitmap_page.h"
+#include "utils/timer.h"
+
+/**
+ * Free page search of BitmapPage on one extent of PAGE_SIZE, i.e. 8 * (PAGE_SIZE - 8) pages.
+ * Usage: bitmap_page_benchmark [rounds]
+ */
+using Bitmap = BitmapPage<PAGE_SIZE>;
+
+/** Byte by byte search through the public API, what a scan did before the word-at-a-time search. */
+static uint32_t ScalarFindFree(const Bitmap *bitmap) {
+  for (uint32_t i = 0; i < Bitmap::GetMaxSupportedSize(); i++) {
+    if (bitmap->IsPageFree(i)) {
+      return i;
+    }
+  }
+  return Bitmap::GetMaxSupportedSize();
+}
+
+int main(int argc, char **argv) {
+  google::InitGoogleLogging(argv[0]);
+  FLAGS_minloglevel = google::GLOG_ERROR;
+  const int rounds = argc > 1 ? atoi(argv[1]) : 200;
+  const uint32_t num_pages = Bitmap::GetMaxSupportedSize();
+  alignas(PAGE_SIZE) char buf[PAGE_SIZE];
+  auto *bitmap = reinterpret_cast<Bitmap *>(buf);
+  uint32_t ofs;
+  printf("pages per extent: %u, rounds: %d\n", num_pages, rounds);
+
+  // fill an empty extent one page at a time
+  Timer timer;
+  for (int r = 0; r < rounds; r++) {
+    memset(buf, 0, PAGE_SIZE);
+    for (uint32_t i = 0; i < num_pages; i++) {
+      bitmap->AllocatePage(ofs);
+    }
+  }
+  printf("%-32s ns/page: %8.2f\n", "fill, AllocatePage", timer.Elapsed() * 1e9 / rounds / num_pages);
+
+  // fill an empty extent by runs of 64 pages
+  std::vector<uint32_t> run(64);
+  timer.Reset();
+  for (int r = 0; r < rounds; r++) {
+    memset(buf, 0, PAGE_SIZE);
+    while (bitmap->AllocatePages(run.size(), run.data())) {
+    }
+  }
+  printf("%-32s ns/page: %8.2f\n", "fill, AllocatePages(64)", timer.Elapsed() * 1e9 / rounds / num_pages);
+
+  // full extent whose only free page is the last one, the search has to cross the whole bitmap
+  memset(buf, 0, PAGE_SIZE);
+  for (uint32_t i = 0; i < num_pages; i++) {
+    bitmap->AllocatePage(ofs);
+  }
+  const int searches = rounds * 100;
+  timer.Reset();
+  for (int r = 0; r < searches; r++) {
+    bitmap->DeAllocatePage(0);
+    bitmap->DeAllocatePage(num_pages - 1);
+    bitmap->AllocatePage(ofs);
+    bitmap->AllocatePage(ofs);
+  }
+  if (ofs != num_pages - 1) {
+    fprintf(stderr, "unexpected page %u\n", ofs);
+    return 1;
+  }
+  printf("%-32s ns/search: %8.0f\n", "full extent, word scan", timer.Elapsed() * 1e9 / searches);
+
+  bitmap->DeAllocatePage(num_pages - 1);
+  uint32_t found = 0;
+  timer.Reset();
+  for (int r = 0; r < searches; r++) {
+    found += ScalarFindFree(bitmap);
+  }
+  if (found != static_cast<uint32_t>(searches) * (num_pages - 1)) {
+    fprintf(stderr, "unexpected scalar result\n");
+    return 1;
+  }
+  printf("%-32s ns/search: %8.0f\n", "full extent, bit by bit scan", timer.Elapsed() * 1e9 / searches);
+  return 0;
+}
@@ -0,0 +1,72 @@
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "glog/logging.h"
+#include "utils/timer.h"
+
+/**
+ * Multi-threaded FetchPage/UnpinPage throughput, all accesses are buffer pool hits so that the numbers measure the
+ * latching of the buffer pool only.
+ */
+static double RunFetchUnpin(BufferPoolManager *bpm, const std::vector<page_id_t> &pages, int num_threads,
+                            size_t ops_per_thread) {
+  std::vector<std::thread> threads;
+  Timer timer;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&, t] {
+      std::mt19937 rng(t);
+      std::uniform_int_distribution<size_t> dist(0, pages.size() - 1);
+      for (size_t i = 0; i < ops_per_thread; i++) {
+        page_id_t page_id = pages[dist(rng)];
+        Page *page = bpm->FetchPage(page_id);
+        if (page == nullptr) {
+          fprintf(stderr, "failed to fetch page %d\n", page_id);
+          exit(1);
+        }
+        bpm->UnpinPage(page_id, false);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  return num_threads * ops_per_thread / timer.Elapsed();
+}
+
+int main(int argc, char **argv) {
+  google::InitGoogleLogging(argv[0]);
+  FLAGS_minloglevel = google::GLOG_ERROR;
+  size_t pool_size = argc > 1 ? strtoul(argv[1], nullptr, 10) : 4096;
+  size_t ops_per_thread = argc > 2 ? strtoul(argv[2], nullptr, 10) : 200000;
+  const std::string db_name = "bpm_benchmark.db";
+  printf("pool size: %zu, ops per thread: %zu, hardware threads: %u\n", pool_size, ops_per_thread,
+         std::thread::hardware_concurrency());
+
+  for (size_t num_instances : {static_cast<size_t>(1), static_cast<size_t>(16)}) {
+    remove(db_name.c_str());
+    auto *disk_manager = new DiskManager(db_name);
+    auto *bpm = new BufferPoolManager(pool_size, disk_manager, kLRUReplacer, num_instances);
+    std::vector<page_id_t> pages;
+    for (size_t i = 0; i < pool_size / 2; i++) {
+      page_id_t page_id;
+      if (bpm->NewPage(page_id) == nullptr) {
+        break;
+      }
+      bpm->UnpinPage(page_id, false);
+      pages.push_back(page_id);
+    }
+    for (int num_threads : {1, 2, 4, 8, 16}) {
+      double ops = RunFetchUnpin(bpm, pages, num_threads, ops_per_thread);
+      printf("instances: %2zu  threads: %2d  fetch+unpin/s: %12.0f\n", num_instances, num_threads, ops);
+    }
+    delete bpm;
+    delete disk_manager;
+  }
+  remove(db_name.c_str());
+  return 0;
+}
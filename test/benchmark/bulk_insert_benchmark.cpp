@@ -0,0 +1,69 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "glog/logging.h"
+#include "record/field.h"
+#include "record/schema.h"
+#include "storage/table_heap.h"
+#include "utils/timer.h"
+
+/**
+ * Loads of narrow rows into an empty table, one InsertTuple per row against BulkInsert of batches. Only the inserts
+ * are timed, the rows of a batch are built before.
+ */
+int main(int argc, char **argv) {
+  google::InitGoogleLogging(argv[0]);
+  FLAGS_minloglevel = google::GLOG_ERROR;
+  const std::string db_name = "bulk_insert_benchmark.db";
+  const int row_nums = argc > 1 ? atoi(argv[1]) : 1000000;
+  const int batch_size = argc > 2 ? atoi(argv[2]) : 10000;
+
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 32, 1, true, false),
+                                   new Column("account", TypeId::kTypeFloat, 2, true, false)};
+  Schema schema(columns);
+  char characters[32];
+  memset(characters, 'x', sizeof(characters));
+
+  printf("rows: %d, batch size: %d\n", row_nums, batch_size);
+  for (bool bulk : {false, true}) {
+    remove(db_name.c_str());
+    auto *disk_manager = new DiskManager(db_name);
+    auto *bpm = new BufferPoolManager(DEFAULT_BUFFER_POOL_SIZE, disk_manager);
+    TableHeap *table_heap = TableHeap::Create(bpm, &schema, nullptr, nullptr, nullptr);
+    double elapsed = 0;
+    for (int begin = 0; begin < row_nums; begin += batch_size) {
+      std::vector<Row> rows;
+      for (int i = begin; i < std::min(begin + batch_size, row_nums); i++) {
+        std::vector<Field> fields{Field(TypeId::kTypeInt, i),
+                                  Field(TypeId::kTypeChar, characters, sizeof(characters), false),
+                                  Field(TypeId::kTypeFloat, 1.5f)};
+        rows.emplace_back(fields);
+      }
+      Timer timer;
+      bool inserted = true;
+      if (bulk) {
+        inserted = table_heap->BulkInsert(rows, nullptr);
+      } else {
+        for (auto &row : rows) {
+          inserted = inserted && table_heap->InsertTuple(row, nullptr);
+        }
+      }
+      elapsed += timer.Elapsed();
+      if (!inserted) {
+        fprintf(stderr, "failed to insert rows from %d\n", begin);
+        return 1;
+      }
+    }
+    printf("%-12s  time: %.3fs  rows/s: %12.0f\n", bulk ? "BulkInsert" : "InsertTuple", elapsed, row_nums / elapsed);
+    delete table_heap;
+    delete bpm;
+    delete disk_manager;
+  }
+  remove(db_name.c_str());
+  return 0;
+}
@@ -0,0 +1,80 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <future>
+#include <string>
+#include <vector>
+
+#include "glog/logging.h"
+#include "storage/disk_manager.h"
+#include "utils/timer.h"
+
+/**
+ * Page write-back and read throughput of the synchronous DiskManager path against the asynchronous backends.
+ * Usage: disk_io_benchmark [num_pages] [direct_io]
+ */
+static const char *BackendName(AsyncIO::Backend backend) {
+  return backend == AsyncIO::kIoUring ? "io_uring" : "thread pool";
+}
+
+int main(int argc, char **argv) {
+  google::InitGoogleLogging(argv[0]);
+  FLAGS_minloglevel = google::GLOG_ERROR;
+  const std::string db_name = "disk_io_benchmark.db";
+  const int num_pages = argc > 1 ? atoi(argv[1]) : 8192;
+  const bool direct_io = argc > 2 && atoi(argv[2]) != 0;
+
+  std::vector<char> data(static_cast<size_t>(num_pages) * PAGE_SIZE);
+  for (int i = 0; i < num_pages; i++) {
+    memset(data.data() + static_cast<size_t>(i) * PAGE_SIZE, i, PAGE_SIZE);
+  }
+  std::vector<std::pair<page_id_t, const char *>> batch;
+  for (int i = 0; i < num_pages; i++) {
+    batch.emplace_back(i, data.data() + static_cast<size_t>(i) * PAGE_SIZE);
+  }
+  std::vector<char> buffer(static_cast<size_t>(num_pages) * PAGE_SIZE);
+
+  remove(db_name.c_str());
+  auto *disk_manager = new DiskManager(db_name, direct_io);
+  printf("pages: %d, direct I/O: %s\n", num_pages, disk_manager->IsDirectIO() ? "yes" : "no");
+
+  Timer timer;
+  for (auto &page : batch) {
+    disk_manager->WritePage(page.first, page.second);
+  }
+  printf("%-12s write pages/s: %10.0f\n", "sync", num_pages / timer.Elapsed());
+  timer.Reset();
+  for (int i = 0; i < num_pages; i++) {
+    disk_manager->ReadPage(i, buffer.data() + static_cast<size_t>(i) * PAGE_SIZE);
+  }
+  printf("%-12s read pages/s:  %10.0f\n", "sync", num_pages / timer.Elapsed());
+  delete disk_manager;
+
+  for (auto backend : {AsyncIO::kIoUring, AsyncIO::kThreadPool}) {
+    disk_manager = new DiskManager(db_name, direct_io, backend);
+    const char *name = BackendName(disk_manager->GetAsyncIOBackend());
+    timer.Reset();
+    if (!disk_manager->WritePagesAsync(batch).get()) {
+      fprintf(stderr, "async write failed\n");
+      return 1;
+    }
+    printf("%-12s write pages/s: %10.0f\n", name, num_pages / timer.Elapsed());
+    timer.Reset();
+    std::vector<std::future<bool>> futures;
+    futures.reserve(num_pages);
+    for (int i = 0; i < num_pages; i++) {
+      futures.push_back(disk_manager->ReadPageAsync(i, buffer.data() + static_cast<size_t>(i) * PAGE_SIZE));
+    }
+    for (auto &future : futures) {
+      future.get();
+    }
+    printf("%-12s read pages/s:  %10.0f\n", name, num_pages / timer.Elapsed());
+    delete disk_manager;
+  }
+  if (memcmp(buffer.data(), data.data(), buffer.size()) != 0) {
+    fprintf(stderr, "read back data differs\n");
+    return 1;
+  }
+  remove(db_name.c_str());
+  return 0;
+}
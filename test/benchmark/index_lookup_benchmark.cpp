@@ -0,0 +1,102 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "common/instance.h"
+#include "glog/logging.h"
+#include "index/b_plus_tree.h"
+#include "utils/timer.h"
+
+/**
+ * B+ tree point lookups on an int key and on an (int, char) key, keys are looked up in random order. Heap allocations
+ * are counted by replacing the global operator new of this executable.
+ * Usage: index_lookup_benchmark [num_keys] [rounds]
+ */
+static std::atomic<size_t> allocations{0};
+
+void *operator new(size_t size) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void *p = malloc(size == 0 ? 1 : size)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+void *operator new[](size_t size) { return operator new(size); }
+
+void operator delete(void *p) noexcept { free(p); }
+
+void operator delete[](void *p) noexcept { free(p); }
+
+void operator delete(void *p, size_t) noexcept { free(p); }
+
+void operator delete[](void *p, size_t) noexcept { free(p); }
+
+template <size_t KeySize>
+static void Run(const char *name, DBStorageEngine *engine, index_id_t index_id, Schema *key_schema, int num_keys,
+                int rounds) {
+  KeyManager key_manager(key_schema);
+  std::vector<int> ids(num_keys);
+  for (int i = 0; i < num_keys; i++) {
+    ids[i] = i;
+  }
+  std::shuffle(ids.begin(), ids.end(), std::mt19937(42));
+  std::vector<GenericKey<KeySize>> keys(num_keys);
+  for (int i = 0; i < num_keys; i++) {
+    int id = ids[i];
+    std::vector<Field> fields{Field(TypeId::kTypeInt, id)};
+    std::string text = "key-" + std::to_string(id % 1000);
+    if (key_schema->GetColumnCount() > 1) {
+      // a thousand keys share each int, so the char column is compared too
+      fields.clear();
+      fields.emplace_back(TypeId::kTypeInt, id / 1000);
+      fields.emplace_back(TypeId::kTypeChar, const_cast<char *>(text.c_str()), text.size(), true);
+    }
+    key_manager.SerializeFromKey(&keys[i], Row(std::move(fields)), key_schema);
+  }
+  BPlusTree<KeySize> tree(index_id, engine->bpm_, key_manager);
+  for (int i = 0; i < num_keys; i++) {
+    tree.Insert(&keys[i], RowId(ids[i]));
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(7));
+  std::vector<RowId> result;
+  result.reserve(1);
+  size_t found = 0;
+  size_t before = allocations.load();
+  Timer timer;
+  for (int round = 0; round < rounds; round++) {
+    for (auto &key : keys) {
+      result.clear();
+      found += tree.GetValue(&key, result);
+    }
+  }
+  double elapsed = timer.Elapsed();
+  double lookups = static_cast<double>(num_keys) * rounds;
+  printf("%-16s lookups/s: %12.0f  ns/lookup: %7.1f  allocations/lookup: %6.2f  (%zu found)\n", name,
+         lookups / elapsed, elapsed * 1e9 / lookups, (allocations.load() - before) / lookups, found);
+}
+
+int main(int argc, char **argv) {
+  google::InitGoogleLogging(argv[0]);
+  FLAGS_minloglevel = google::GLOG_ERROR;
+  const int num_keys = argc > 1 ? atoi(argv[1]) : 100000;
+  const int rounds = argc > 2 ? atoi(argv[2]) : 5;
+  const std::string db_name = "index_lookup_benchmark.db";
+  auto *engine = new DBStorageEngine(db_name, true, DEFAULT_BUFFER_POOL_SIZE * 4);
+  printf("keys: %d, rounds: %d\n", num_keys, rounds);
+
+  Schema int_schema(std::vector<Column *>{new Column("id", TypeId::kTypeInt, 0, false, false)});
+  Run<8>("int", engine, 0, &int_schema, num_keys, rounds);
+  Schema composite_schema(std::vector<Column *>{new Column("group", TypeId::kTypeInt, 0, false, false),
+                                                new Column("name", TypeId::kTypeChar, 16, 1, false, false)});
+  Run<32>("(int, char(16))", engine, 1, &composite_schema, num_keys, rounds);
+
+  delete engine;
+  remove(("./databases/" + db_name).c_str());
+  return 0;
+}
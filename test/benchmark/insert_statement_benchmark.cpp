@@ -0,0 +1,74 @@
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "common/instance.h"
+#include "executor/execute_context.h"
+#include "executor/execute_engine.h"
+#include "glog/logging.h"
+#include "planner/planner.h"
+#include "utils/timer.h"
+
+extern "C" {
+int yyparse(void);
+#include "parser/minisql_lex.h"
+#include "parser/parser.h"
+}
+
+/**
+ * Loads of narrow rows into an empty table through INSERT statements, parsed, planned and executed, one row per
+ * statement against multi-row VALUES lists. Building the statement text is not timed.
+ */
+int main(int argc, char **argv) {
+  google::InitGoogleLogging(argv[0]);
+  FLAGS_minloglevel = google::GLOG_ERROR;
+  const std::string db_name = "insert_statement_benchmark.db";
+  const int row_nums = argc > 1 ? atoi(argv[1]) : 1000000;
+  const int batch_size = argc > 2 ? atoi(argv[2]) : 1000;
+  const std::string name = "\"xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx\"";
+
+  printf("rows: %d, rows per statement: %d\n", row_nums, batch_size);
+  ExecuteEngine execute_engine;
+  for (int rows_per_statement : {1, batch_size}) {
+    auto *engine = new DBStorageEngine(db_name, true);
+    std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                     new Column("name", TypeId::kTypeChar, 32, 1, true, false),
+                                     new Column("account", TypeId::kTypeFloat, 2, true, false)};
+    Schema schema(columns);
+    TableInfo *table_info = nullptr;
+    engine->catalog_mgr_->CreateTable("t", &schema, nullptr, table_info);
+    double elapsed = 0;
+    size_t inserted = 0;
+    for (int begin = 0; begin < row_nums; begin += rows_per_statement) {
+      std::string sql = "insert into t values ";
+      for (int i = begin; i < std::min(begin + rows_per_statement, row_nums); i++) {
+        sql += (i == begin ? "(" : ", (") + std::to_string(i) + ", " + name + ", 1.5)";
+      }
+      sql += ";";
+      Timer timer;
+      YY_BUFFER_STATE bp = yy_scan_string(sql.c_str());
+      yy_switch_to_buffer(bp);
+      MinisqlParserInit();
+      yyparse();
+      auto context = engine->MakeExecuteContext(nullptr);
+      Planner planner(context.get());
+      planner.PlanQuery(MinisqlGetParserRootNode());
+      std::vector<Row> result_set;
+      execute_engine.ExecutePlan(planner.plan_, &result_set, nullptr, context.get());
+      MinisqlParserFinish();
+      yy_delete_buffer(bp);
+      yylex_destroy();
+      elapsed += timer.Elapsed();
+      inserted += result_set.size();
+    }
+    if (inserted != static_cast<size_t>(row_nums)) {
+      fprintf(stderr, "inserted %zu rows of %d\n", inserted, row_nums);
+      return 1;
+    }
+    printf("%5d rows/statement  time: %.3fs  rows/s: %12.0f\n", rows_per_statement, elapsed, row_nums / elapsed);
+    delete engine;
+  }
+  remove(db_name.c_str());
+  return 0;
+}
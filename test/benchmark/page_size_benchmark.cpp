@@ -0,0 +1,94 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "common/instance.h"
+#include "glog/logging.h"
+#include "index/b_plus_tree.h"
+#include "storage/table_heap.h"
+#include "utils/timer.h"
+
+/**
+ * B+ tree and table heap throughput for the PAGE_SIZE of this build. Configure builds with different
+ * -DMINISQL_PAGE_SIZE to compare page sizes against each other.
+ * Usage: page_size_benchmark [num_keys] [num_rows] [pool_pages]
+ */
+int main(int argc, char **argv) {
+  google::InitGoogleLogging(argv[0]);
+  FLAGS_minloglevel = google::GLOG_ERROR;
+  const int num_keys = argc > 1 ? atoi(argv[1]) : 100000;
+  const int num_rows = argc > 2 ? atoi(argv[2]) : 20000;
+  // the pool holds the same number of bytes whatever the page size
+  const size_t pool_bytes = static_cast<size_t>(argc > 3 ? atoi(argv[3]) : 1024) * 4096;
+  const size_t pool_size = pool_bytes / PAGE_SIZE;
+  const std::string db_name = "page_size_benchmark.db";
+  printf("page size: %d, pool: %zu pages (%zu KB)\n", PAGE_SIZE, pool_size, pool_bytes / 1024);
+
+  auto *engine = new DBStorageEngine(db_name, true, pool_size);
+  std::vector<Column *> key_columns = {new Column("id", TypeId::kTypeInt, 0, false, false)};
+  Schema key_schema(key_columns);
+  KeyManager key_manager(&key_schema);
+  std::vector<int> ids(num_keys);
+  for (int i = 0; i < num_keys; i++) {
+    ids[i] = i;
+  }
+  std::shuffle(ids.begin(), ids.end(), std::mt19937(42));
+  std::vector<GenericKey<16>> keys(num_keys);
+  for (int i = 0; i < num_keys; i++) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, ids[i])};
+    key_manager.SerializeFromKey(&keys[i], Row(fields), &key_schema);
+  }
+  {
+    BPlusTree<16> tree(0, engine->bpm_, key_manager);
+    Timer timer;
+    for (int i = 0; i < num_keys; i++) {
+      tree.Insert(&keys[i], RowId(ids[i]));
+    }
+    printf("%-24s keys/s: %12.0f\n", "b+ tree random insert", num_keys / timer.Elapsed());
+    std::vector<RowId> result;
+    timer.Reset();
+    for (int i = 0; i < num_keys; i++) {
+      tree.GetValue(&keys[i], result);
+    }
+    printf("%-24s keys/s: %12.0f\n", "b+ tree point lookup", num_keys / timer.Elapsed());
+    timer.Reset();
+    int count = 0;
+    for (auto itr = tree.Begin(); itr != tree.End(); ++itr) {
+      count++;
+    }
+    printf("%-24s keys/s: %12.0f (%d keys)\n", "b+ tree leaf scan", count / timer.Elapsed(), count);
+  }
+
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 256, 1, true, false)};
+  Schema schema(columns);
+  TableHeap *table_heap = TableHeap::Create(engine->bpm_, &schema, nullptr, nullptr, nullptr);
+  table_heap->SetReadAhead(0);
+  char characters[256];
+  memset(characters, 'x', sizeof(characters));
+  Timer timer;
+  for (int i = 0; i < num_rows; i++) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i),
+                              Field(TypeId::kTypeChar, characters, sizeof(characters), false)};
+    Row row(fields);
+    table_heap->InsertTuple(row, nullptr);
+  }
+  printf("%-24s rows/s: %12.0f\n", "table heap insert", num_rows / timer.Elapsed());
+  timer.Reset();
+  int count = 0;
+  for (auto itr = table_heap->Begin(nullptr); itr != table_heap->End(); itr++) {
+    count++;
+  }
+  printf("%-24s rows/s: %12.0f (%d rows)\n", "table heap scan", count / timer.Elapsed(), count);
+  delete table_heap;
+
+  auto *meta_page = reinterpret_cast<DiskFileMetaPage *>(engine->disk_mgr_->GetMetaData());
+  printf("pages allocated: %u (%u KB)\n", meta_page->GetAllocatedPages(),
+         static_cast<uint32_t>(static_cast<uint64_t>(meta_page->GetAllocatedPages()) * PAGE_SIZE / 1024));
+  delete engine;
+  remove(("./databases/" + db_name).c_str());
+  return 0;
+}
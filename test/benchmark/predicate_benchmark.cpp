@@ -0,0 +1,109 @@
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "common/instance.h"
+#include "executor/execute_context.h"
+#include "executor/execute_engine.h"
+#include "executor/plans/seq_scan_plan.h"
+#include "glog/logging.h"
+#include "index/generic_key.h"
+#include "planner/expressions/column_value_expression.h"
+#include "planner/expressions/comparison_expression.h"
+#include "planner/expressions/constant_value_expression.h"
+#include "planner/expressions/logic_expression.h"
+#include "utils/timer.h"
+
+/**
+ * Comparison heavy work: SELECT id FROM t WHERE id >= 0 AND account < 500 AND name <> 'none' through the executors,
+ * every row evaluates the three comparisons, and comparisons of (int, char) index keys as done by the B+ tree.
+ */
+int main(int argc, char **argv) {
+  google::InitGoogleLogging(argv[0]);
+  FLAGS_minloglevel = google::GLOG_ERROR;
+  const int row_nums = argc > 1 ? atoi(argv[1]) : 100000;
+  const int rounds = argc > 2 ? atoi(argv[2]) : 5;
+
+  auto *engine = new DBStorageEngine("predicate_benchmark.db", true, DEFAULT_BUFFER_POOL_SIZE * 4);
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 32, 1, true, false),
+                                   new Column("account", TypeId::kTypeFloat, 2, true, false)};
+  Schema schema(columns);
+  TableInfo *table_info = nullptr;
+  engine->catalog_mgr_->CreateTable("t", &schema, nullptr, table_info);
+  std::vector<Row> rows;
+  for (int i = 0; i < row_nums; i++) {
+    std::string name = "name-" + std::to_string(i);
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i),
+                              Field(TypeId::kTypeChar, const_cast<char *>(name.c_str()), name.size(), true),
+                              Field(TypeId::kTypeFloat, static_cast<float>(i % 1000))};
+    rows.emplace_back(std::move(fields));
+  }
+  if (!table_info->GetTableHeap()->BulkInsert(rows, nullptr)) {
+    fprintf(stderr, "failed to load the table\n");
+    return 1;
+  }
+
+  auto id = std::make_shared<ColumnValueExpression>(0, 0, TypeId::kTypeInt);
+  auto name = std::make_shared<ColumnValueExpression>(0, 1, TypeId::kTypeChar);
+  auto account = std::make_shared<ColumnValueExpression>(0, 2, TypeId::kTypeFloat);
+  char none[] = "none";
+  auto id_ge = std::make_shared<ComparisonExpression>(
+      id, std::make_shared<ConstantValueExpression>(Field(TypeId::kTypeInt, 0)), ">=");
+  auto account_lt = std::make_shared<ComparisonExpression>(
+      account, std::make_shared<ConstantValueExpression>(Field(TypeId::kTypeFloat, 500.f)), "<");
+  auto name_ne = std::make_shared<ComparisonExpression>(
+      name, std::make_shared<ConstantValueExpression>(Field(TypeId::kTypeChar, none, strlen(none), true)), "<>");
+  auto predicate = std::make_shared<LogicExpression>(std::make_shared<LogicExpression>(id_ge, account_lt, LogicType::And),
+                                                     name_ne, LogicType::And);
+  auto out_schema =
+      std::make_shared<Schema>(std::vector<Column *>{new Column("id", TypeId::kTypeInt, 0, false, false)});
+  auto plan = std::make_shared<SeqScanPlanNode>(out_schema.get(), "t", predicate);
+  ExecuteEngine execute_engine;
+
+  printf("rows: %d, rounds: %d\n", row_nums, rounds);
+  // the first round warms the buffer pool
+  size_t results = 0;
+  Timer timer;
+  for (int round = 0; round <= rounds; round++) {
+    if (round == 1) {
+      results = 0;
+      timer.Reset();
+    }
+    auto context = engine->MakeExecuteContext(nullptr);
+    std::vector<Row> result_set;
+    execute_engine.ExecutePlan(plan, &result_set, nullptr, context.get());
+    results += result_set.size();
+  }
+  double elapsed = timer.Elapsed();
+  printf("scan     results: %zu  time: %.3fs  ns/row: %6.1f\n", results, elapsed,
+         elapsed * 1e9 / (static_cast<double>(row_nums) * rounds));
+
+  // keys share a prefix in the char column, so both columns are compared
+  Schema key_schema(std::vector<Column *>{new Column("group", TypeId::kTypeInt, 0, false, false),
+                                          new Column("name", TypeId::kTypeChar, 32, 1, false, false)});
+  KeyManager key_manager(&key_schema);
+  std::vector<GenericKey<64>> keys(row_nums);
+  for (int i = 0; i < row_nums; i++) {
+    std::string key_name = "name-" + std::to_string(i);
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i / 100),
+                              Field(TypeId::kTypeChar, const_cast<char *>(key_name.c_str()), key_name.size(), true)};
+    Row key(std::move(fields));
+    key_manager.SerializeFromKey(&keys[i], key, &key_schema);
+  }
+  int64_t order = 0;
+  timer.Reset();
+  for (int round = 0; round < rounds; round++) {
+    for (int i = 1; i < row_nums; i++) {
+      order += key_manager.CompareKeys(&keys[i - 1], &keys[i]);
+    }
+  }
+  elapsed = timer.Elapsed();
+  printf("keys     compares: %d  time: %.3fs  ns/compare: %6.1f  (%ld)\n", (row_nums - 1) * rounds, elapsed,
+         elapsed * 1e9 / ((row_nums - 1.0) * rounds), static_cast<long>(order));
+
+  delete engine;
+  remove("predicate_benchmark.db");
+  return 0;
+}
@@ -0,0 +1,105 @@
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "common/instance.h"
+#include "executor/execute_context.h"
+#include "executor/execute_engine.h"
+#include "executor/plans/seq_scan_plan.h"
+#include "glog/logging.h"
+#include "planner/expressions/column_value_expression.h"
+#include "planner/expressions/comparison_expression.h"
+#include "planner/expressions/constant_value_expression.h"
+#include "utils/timer.h"
+
+/**
+ * SELECT id, name FROM t WHERE account < 500 through the executors, scan, filter and projection, up to the result
+ * set. Heap allocations are counted by replacing the global operator new of this executable.
+ */
+static std::atomic<size_t> allocations{0};
+
+void *operator new(size_t size) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void *p = malloc(size == 0 ? 1 : size)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+void *operator new[](size_t size) { return operator new(size); }
+
+void operator delete(void *p) noexcept { free(p); }
+
+void operator delete[](void *p) noexcept { free(p); }
+
+void operator delete(void *p, size_t) noexcept { free(p); }
+
+void operator delete[](void *p, size_t) noexcept { free(p); }
+
+int main(int argc, char **argv) {
+  google::InitGoogleLogging(argv[0]);
+  FLAGS_minloglevel = google::GLOG_ERROR;
+  const int row_nums = argc > 1 ? atoi(argv[1]) : 100000;
+  const int rounds = argc > 2 ? atoi(argv[2]) : 5;
+
+  auto *engine = new DBStorageEngine("query_allocation_benchmark.db", true, DEFAULT_BUFFER_POOL_SIZE * 4);
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 32, 1, true, false),
+                                   new Column("account", TypeId::kTypeFloat, 2, true, false)};
+  Schema schema(columns);
+  TableInfo *table_info = nullptr;
+  engine->catalog_mgr_->CreateTable("t", &schema, nullptr, table_info);
+  std::vector<Row> rows;
+  for (int i = 0; i < row_nums; i++) {
+    std::string name = "name-" + std::to_string(i);
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i),
+                              Field(TypeId::kTypeChar, const_cast<char *>(name.c_str()), name.size(), true),
+                              Field(TypeId::kTypeFloat, static_cast<float>(i % 1000))};
+    rows.emplace_back(fields);
+  }
+  if (!table_info->GetTableHeap()->BulkInsert(rows, nullptr)) {
+    fprintf(stderr, "failed to load the table\n");
+    return 1;
+  }
+  rows.clear();
+
+  auto id = std::make_shared<ColumnValueExpression>(0, 0, TypeId::kTypeInt);
+  auto name = std::make_shared<ColumnValueExpression>(0, 1, TypeId::kTypeChar);
+  auto account = std::make_shared<ColumnValueExpression>(0, 2, TypeId::kTypeFloat);
+  auto predicate = std::make_shared<ComparisonExpression>(
+      account, std::make_shared<ConstantValueExpression>(Field(TypeId::kTypeFloat, 500.f)), "<");
+  auto out_schema = std::make_shared<Schema>(std::vector<Column *>{
+      new Column("id", TypeId::kTypeInt, 0, false, false), new Column("name", TypeId::kTypeChar, 32, 1, true, false)});
+  auto plan = std::make_shared<SeqScanPlanNode>(out_schema.get(), "t", predicate);
+  ExecuteEngine execute_engine;
+
+  printf("rows: %d, rounds: %d\n", row_nums, rounds);
+  // the first round warms the buffer pool
+  size_t results = 0;
+  size_t before = 0;
+  Timer timer;
+  for (int round = 0; round <= rounds; round++) {
+    if (round == 1) {
+      results = 0;
+      before = allocations.load();
+      timer.Reset();
+    }
+    auto context = engine->MakeExecuteContext(nullptr);
+    std::vector<Row> result_set;
+    execute_engine.ExecutePlan(plan, &result_set, nullptr, context.get());
+    results += result_set.size();
+  }
+  double elapsed = timer.Elapsed();
+  size_t allocated = allocations.load() - before;
+  size_t scanned = static_cast<size_t>(row_nums) * rounds;
+  printf("results: %zu  time: %.3fs  rows/s: %12.0f  allocations/scanned row: %.3f  allocations/result: %.3f\n",
+         results, elapsed, scanned / elapsed, static_cast<double>(allocated) / scanned,
+         static_cast<double>(allocated) / results);
+
+  delete engine;
+  remove("query_allocation_benchmark.db");
+  return 0;
+}
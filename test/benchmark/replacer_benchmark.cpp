@@ -0,0 +1,150 @@
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "buffer/clock_replacer.h"
+#include "buffer/lru_replacer.h"
+#include "buffer/two_queue_replacer.h"
+#include "utils/timer.h"
+
+/**
+ * The hash set replacer LRUReplacer used to be: Victim() walks the whole set and evicts the last bucket entry.
+ * Kept here only as the baseline of the benchmark.
+ */
+class HashSetReplacer : public Replacer {
+ public:
+  explicit HashSetReplacer(size_t num_pages) : num_pages_(num_pages) {}
+
+  bool Victim(frame_id_t *frame_id) override {
+    if (set_.empty()) {
+      return false;
+    }
+    auto it = set_.begin();
+    for (size_t i = 0; i + 1 < set_.size(); i++) {
+      it++;
+    }
+    *frame_id = *it;
+    set_.erase(it);
+    return true;
+  }
+
+  void Pin(frame_id_t frame_id) override { set_.erase(frame_id); }
+
+  void Remove(frame_id_t frame_id) override { set_.erase(frame_id); }
+
+  void Unpin(frame_id_t frame_id) override {
+    if (set_.size() < num_pages_) {
+      set_.insert(frame_id);
+    }
+  }
+
+  size_t Size() override { return set_.size(); }
+
+ private:
+  std::unordered_set<frame_id_t> set_;
+  size_t num_pages_;
+};
+
+struct Access {
+  page_id_t page_id;
+  AccessType type;
+};
+
+struct BenchResult {
+  size_t hits{0};
+  size_t accesses{0};
+  size_t evictions{0};
+  double seconds{0};
+};
+
+/**
+ * Replays a page access trace against a simulated buffer pool of pool_size frames. Only the frame bookkeeping is
+ * simulated, no page content is read or written.
+ */
+static BenchResult Replay(Replacer *replacer, size_t pool_size, const std::vector<Access> &trace) {
+  BenchResult res;
+  std::unordered_map<page_id_t, frame_id_t> page_table;
+  std::vector<page_id_t> frame_page(pool_size, INVALID_PAGE_ID);
+  size_t next_free = 0;
+  Timer timer;
+  for (const auto &access : trace) {
+    page_id_t page_id = access.page_id;
+    res.accesses++;
+    auto it = page_table.find(page_id);
+    frame_id_t frame_id;
+    if (it != page_table.end()) {
+      res.hits++;
+      frame_id = it->second;
+      replacer->RecordAccess(frame_id, access.type);
+      replacer->Pin(frame_id);
+    } else if (next_free < pool_size) {
+      frame_id = static_cast<frame_id_t>(next_free++);
+      page_table[page_id] = frame_id;
+    } else {
+      if (!replacer->Victim(&frame_id)) {
+        fprintf(stderr, "no victim found\n");
+        exit(1);
+      }
+      res.evictions++;
+      replacer->Remove(frame_id);
+      page_table.erase(frame_page[frame_id]);
+      page_table[page_id] = frame_id;
+    }
+    if (frame_page[frame_id] != page_id) {
+      frame_page[frame_id] = page_id;
+      replacer->RecordAccess(frame_id, access.type);
+    }
+    replacer->Unpin(frame_id);
+  }
+  res.seconds = timer.Elapsed();
+  return res;
+}
+
+/**
+ * Scan heavy trace: a hot working set accessed with 80% probability, interleaved with a sequential scan over a
+ * table much larger than the pool.
+ */
+static std::vector<Access> MakeTrace(size_t hot_pages, size_t scan_pages, size_t length) {
+  std::mt19937 rng(2023);
+  std::uniform_int_distribution<size_t> hot_dist(0, hot_pages - 1);
+  std::uniform_int_distribution<int> coin(0, 99);
+  std::vector<Access> trace;
+  trace.reserve(length);
+  size_t scan_cursor = 0;
+  for (size_t i = 0; i < length; i++) {
+    if (coin(rng) < 80) {
+      trace.push_back({static_cast<page_id_t>(hot_dist(rng)), kRandomAccess});
+    } else {
+      trace.push_back({static_cast<page_id_t>(hot_pages + scan_cursor), kSequentialAccess});
+      scan_cursor = (scan_cursor + 1) % scan_pages;
+    }
+  }
+  return trace;
+}
+
+static void Report(const char *name, const BenchResult &res) {
+  printf("%-10s hit rate: %6.2f%%  evictions: %8zu  evictions/s: %12.0f  total: %.3fs\n", name,
+         100.0 * res.hits / res.accesses, res.evictions, res.evictions / res.seconds, res.seconds);
+}
+
+int main(int argc, char **argv) {
+  size_t pool_size = argc > 1 ? strtoul(argv[1], nullptr, 10) : 1024;
+  size_t length = argc > 2 ? strtoul(argv[2], nullptr, 10) : 1000000;
+  size_t hot_pages = pool_size / 2;
+  size_t scan_pages = pool_size * 8;
+  auto trace = MakeTrace(hot_pages, scan_pages, length);
+  printf("pool size: %zu, hot pages: %zu, scan pages: %zu, accesses: %zu\n", pool_size, hot_pages, scan_pages, length);
+
+  HashSetReplacer hash_set(pool_size);
+  Report("hash set", Replay(&hash_set, pool_size, trace));
+  LRUReplacer lru(pool_size);
+  Report("lru", Replay(&lru, pool_size, trace));
+  CLOCKReplacer clock(pool_size);
+  Report("clock", Replay(&clock, pool_size, trace));
+  TwoQueueReplacer two_queue(pool_size);
+  Report("2q", Replay(&two_queue, pool_size, trace));
+  return 0;
+}
@@ -0,0 +1,113 @@
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
+#include "record/field.h"
+#include "record/row.h"
+#include "record/schema.h"
+#include "utils/timer.h"
+
+/**
+ * Heap rows of an int, a short char, a long char and a float: copies, moves into a vector and serialize/deserialize
+ * round trips. Heap allocations are counted by replacing the global operator new of this executable.
+ */
+static std::atomic<size_t> allocations{0};
+
+void *operator new(size_t size) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void *p = malloc(size == 0 ? 1 : size)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+void *operator new[](size_t size) { return operator new(size); }
+
+// the default memory resource of pmr containers allocates through the aligned overloads
+void *operator new(size_t size, std::align_val_t alignment) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void *p = aligned_alloc(static_cast<size_t>(alignment), (size + static_cast<size_t>(alignment) - 1) /
+                                                                  static_cast<size_t>(alignment) *
+                                                                  static_cast<size_t>(alignment))) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void *p, std::align_val_t) noexcept { free(p); }
+
+void operator delete(void *p, size_t, std::align_val_t) noexcept { free(p); }
+
+void operator delete(void *p) noexcept { free(p); }
+
+void operator delete[](void *p) noexcept { free(p); }
+
+void operator delete(void *p, size_t) noexcept { free(p); }
+
+void operator delete[](void *p, size_t) noexcept { free(p); }
+
+template <class F>
+static void Measure(const char *name, int ops, F &&f) {
+  size_t before = allocations.load();
+  Timer timer;
+  f();
+  double elapsed = timer.Elapsed();
+  printf("%-24s ns/op: %7.1f  allocations/op: %5.2f\n", name, elapsed * 1e9 / ops,
+         static_cast<double>(allocations.load() - before) / ops);
+}
+
+int main(int argc, char **argv) {
+  const int row_nums = argc > 1 ? atoi(argv[1]) : 1000000;
+
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("code", TypeId::kTypeChar, 8, 1, true, false),
+                                   new Column("name", TypeId::kTypeChar, 64, 2, true, false),
+                                   new Column("account", TypeId::kTypeFloat, 3, true, false)};
+  Schema schema(columns);
+  char code[] = "ab-1234";
+  char name[] = "a name long enough to need its own buffer";
+  std::vector<Field> fields{Field(TypeId::kTypeInt, 1), Field(TypeId::kTypeChar, code, strlen(code), true),
+                            Field(TypeId::kTypeChar, name, strlen(name), true), Field(TypeId::kTypeFloat, 1.5f)};
+  Row row(fields);
+  char buf[PAGE_SIZE];
+
+  printf("rows: %d\n", row_nums);
+  Measure("copy", row_nums, [&] {
+    for (int i = 0; i < row_nums; i++) {
+      Row copy(row);
+      (void)copy;
+    }
+  });
+  std::vector<Row> rows;
+  rows.reserve(row_nums);
+  Measure("build and push_back", row_nums, [&] {
+    for (int i = 0; i < row_nums; i++) {
+      Row copy(row);
+      rows.push_back(std::move(copy));
+    }
+  });
+  Measure("grow vector of rows", row_nums, [&] {
+    std::vector<Row> grown;
+    for (auto &r : rows) {
+      grown.push_back(std::move(r));
+    }
+  });
+  Measure("serialize", row_nums, [&] {
+    for (int i = 0; i < row_nums; i++) {
+      row.SerializeTo(buf, &schema);
+    }
+  });
+  Measure("deserialize", row_nums, [&] {
+    for (int i = 0; i < row_nums; i++) {
+      Row read;
+      read.DeserializeFrom(buf, &schema);
+    }
+  });
+  return 0;
+}
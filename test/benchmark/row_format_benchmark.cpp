@@ -0,0 +1,77 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "common/config.h"
+#include "record/field.h"
+#include "record/row.h"
+#include "record/row_view.h"
+#include "record/schema.h"
+#include "utils/timer.h"
+
+/**
+ * Projection of one column out of wide rows, read in place through a RowView, for rows in the previous format (packed
+ * fields) and in the current one (offset table). Every read is on a freshly reset view, as in a scan. The projected
+ * columns are chars.
+ */
+static uint32_t SerializeV0(const Row &row, char *buf) {
+  uint32_t field_num = row.GetFieldCount();
+  uint32_t bitmap = 0;
+  for (uint32_t i = 0; i < field_num; i++) {
+    if (row.GetField(i)->IsNull()) {
+      bitmap |= 1 << (field_num - 1 - i);
+    }
+  }
+  MACH_WRITE_UINT32(buf, field_num);
+  MACH_WRITE_UINT32(buf + sizeof(uint32_t), bitmap);
+  uint32_t offset = 2 * sizeof(uint32_t);
+  for (uint32_t i = 0; i < field_num; i++) {
+    offset += row.GetField(i)->SerializeTo(buf + offset);
+  }
+  return offset;
+}
+
+int main(int argc, char **argv) {
+  const uint32_t column_nums = argc > 1 ? atoi(argv[1]) : 32;
+  const int reads = argc > 2 ? atoi(argv[2]) : 1000000;
+
+  std::vector<Column *> columns;
+  std::vector<Field> fields;
+  char characters[16];
+  memset(characters, 'x', sizeof(characters));
+  for (uint32_t i = 0; i < column_nums; i++) {
+    std::string name = "c" + std::to_string(i);
+    if (i % 2 == 0) {
+      columns.push_back(new Column(name, TypeId::kTypeChar, sizeof(characters), i, true, false));
+      fields.emplace_back(TypeId::kTypeChar, characters, sizeof(characters), false);
+    } else {
+      columns.push_back(new Column(name, TypeId::kTypeInt, i, true, false));
+      fields.emplace_back(TypeId::kTypeInt, static_cast<int32_t>(i));
+    }
+  }
+  Schema schema(columns);
+  Row row(fields);
+  char v0[PAGE_SIZE];
+  char v1[PAGE_SIZE];
+  SerializeV0(row, v0);
+  row.SerializeTo(v1, &schema);
+
+  printf("columns: %u, reads: %d\n", column_nums, reads);
+  for (const char *buf : {v0, v1}) {
+    for (uint32_t column : {0u, column_nums / 2 / 2 * 2, (column_nums - 1) / 2 * 2}) {
+      RowView view;
+      int64_t sum = 0;
+      Timer timer;
+      for (int i = 0; i < reads; i++) {
+        view.Reset(buf, &schema);
+        sum += view.GetField(column).GetLength();
+      }
+      double elapsed = timer.Elapsed();
+      printf("version %u  column: %3u  time: %.3fs  ns/read: %6.1f  (%ld)\n", Row::GetFormatVersion(buf), column,
+             elapsed, elapsed * 1e9 / reads, static_cast<long>(sum));
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,109 @@
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "glog/logging.h"
+#include "planner/expressions/column_value_expression.h"
+#include "planner/expressions/comparison_expression.h"
+#include "planner/expressions/constant_value_expression.h"
+#include "record/field.h"
+#include "record/schema.h"
+#include "storage/table_heap.h"
+#include "utils/timer.h"
+
+/**
+ * Filtered full scans of a cached table, the predicate (name = "...") evaluated on deserialized rows against rows read
+ * in place. Heap allocations are counted by replacing the global operator new of this executable.
+ */
+static std::atomic<size_t> allocations{0};
+
+void *operator new(size_t size) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void *p = malloc(size == 0 ? 1 : size)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+void *operator new[](size_t size) { return operator new(size); }
+
+void operator delete(void *p) noexcept { free(p); }
+
+void operator delete[](void *p) noexcept { free(p); }
+
+void operator delete(void *p, size_t) noexcept { free(p); }
+
+void operator delete[](void *p, size_t) noexcept { free(p); }
+
+int main(int argc, char **argv) {
+  google::InitGoogleLogging(argv[0]);
+  FLAGS_minloglevel = google::GLOG_ERROR;
+  const std::string db_name = "scan_allocation_benchmark.db";
+  const int row_nums = argc > 1 ? atoi(argv[1]) : 200000;
+  const int rounds = argc > 2 ? atoi(argv[2]) : 5;
+
+  remove(db_name.c_str());
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(DEFAULT_BUFFER_POOL_SIZE * 4, disk_manager);
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 32, 1, true, false),
+                                   new Column("account", TypeId::kTypeFloat, 2, true, false)};
+  Schema schema(columns);
+  TableHeap *table_heap = TableHeap::Create(bpm, &schema, nullptr, nullptr, nullptr);
+  std::vector<Row> rows;
+  for (int i = 0; i < row_nums; i++) {
+    std::string name = "name-" + std::to_string(i % 100);
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i),
+                              Field(TypeId::kTypeChar, const_cast<char *>(name.c_str()), name.size(), true),
+                              Field(TypeId::kTypeFloat, 1.5f)};
+    rows.emplace_back(fields);
+  }
+  if (!table_heap->BulkInsert(rows, nullptr)) {
+    fprintf(stderr, "failed to load the table\n");
+    return 1;
+  }
+  rows.clear();
+
+  char target[] = "name-42";
+  auto predicate = std::make_shared<ComparisonExpression>(
+      std::make_shared<ColumnValueExpression>(0, 1, TypeId::kTypeChar),
+      std::make_shared<ConstantValueExpression>(Field(TypeId::kTypeChar, target, strlen(target), true)), "=");
+  Field match(TypeId::kTypeInt, 1);
+
+  printf("rows: %d, rounds: %d\n", row_nums, rounds);
+  for (bool in_place : {false, true}) {
+    // the first round warms the buffer pool and the view's offset table
+    size_t count = 0;
+    size_t scanned = 0;
+    size_t before = 0;
+    Timer timer;
+    for (int round = 0; round <= rounds; round++) {
+      if (round == 1) {
+        count = scanned = 0;
+        before = allocations.load();
+        timer.Reset();
+      }
+      for (auto itr = table_heap->Begin(nullptr); itr != table_heap->End(); ++itr) {
+        Field result = in_place ? predicate->Evaluate(&itr.View()) : predicate->Evaluate(&*itr);
+        count += result.CompareEquals(match) == CmpBool::kTrue;
+        scanned++;
+      }
+    }
+    double elapsed = timer.Elapsed();
+    size_t allocated = allocations.load() - before;
+    printf("%-12s  matches: %zu  time: %.3fs  rows/s: %12.0f  allocations/row: %.2f\n",
+           in_place ? "in place" : "deserialize", count, elapsed, scanned / elapsed,
+           static_cast<double>(allocated) / scanned);
+  }
+
+  delete table_heap;
+  delete bpm;
+  delete disk_manager;
+  remove(db_name.c_str());
+  return 0;
+}
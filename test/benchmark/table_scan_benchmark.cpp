@@ -0,0 +1,80 @@
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "glog/logging.h"
+#include "record/field.h"
+#include "record/schema.h"
+#include "storage/table_heap.h"
+#include "utils/timer.h"
+
+/**
+ * Full table scans on a cold buffer pool with different read-ahead windows. The OS page cache of the database file is
+ * dropped before every scan where the platform allows it, so that page reads really hit the disk.
+ */
+static void DropFileCache(const std::string &file_name) {
+  int fd = open(file_name.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return;
+  }
+  fdatasync(fd);
+  posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+  close(fd);
+}
+
+int main(int argc, char **argv) {
+  google::InitGoogleLogging(argv[0]);
+  FLAGS_minloglevel = google::GLOG_ERROR;
+  const std::string db_name = "table_scan_benchmark.db";
+  const int row_nums = argc > 1 ? atoi(argv[1]) : 14000;
+  const size_t pool_size = argc > 2 ? atoi(argv[2]) : 256;
+
+  remove(db_name.c_str());
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(DEFAULT_BUFFER_POOL_SIZE, disk_manager);
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 512, 1, true, false)};
+  Schema schema(columns);
+  TableHeap *table_heap = TableHeap::Create(bpm, &schema, nullptr, nullptr, nullptr);
+  // wide rows keep the table at a few thousand pages
+  char characters[512];
+  memset(characters, 'x', sizeof(characters));
+  for (int i = 0; i < row_nums; i++) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i),
+                              Field(TypeId::kTypeChar, characters, sizeof(characters), false)};
+    Row row(fields);
+    if (!table_heap->InsertTuple(row, nullptr)) {
+      fprintf(stderr, "failed to insert row %d\n", i);
+      return 1;
+    }
+  }
+  page_id_t first_page_id = table_heap->GetFirstPageId();
+  delete table_heap;
+  delete bpm;
+
+  printf("rows: %d, pool size: %zu\n", row_nums, pool_size);
+  for (size_t read_ahead : {0, 4, 8, 32}) {
+    DropFileCache(db_name);
+    bpm = new BufferPoolManager(pool_size, disk_manager, kTwoQueueReplacer);
+    table_heap = TableHeap::Create(bpm, first_page_id, &schema, nullptr, nullptr);
+    table_heap->SetReadAhead(read_ahead);
+    Timer timer;
+    int count = 0;
+    for (auto itr = table_heap->Begin(nullptr); itr != table_heap->End(); itr++) {
+      count++;
+    }
+    double elapsed = timer.Elapsed();
+    printf("read-ahead: %2zu  rows: %d  time: %.3fs  rows/s: %12.0f\n", read_ahead, count, elapsed, count / elapsed);
+    delete table_heap;
+    delete bpm;
+  }
+
+  delete disk_manager;
+  remove(db_name.c_str());
+  return 0;
+}
@@ -1,8 +1,11 @@
 #include "buffer/buffer_pool_manager.h"
 
+#include <chrono>
 #include <cstdio>
 #include <random>
 #include <string>
+#include <thread>
+#include <unordered_set>
 
 #include "gtest/gtest.h"
 
@@ -71,4 +74,200 @@ TEST(BufferPoolManagerTest, BinaryDataTest) {
 
   delete bpm;
   delete disk_manager;
-}
\ No newline at end of file
+}
+
+TEST(BufferPoolManagerTest, ParallelInstanceTest) {
+  const std::string db_name = "bpm_parallel_test.db";
+  const size_t buffer_pool_size = 64;
+  const size_t num_instances = 4;
+  const int num_threads = 4;
+  const int pages_per_thread = 100;
+
+  remove(db_name.c_str());
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager, kLRUReplacer, num_instances);
+  EXPECT_EQ(num_instances, bpm->GetNumInstances());
+
+  // Scenario: every thread creates its own pages and stamps them, the pool is much smaller than the data set.
+  std::vector<std::vector<page_id_t>> thread_pages(num_threads);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&, t] {
+      for (int i = 0; i < pages_per_thread; i++) {
+        page_id_t page_id;
+        Page *page = bpm->NewPage(page_id);
+        ASSERT_NE(nullptr, page);
+        snprintf(page->GetData(), PAGE_SIZE, "%d", page_id);
+        thread_pages[t].push_back(page_id);
+        EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  threads.clear();
+
+  // Scenario: page ids are unique and every page reads back what its owner wrote.
+  std::unordered_set<page_id_t> all_pages;
+  for (auto &pages : thread_pages) {
+    all_pages.insert(pages.begin(), pages.end());
+  }
+  EXPECT_EQ(num_threads * pages_per_thread, all_pages.size());
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&, t] {
+      for (auto page_id : thread_pages[(t + 1) % num_threads]) {
+        Page *page = bpm->FetchPage(page_id);
+        ASSERT_NE(nullptr, page);
+        EXPECT_EQ(std::to_string(page_id), std::string(page->GetData()));
+        EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_TRUE(bpm->CheckAllUnpinned());
+
+  delete bpm;
+  delete disk_manager;
+  remove(db_name.c_str());
+}
+
+TEST(BufferPoolManagerTest, BackgroundFlusherTest) {
+  const std::string db_name = "bpm_flusher_test.db";
+  const size_t buffer_pool_size = 16;
+
+  remove(db_name.c_str());
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager);
+  bpm->StartBackgroundFlusher(0, 0, 4, std::chrono::milliseconds(1));
+
+  // Scenario: dirty unpinned pages are written back in the background, a pinned one is left alone.
+  std::vector<page_id_t> page_ids;
+  for (size_t i = 0; i < buffer_pool_size; i++) {
+    page_id_t page_id;
+    Page *page = bpm->NewPage(page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "page %d", page_id);
+    page_ids.push_back(page_id);
+    if (i > 0) {
+      EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+    }
+  }
+  for (int i = 0; i < 1000 && bpm->GetStats().background_writes_ < buffer_pool_size - 1; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  BufferPoolStats stats = bpm->GetStats();
+  EXPECT_EQ(buffer_pool_size - 1, stats.background_writes_);
+  EXPECT_EQ(0, stats.dirty_pages_);
+  char data[PAGE_SIZE];
+  for (size_t i = 1; i < buffer_pool_size; i++) {
+    disk_manager->ReadPage(page_ids[i], data);
+    EXPECT_EQ("page " + std::to_string(page_ids[i]), std::string(data));
+  }
+
+  // Scenario: evictions now find clean victims, page 0 was unpinned last and is still dirty.
+  bpm->StopBackgroundFlusher();
+  EXPECT_TRUE(bpm->UnpinPage(page_ids[0], true));
+  for (size_t i = 0; i < buffer_pool_size / 2; i++) {
+    page_id_t page_id;
+    ASSERT_NE(nullptr, bpm->NewPage(page_id));
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+  stats = bpm->GetStats();
+  EXPECT_EQ(buffer_pool_size / 2, stats.evictions_);
+  EXPECT_EQ(buffer_pool_size / 2, stats.clean_evictions_);
+  EXPECT_EQ(1, stats.dirty_pages_);
+  for (auto page_id : page_ids) {
+    Page *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ("page " + std::to_string(page_id), std::string(page->GetData()));
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+
+  delete bpm;
+  delete disk_manager;
+  remove(db_name.c_str());
+}
+
+TEST(BufferPoolManagerTest, BackgroundFlusherEvictionTest) {
+  const std::string db_name = "bpm_flusher_eviction_test.db";
+  const size_t buffer_pool_size = 8;
+  const int num_pages = 64;
+  const int num_threads = 2;
+
+  remove(db_name.c_str());
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager);
+  std::vector<page_id_t> page_ids;
+  std::vector<int> stamps(num_pages, 0);
+  for (int i = 0; i < num_pages; i++) {
+    page_id_t page_id;
+    Page *page = bpm->NewPage(page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "%d", 0);
+    page_ids.push_back(page_id);
+    EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+  // a flusher that writes again as soon as a batch is done, while every fetch evicts a frame it may be flushing
+  bpm->StartBackgroundFlusher(0, 0, 2, std::chrono::milliseconds(1));
+
+  // Scenario: each thread stamps its own pages over and over, no stamp is lost and nothing hangs.
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&, t] {
+      std::mt19937 rng(t);
+      for (int n = 0; n < 2000; n++) {
+        int i = static_cast<int>(rng() % (num_pages / num_threads)) * num_threads + t;
+        Page *page = bpm->FetchPage(page_ids[i]);
+        ASSERT_NE(nullptr, page);
+        EXPECT_EQ(std::to_string(stamps[i]), std::string(page->GetData()));
+        snprintf(page->GetData(), PAGE_SIZE, "%d", ++stamps[i]);
+        EXPECT_TRUE(bpm->UnpinPage(page_ids[i], true));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  bpm->StopBackgroundFlusher();
+  EXPECT_LT(0, bpm->GetStats().background_writes_);
+  for (int i = 0; i < num_pages; i++) {
+    Page *page = bpm->FetchPage(page_ids[i]);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(std::to_string(stamps[i]), std::string(page->GetData()));
+    EXPECT_TRUE(bpm->UnpinPage(page_ids[i], false));
+  }
+
+  delete bpm;
+  delete disk_manager;
+  remove(db_name.c_str());
+}
+
+TEST(BufferPoolManagerTest, FailedFlushTest) {
+  const std::string db_name = "bpm_failed_flush_test.db";
+  const size_t buffer_pool_size = 4;
+
+  remove(db_name.c_str());
+  auto *disk_manager = new DiskManager(db_name);
+  auto *instance = new BufferPoolManagerInstance(buffer_pool_size, disk_manager, kLRUReplacer);
+  for (size_t i = 0; i < buffer_pool_size; i++) {
+    page_id_t page_id = disk_manager->AllocatePage();
+    ASSERT_NE(nullptr, instance->NewPage(page_id));
+    EXPECT_TRUE(instance->UnpinPage(page_id, true));
+  }
+  ASSERT_EQ(buffer_pool_size, instance->GetNumDirtyPages());
+
+  // Scenario: the writes of a batch fail once the file is closed, its pages stay dirty.
+  disk_manager->Close();
+  EXPECT_EQ(0, instance->FlushDirtyPages(buffer_pool_size));
+  EXPECT_EQ(buffer_pool_size, instance->GetNumDirtyPages());
+  BufferPoolStats stats;
+  instance->CollectStats(&stats);
+  EXPECT_EQ(0, stats.background_writes_);
+
+  delete instance;
+  delete disk_manager;
+  remove(db_name.c_str());
+}
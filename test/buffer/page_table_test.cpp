@@ -0,0 +1,62 @@
+#include "buffer/page_table.h"
+
+#include <random>
+#include <unordered_map>
+
+#include "gtest/gtest.h"
+
+TEST(PageTableTest, SampleTest) {
+  const size_t num_frames = 64;
+  PageTable page_table(num_frames);
+  frame_id_t frame_id;
+
+  // Scenario: empty table finds nothing.
+  EXPECT_FALSE(page_table.Find(0, &frame_id));
+
+  // Scenario: insert, overwrite and erase.
+  page_table.Insert(1, 10);
+  page_table.Insert(2, 20);
+  ASSERT_TRUE(page_table.Find(1, &frame_id));
+  EXPECT_EQ(10, frame_id);
+  page_table.Insert(1, 11);
+  ASSERT_TRUE(page_table.Find(1, &frame_id));
+  EXPECT_EQ(11, frame_id);
+  page_table.Erase(1);
+  EXPECT_FALSE(page_table.Find(1, &frame_id));
+  ASSERT_TRUE(page_table.Find(2, &frame_id));
+  EXPECT_EQ(20, frame_id);
+  page_table.Erase(1);
+  page_table.Erase(2);
+  EXPECT_FALSE(page_table.Find(2, &frame_id));
+}
+
+TEST(PageTableTest, RandomTest) {
+  const size_t num_frames = 256;
+  PageTable page_table(num_frames);
+  std::unordered_map<page_id_t, frame_id_t> expected;
+  std::mt19937 rng(0);
+  std::uniform_int_distribution<page_id_t> page_dist(0, 4 * num_frames);
+
+  // Scenario: a random mix of inserts and erases, kept at most num_frames entries like a buffer pool.
+  for (int i = 0; i < 100000; i++) {
+    page_id_t page_id = page_dist(rng);
+    if (expected.count(page_id) != 0 || expected.size() == num_frames) {
+      auto victim = expected.count(page_id) != 0 ? page_id : expected.begin()->first;
+      page_table.Erase(victim);
+      expected.erase(victim);
+    } else {
+      page_table.Insert(page_id, i);
+      expected[page_id] = i;
+    }
+  }
+  for (page_id_t page_id = 0; page_id <= static_cast<page_id_t>(4 * num_frames); page_id++) {
+    frame_id_t frame_id;
+    auto it = expected.find(page_id);
+    if (it == expected.end()) {
+      EXPECT_FALSE(page_table.Find(page_id, &frame_id));
+    } else {
+      ASSERT_TRUE(page_table.Find(page_id, &frame_id));
+      EXPECT_EQ(it->second, frame_id);
+    }
+  }
+}
@@ -0,0 +1,78 @@
+#include "buffer/two_queue_replacer.h"
+
+#include "gtest/gtest.h"
+
+TEST(TwoQueueReplacerTest, SampleTest) {
+  TwoQueueReplacer replacer(7);
+
+  // Scenario: frames touched once stay in the probationary FIFO.
+  for (frame_id_t i = 1; i <= 6; i++) {
+    replacer.RecordAccess(i, kRandomAccess);
+    replacer.Unpin(i);
+  }
+  replacer.Unpin(1);
+  EXPECT_EQ(6, replacer.Size());
+
+  // Scenario: a second access promotes frame 2 to the protected queue.
+  replacer.RecordAccess(2, kRandomAccess);
+  replacer.Pin(2);
+  replacer.Unpin(2);
+  EXPECT_EQ(6, replacer.Size());
+
+  // Scenario: like the buffer pool, forget the history of a victim once its frame is reused.
+  int value;
+  replacer.Victim(&value);
+  EXPECT_EQ(1, value);
+  replacer.Remove(value);
+  replacer.Victim(&value);
+  EXPECT_EQ(3, value);
+  replacer.Remove(value);
+  replacer.Victim(&value);
+  EXPECT_EQ(4, value);
+  replacer.Remove(value);
+  replacer.Victim(&value);
+  EXPECT_EQ(5, value);
+  replacer.Remove(value);
+  // Scenario: the probationary queue is down to its reserved size (a quarter of the pool), evict from protected.
+  replacer.Victim(&value);
+  EXPECT_EQ(2, value);
+  replacer.Remove(value);
+  replacer.Victim(&value);
+  EXPECT_EQ(6, value);
+  EXPECT_FALSE(replacer.Victim(&value));
+}
+
+TEST(TwoQueueReplacerTest, ScanResistanceTest) {
+  const size_t pool_size = 16;
+  const frame_id_t hot_frames = 8;
+  TwoQueueReplacer replacer(pool_size);
+
+  // Scenario: half of the pool holds hot pages, each accessed several times.
+  for (frame_id_t i = 0; i < hot_frames; i++) {
+    replacer.RecordAccess(i, kRandomAccess);
+    replacer.RecordAccess(i, kRandomAccess);
+    replacer.Unpin(i);
+  }
+  // Scenario: the other half is filled by a scan, every scan page is fetched once per tuple.
+  for (frame_id_t i = hot_frames; i < static_cast<frame_id_t>(pool_size); i++) {
+    for (int j = 0; j < 10; j++) {
+      replacer.RecordAccess(i, kSequentialAccess);
+    }
+    replacer.Unpin(i);
+  }
+  // Scenario: a long scan keeps loading new pages, victims must always be scan frames.
+  for (int i = 0; i < 100; i++) {
+    frame_id_t victim;
+    ASSERT_TRUE(replacer.Victim(&victim));
+    ASSERT_GE(victim, hot_frames);
+    replacer.Remove(victim);
+    replacer.RecordAccess(victim, kSequentialAccess);
+    replacer.RecordAccess(victim, kSequentialAccess);
+    replacer.Unpin(victim);
+  }
+  EXPECT_EQ(pool_size, replacer.Size());
+
+  // Scenario: removed frames are forgotten.
+  replacer.Remove(0);
+  EXPECT_EQ(pool_size - 1, replacer.Size());
+}
@@ -68,6 +68,174 @@ TEST(CatalogTest, CatalogTableTest) {
   delete db_02;
 }
 
+TEST(CatalogTest, CatalogTableEarlierFormatTest) {
+  auto db_01 = new DBStorageEngine(db_file_name, true);
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 64, 1, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  Txn txn;
+  TableInfo *table_info = nullptr;
+  ASSERT_EQ(DB_SUCCESS, db_01->catalog_mgr_->CreateTable("table-1", schema.get(), &txn, table_info));
+  IndexInfo *index_info = nullptr;
+  std::vector<std::string> index_keys{"id"};
+  ASSERT_EQ(DB_SUCCESS, db_01->catalog_mgr_->CreateIndex("table-1", "index-1", index_keys, &txn, index_info, "bptree"));
+  char name[64] = "minisql";
+  for (int i = 0; i < 100; i++) {
+    Row row({Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, name, sizeof(name), true)});
+    ASSERT_TRUE(table_info->GetTableHeap()->InsertTuple(row, nullptr));
+    Row key({Field(TypeId::kTypeInt, i)});
+    ASSERT_EQ(DB_SUCCESS, index_info->GetIndex()->InsertEntry(key, row.GetRowId(), nullptr));
+  }
+  delete db_01;
+  // Scenario: rewrite the table metadata and pages the way they were stored before the free space map existed, when
+  // table pages had a 24 byte header.
+  auto db_02 = new DBStorageEngine(db_file_name, false);
+  auto catalog_page = db_02->bpm_->FetchPage(CATALOG_META_PAGE_ID);
+  CatalogMeta *catalog_meta = CatalogMeta::DeserializeFrom(catalog_page->GetData());
+  db_02->bpm_->UnpinPage(CATALOG_META_PAGE_ID, false);
+  page_id_t meta_page_id = catalog_meta->GetTableMetaPages()->begin()->second;
+  delete catalog_meta;
+  auto meta_page = db_02->bpm_->FetchPage(meta_page_id);
+  TableMetadata *table_meta = nullptr;
+  TableMetadata::DeserializeFrom(meta_page->GetData(), table_meta);
+  ASSERT_NE(INVALID_PAGE_ID, table_meta->GetFreeSpaceMapPageId());
+  char *buf = meta_page->GetData();
+  MACH_WRITE_UINT32(buf, 344528);
+  buf += 4;
+  MACH_WRITE_TO(table_id_t, buf, table_meta->GetTableId());
+  buf += 4;
+  MACH_WRITE_UINT32(buf, table_meta->GetTableName().length());
+  buf += 4;
+  MACH_WRITE_STRING(buf, table_meta->GetTableName());
+  buf += table_meta->GetTableName().length();
+  MACH_WRITE_TO(page_id_t, buf, table_meta->GetFirstPageId());
+  buf += 4;
+  table_meta->GetSchema()->SerializeTo(buf);
+  for (page_id_t page_id = table_meta->GetFirstPageId(); page_id != INVALID_PAGE_ID;) {
+    char *data = db_02->bpm_->FetchPage(page_id)->GetData();
+    uint32_t tuple_count = MACH_READ_UINT32(data + 20);
+    memmove(data + 24, data + 32, 8 * tuple_count);
+    page_id_t next_page_id = MACH_READ_FROM(page_id_t, data + 12);
+    db_02->bpm_->UnpinPage(page_id, true);
+    page_id = next_page_id;
+  }
+  delete table_meta;
+  table_meta = nullptr;
+  TableMetadata::DeserializeFrom(meta_page->GetData(), table_meta);
+  db_02->bpm_->UnpinPage(meta_page_id, true);
+  EXPECT_EQ(INVALID_PAGE_ID, table_meta->GetFreeSpaceMapPageId());
+  EXPECT_EQ("table-1", table_meta->GetTableName());
+  delete table_meta;
+  delete db_02;
+  // Scenario: the map is rebuilt on load and recorded in the metadata.
+  auto db_03 = new DBStorageEngine(db_file_name, false);
+  ASSERT_EQ(DB_SUCCESS, db_03->catalog_mgr_->GetTable("table-1", table_info));
+  page_id_t fsm_page_id = table_info->GetTableHeap()->GetFreeSpaceMapPageId();
+  ASSERT_NE(INVALID_PAGE_ID, fsm_page_id);
+  meta_page = db_03->bpm_->FetchPage(meta_page_id);
+  table_meta = nullptr;
+  TableMetadata::DeserializeFrom(meta_page->GetData(), table_meta);
+  db_03->bpm_->UnpinPage(meta_page_id, false);
+  EXPECT_EQ(fsm_page_id, table_meta->GetFreeSpaceMapPageId());
+  delete table_meta;
+  Row row({Field(TypeId::kTypeInt, 100), Field(TypeId::kTypeChar, name, sizeof(name), true)});
+  ASSERT_TRUE(table_info->GetTableHeap()->InsertTuple(row, nullptr));
+  size_t rows = 0;
+  for (auto iter = table_info->GetTableHeap()->Begin(nullptr); iter != table_info->GetTableHeap()->End(); iter++) {
+    rows++;
+  }
+  EXPECT_EQ(101, rows);
+  // the converted pages are read through the index
+  ASSERT_EQ(DB_SUCCESS, db_03->catalog_mgr_->GetIndex("table-1", "index-1", index_info));
+  for (int i = 0; i < 100; i++) {
+    Row key({Field(TypeId::kTypeInt, i)});
+    std::vector<RowId> rids;
+    ASSERT_EQ(DB_SUCCESS, index_info->GetIndex()->ScanKey(key, rids, nullptr));
+    Row found(rids[0]);
+    ASSERT_TRUE(table_info->GetTableHeap()->GetTuple(&found, nullptr));
+    EXPECT_EQ(CmpBool::kTrue, found.GetField(0)->CompareEquals(Field(TypeId::kTypeInt, i)));
+  }
+  delete db_03;
+}
+
+TEST(CatalogTest, CatalogIndexEarlierFormatTest) {
+  auto db_01 = new DBStorageEngine(db_file_name, true);
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 64, 1, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  Txn txn;
+  TableInfo *table_info = nullptr;
+  ASSERT_EQ(DB_SUCCESS, db_01->catalog_mgr_->CreateTable("table-1", schema.get(), &txn, table_info));
+  IndexInfo *index_info = nullptr;
+  std::vector<std::string> index_keys{"id"};
+  ASSERT_EQ(DB_SUCCESS, db_01->catalog_mgr_->CreateIndex("table-1", "index-1", index_keys, &txn, index_info, "bptree"));
+  const int row_nums = 1000;
+  char name[64] = "minisql";
+  for (int i = 0; i < row_nums; i++) {
+    Row row({Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, name, 7, true)});
+    ASSERT_TRUE(table_info->GetTableHeap()->InsertTuple(row, nullptr));
+    Row key({Field(TypeId::kTypeInt, i)});
+    ASSERT_EQ(DB_SUCCESS, index_info->GetIndex()->InsertEntry(key, row.GetRowId(), nullptr));
+  }
+  delete db_01;
+  // Scenario: replace the index by a tree of 32 byte keys, the width earlier builds gave an int key, whose entries
+  // point nowhere, and write its metadata with the earlier magic.
+  auto db_02 = new DBStorageEngine(db_file_name, false);
+  ASSERT_EQ(DB_SUCCESS, db_02->catalog_mgr_->GetIndex("table-1", "index-1", index_info));
+  index_id_t index_id = index_info->GetIndexMetadata()->GetIndexId();
+  index_info->GetIndex()->Destroy();
+  std::vector<page_id_t> earlier_pages;
+  {
+    BPlusTreeIndex<32> earlier_index(index_id, index_info->GetIndexKeySchema(), db_02->bpm_);
+    for (int i = 0; i < row_nums; i++) {
+      Row key({Field(TypeId::kTypeInt, i)});
+      ASSERT_EQ(DB_SUCCESS, earlier_index.InsertEntry(key, RowId(100000 + i, 0), nullptr));
+    }
+    auto root_page = db_02->bpm_->FetchPage(earlier_index.GetContainer().GetRootPageId());
+    auto root = reinterpret_cast<BPlusTreeInternalPage<32> *>(root_page->GetData());
+    ASSERT_FALSE(root->IsLeafPage());
+    earlier_pages.push_back(root->GetPageId());
+    for (int i = 0; i < root->GetSize(); i++) {
+      earlier_pages.push_back(root->ValueAt(i));
+    }
+    db_02->bpm_->UnpinPage(earlier_pages[0], false);
+  }
+  auto catalog_page = db_02->bpm_->FetchPage(CATALOG_META_PAGE_ID);
+  CatalogMeta *catalog_meta = CatalogMeta::DeserializeFrom(catalog_page->GetData());
+  db_02->bpm_->UnpinPage(CATALOG_META_PAGE_ID, false);
+  page_id_t meta_page_id = catalog_meta->GetIndexMetaPages()->at(index_id);
+  delete catalog_meta;
+  MACH_WRITE_UINT32(db_02->bpm_->FetchPage(meta_page_id)->GetData(), 344528);
+  db_02->bpm_->UnpinPage(meta_page_id, true);
+  delete db_02;
+  // Scenario: the earlier tree is dropped on load, the index is rebuilt from the table and recorded as rebuilt.
+  auto db_03 = new DBStorageEngine(db_file_name, false);
+  EXPECT_EQ(344529, MACH_READ_UINT32(db_03->bpm_->FetchPage(meta_page_id)->GetData()));
+  db_03->bpm_->UnpinPage(meta_page_id, false);
+  ASSERT_EQ(DB_SUCCESS, db_03->catalog_mgr_->GetTable("table-1", table_info));
+  ASSERT_EQ(DB_SUCCESS, db_03->catalog_mgr_->GetIndex("table-1", "index-1", index_info));
+  for (int i = 0; i < row_nums; i++) {
+    Row key({Field(TypeId::kTypeInt, i)});
+    std::vector<RowId> rids;
+    ASSERT_EQ(DB_SUCCESS, index_info->GetIndex()->ScanKey(key, rids, nullptr));
+    ASSERT_EQ(1, rids.size());
+    Row found(rids[0]);
+    ASSERT_TRUE(table_info->GetTableHeap()->GetTuple(&found, nullptr));
+    EXPECT_EQ(CmpBool::kTrue, found.GetField(0)->CompareEquals(Field(TypeId::kTypeInt, i)));
+  }
+  delete db_03;
+  // the pages of the earlier tree were freed, unless the rebuilt tree took them again
+  auto db_04 = new DBStorageEngine(db_file_name, false);
+  for (auto page_id : earlier_pages) {
+    if (!db_04->disk_mgr_->IsPageFree(page_id)) {
+      auto page = db_04->bpm_->FetchPage(page_id);
+      EXPECT_EQ(8, reinterpret_cast<BPlusTreePage *>(page->GetData())->GetKeySize());
+      db_04->bpm_->UnpinPage(page_id, false);
+    }
+  }
+  delete db_04;
+}
+
 TEST(CatalogTest, CatalogIndexTest) {
   /** Stage 1: Testing simple operation */
   auto db_01 = new DBStorageEngine(db_file_name, true);
@@ -7,6 +7,13 @@
 #include "executor/plans/update_plan.h"
 #include "executor/plans/values_plan.h"
 #include "executor_test_util.h"  // NOLINT
+#include "planner/planner.h"
+
+extern "C" {
+int yyparse(void);
+#include "parser/minisql_lex.h"
+#include "parser/parser.h"
+}
 
 // SELECT id FROM table-1 WHERE id < 500
 TEST_F(ExecutorTest, SimpleSeqScanTest) {
@@ -112,6 +119,106 @@ TEST_F(ExecutorTest, SimpleRawInsertTest) {
   ASSERT_TRUE(result_set[0].GetField(2)->CompareEquals(Field(kTypeFloat, static_cast<float>(2.33))));
 }
 
+// the plan of a multi-row INSERT ... VALUES of ids 2000 to 2999, then 2000 again, into table-1
+TEST_F(ExecutorTest, MultiRowInsertTest) {
+  TableInfo *table_info;
+  GetExecutorContext()->GetCatalog()->GetTable("table-1", table_info);
+  IndexInfo *index_info = nullptr;
+  std::vector<std::string> index_keys{"id"};
+  ASSERT_EQ(DB_SUCCESS, GetExecutorContext()->GetCatalog()->CreateIndex("table-1", "index-1", index_keys, GetTxn(),
+                                                                        index_info, "bptree"));
+  // the last row repeats a key of the batch, the rows before it are still inserted
+  const int row_nums = 1000;
+  std::vector<std::vector<AbstractExpressionRef>> raw_values;
+  for (int i = 0; i <= row_nums; i++) {
+    raw_values.push_back({MakeConstantValueExpression(Field(kTypeInt, 2000 + i % row_nums)),
+                          MakeConstantValueExpression(Field(kTypeChar, const_cast<char *>("bbb"), 3, false)),
+                          MakeConstantValueExpression(Field(kTypeFloat, 1.5f))});
+  }
+  auto value_plan = std::make_shared<ValuesPlanNode>(nullptr, raw_values);
+  auto insert_plan = std::make_shared<InsertPlanNode>(nullptr, value_plan, "table-1");
+  std::vector<Row> result_set{};
+  GetExecutionEngine()->ExecutePlan(insert_plan, &result_set, GetTxn(), GetExecutorContext());
+  ASSERT_EQ(row_nums, result_set.size());
+
+  // every row is in the table and in the index
+  for (int i = 0; i < row_nums; i++) {
+    Fields key_fields{Field(kTypeInt, 2000 + i)};
+    Row key(key_fields);
+    std::vector<RowId> rids;
+    ASSERT_EQ(DB_SUCCESS, index_info->GetIndex()->ScanKey(key, rids, GetTxn()));
+    ASSERT_EQ(1, rids.size());
+    Row row(rids[0]);
+    ASSERT_TRUE(table_info->GetTableHeap()->GetTuple(&row, GetTxn()));
+    ASSERT_TRUE(row.GetField(0)->CompareEquals(Field(kTypeInt, 2000 + i)));
+  }
+}
+
+// insert into t values (3000, "ccc", 1.5), (3001, "ccc", 1.5), ..., (3999, "ccc", 1.5);
+TEST_F(ExecutorTest, MultiRowInsertSqlTest) {
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 64, 1, true, false),
+                                   new Column("account", TypeId::kTypeFloat, 2, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  TableInfo *table_info = nullptr;
+  ASSERT_EQ(DB_SUCCESS, GetExecutorContext()->GetCatalog()->CreateTable("t", schema.get(), GetTxn(), table_info));
+  IndexInfo *index_info = nullptr;
+  std::vector<std::string> index_keys{"id"};
+  ASSERT_EQ(DB_SUCCESS, GetExecutorContext()->GetCatalog()->CreateIndex("t", "idx", index_keys, GetTxn(), index_info,
+                                                                        "bptree"));
+  auto execute_sql = [&](const std::string &sql, std::vector<Row> &result_set) {
+    YY_BUFFER_STATE bp = yy_scan_string(sql.c_str());
+    yy_switch_to_buffer(bp);
+    MinisqlParserInit();
+    yyparse();
+    ASSERT_EQ(0, MinisqlParserGetError()) << MinisqlParserGetErrorMessage();
+    Planner planner(GetExecutorContext());
+    planner.PlanQuery(MinisqlGetParserRootNode());
+    GetExecutionEngine()->ExecutePlan(planner.plan_, &result_set, GetTxn(), GetExecutorContext());
+    MinisqlParserFinish();
+    yy_delete_buffer(bp);
+    yylex_destroy();
+  };
+
+  const int row_nums = 1000;
+  std::string sql = "insert into t values ";
+  for (int i = 0; i < row_nums; i++) {
+    sql += (i == 0 ? "(" : ", (") + std::to_string(3000 + i) + ", \"ccc\", 1.5)";
+  }
+  std::vector<Row> result_set{};
+  execute_sql(sql + ";", result_set);
+  ASSERT_EQ(row_nums, result_set.size());
+  // a single row still parses, a key of the earlier statement is rejected
+  result_set.clear();
+  execute_sql("insert into t values (4000, \"ddd\", 2.5);", result_set);
+  ASSERT_EQ(1, result_set.size());
+  result_set.clear();
+  execute_sql("insert into t values (4001, \"ddd\", 2.5), (3000, \"ddd\", 2.5);", result_set);
+  ASSERT_EQ(1, result_set.size());
+  // a value too long for its column stops the statement at its row, and is not written by an update
+  const std::string too_long = "\"" + std::string(65, 'd') + "\"";
+  result_set.clear();
+  execute_sql("insert into t values (4002, \"ddd\", 2.5), (4003, " + too_long + ", 2.5);", result_set);
+  ASSERT_EQ(1, result_set.size());
+  result_set.clear();
+  execute_sql("update t set name = " + too_long + " where id = 4002;", result_set);
+  ASSERT_EQ(0, result_set.size());
+
+  // the rows are in the table in the order of the statements, and in the index
+  auto table_heap = table_info->GetTableHeap();
+  int32_t id = 3000;
+  for (auto iter = table_heap->Begin(GetTxn()); iter != table_heap->End(); ++iter) {
+    ASSERT_TRUE(iter->GetField(0)->CompareEquals(Field(kTypeInt, id)));
+    ASSERT_TRUE(iter->GetField(1)->CompareEquals(Field(kTypeChar, const_cast<char *>(id < 4000 ? "ccc" : "ddd"), 3, false)));
+    std::vector<RowId> rids;
+    Row key(Fields{Field(kTypeInt, id)});
+    ASSERT_EQ(DB_SUCCESS, index_info->GetIndex()->ScanKey(key, rids, GetTxn()));
+    ASSERT_EQ(iter->GetRowId(), rids[0]);
+    id++;
+  }
+  EXPECT_EQ(3000 + row_nums + 3, id);
+}
+
 // UPDATE table-1 SET name = "minisql" where id = 500;
 TEST_F(ExecutorTest, SimpleUpdateTest) {
   // Construct a sequential scan of the table
@@ -155,3 +262,48 @@ TEST_F(ExecutorTest, SimpleUpdateTest) {
     ASSERT_TRUE(row.GetField(1)->CompareEquals(Field(kTypeChar, const_cast<char *>("minisql"), 7, false)));
   }
 }
+
+// DELETE FROM table-1 WHERE id % 3 <> 0; VACUUM table-1;
+TEST_F(ExecutorTest, VacuumTest) {
+  TableInfo *table_info;
+  GetExecutorContext()->GetCatalog()->GetTable("table-1", table_info);
+  IndexInfo *index_info = nullptr;
+  std::vector<std::string> index_keys{"id"};
+  ASSERT_EQ(DB_SUCCESS, GetExecutorContext()->GetCatalog()->CreateIndex("table-1", "index-1", index_keys, GetTxn(),
+                                                                        index_info, "bptree"));
+  auto table_heap = table_info->GetTableHeap();
+  std::vector<Row> rows;
+  for (auto iter = table_heap->Begin(GetTxn()); iter != table_heap->End(); iter++) {
+    rows.push_back(*iter);
+  }
+  // CREATE INDEX does not backfill, index only the rows that survive the delete
+  std::vector<int> kept_ids;
+  for (auto &row : rows) {
+    int id = std::stoi(row.GetField(0)->toString());
+    if (id % 3 != 0) {
+      ASSERT_TRUE(table_heap->MarkDelete(row.GetRowId(), GetTxn()));
+      continue;
+    }
+    kept_ids.push_back(id);
+    Row key_row;
+    row.GetKeyFromRow(table_info->GetSchema(), index_info->GetIndexKeySchema(), key_row);
+    ASSERT_EQ(DB_SUCCESS, index_info->GetIndex()->InsertEntry(key_row, row.GetRowId(), GetTxn()));
+  }
+
+  TableHeap::VacuumStats stats;
+  ASSERT_EQ(DB_SUCCESS, GetExecutorContext()->GetCatalog()->VacuumTable("table-1", GetTxn(), &stats));
+  EXPECT_EQ(rows.size() - kept_ids.size(), stats.rows_deleted_);
+  EXPECT_GT(stats.rows_moved_, 0);
+  EXPECT_GT(stats.pages_reclaimed_, 0);
+  // the index points to the new place of every moved row
+  for (int id : kept_ids) {
+    Fields key_fields{Field(kTypeInt, id)};
+    Row key(key_fields);
+    std::vector<RowId> rids;
+    ASSERT_EQ(DB_SUCCESS, index_info->GetIndex()->ScanKey(key, rids, GetTxn())) << id;
+    ASSERT_EQ(1, rids.size());
+    Row row(rids[0]);
+    ASSERT_TRUE(table_heap->GetTuple(&row, GetTxn()));
+    ASSERT_TRUE(row.GetField(0)->CompareEquals(Field(kTypeInt, id)));
+  }
+}
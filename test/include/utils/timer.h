@@ -0,0 +1,24 @@
+#ifndef MINISQL_TIMER_H
+#define MINISQL_TIMER_H
+
+#include <chrono>
+
+/**
+ * Wall clock stopwatch used by the micro benchmarks.
+ */
+class Timer {
+ public:
+  Timer() : start_(std::chrono::steady_clock::now()) {}
+
+  void Reset() { start_ = std::chrono::steady_clock::now(); }
+
+  /** @return seconds elapsed since construction or the last Reset() */
+  double Elapsed() const {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count();
+  }
+
+ private:
+  std::chrono::steady_clock::time_point start_;
+};
+
+#endif  // MINISQL_TIMER_H
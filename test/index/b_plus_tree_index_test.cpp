@@ -1,5 +1,7 @@
 #include "index/b_plus_tree_index.h"
 
+#include <climits>
+#include <cstring>
 #include <string>
 
 #include "common/instance.h"
@@ -17,16 +19,72 @@ TEST(BPlusTreeTests, BPlusTreeIndexGenericKeyTest) {
   auto *key_schema = Schema::ShallowCopySchema(&table_schema, index_key_map);
   std::vector<Field> fields{Field(TypeId::kTypeInt, 27),
                             Field(TypeId::kTypeChar, const_cast<char *>("minisql"), 7, true)};
-  KeyManager KP(key_schema, 128);
+  KeyManager KP(key_schema);
   Row key(fields);
-  GenericKey *k1 = KP.InitKey();
+  GenericKey<128> *k1 = new GenericKey<128>;
   KP.SerializeFromKey(k1, key, key_schema);
-  GenericKey *k2 = KP.InitKey();
+  GenericKey<128> *k2 = new GenericKey<128>;
   Row copy_key(fields);
   KP.SerializeFromKey(k2, copy_key, key_schema);
   ASSERT_EQ(0, KP.CompareKeys(k1, k2));
 }
 
+TEST(BPlusTreeTests, NormalizedKeyTest) {
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, true, false),
+                                   new Column("account", TypeId::kTypeFloat, 1, true, false),
+                                   new Column("name", TypeId::kTypeChar, 8, 2, true, false)};
+  Schema key_schema(columns);
+  KeyManager KP(&key_schema);
+  ASSERT_EQ(3 + 4 + 4 + 8 + 4, KeyManager::GetNormalizedKeySize(&key_schema));
+  char chars[][8] = {"", "a", "a\0", "a\0b", "ab", "b"};
+  size_t lens[] = {0, 1, 2, 3, 2, 1};
+  // every key is less than the next one
+  std::vector<std::vector<Field>> sorted;
+  sorted.push_back({Field(kTypeInt), Field(kTypeFloat), Field(kTypeChar)});
+  for (int32_t id : {INT32_MIN, -65537, -1, 0, 1, 33389, INT32_MAX}) {
+    sorted.push_back({Field(kTypeInt, id), Field(kTypeFloat), Field(kTypeChar)});
+  }
+  for (float account : {-999999.9f, -2.33f, -0.0f, 1e-30f, 19.99f, 999999.9f}) {
+    sorted.push_back({Field(kTypeInt, INT32_MAX), Field(kTypeFloat, account), Field(kTypeChar)});
+  }
+  for (size_t i = 0; i < 6; i++) {
+    sorted.push_back(
+        {Field(kTypeInt, INT32_MAX), Field(kTypeFloat, 999999.9f), Field(kTypeChar, chars[i], lens[i], true)});
+  }
+  std::vector<GenericKey<32> *> keys;
+  for (auto &fields : sorted) {
+    keys.push_back(new GenericKey<32>);
+    KP.SerializeFromKey(keys.back(), Row(fields), &key_schema);
+  }
+  for (size_t i = 0; i < keys.size(); i++) {
+    for (size_t j = 0; j < keys.size(); j++) {
+      int order = KP.CompareKeys(keys[i], keys[j]);
+      ASSERT_EQ(i < j, order < 0) << i << " " << j;
+      ASSERT_EQ(i == j, order == 0) << i << " " << j;
+    }
+  }
+  // -0 and 0 are the same key
+  GenericKey<32> *zero = new GenericKey<32>;
+  std::vector<Field> zero_fields{Field(kTypeInt, INT32_MAX), Field(kTypeFloat, 0.0f), Field(kTypeChar)};
+  KP.SerializeFromKey(zero, Row(zero_fields), &key_schema);
+  ASSERT_EQ(0, KP.CompareKeys(zero, keys[10]));
+  delete zero;
+  // keys decode to the fields they were made of
+  for (size_t i = 0; i < keys.size(); i++) {
+    Row row;
+    KP.DeserializeToKey(keys[i], row, &key_schema);
+    ASSERT_EQ(3, row.GetFieldCount());
+    for (uint32_t j = 0; j < 3; j++) {
+      Field &expected = sorted[i][j];
+      ASSERT_EQ(expected.IsNull(), row.GetField(j)->IsNull());
+      if (!expected.IsNull()) {
+        ASSERT_EQ(CmpBool::kTrue, row.GetField(j)->CompareEquals(expected)) << i << " " << j;
+      }
+    }
+    delete keys[i];
+  }
+}
+
 TEST(BPlusTreeTests, BPlusTreeIndexSimpleTest) {
   auto disk_mgr_ = new DiskManager(db_name);
   auto bpm_ = new BufferPoolManager(DEFAULT_BUFFER_POOL_SIZE, disk_mgr_);
@@ -47,7 +105,7 @@ TEST(BPlusTreeTests, BPlusTreeIndexSimpleTest) {
   std::vector<uint32_t> index_key_map{0, 1};
   const TableSchema table_schema(columns);
   auto *index_schema = Schema::ShallowCopySchema(&table_schema, index_key_map);
-  auto *index = new BPlusTreeIndex(0, index_schema, 256, bpm_);
+  auto *index = new BPlusTreeIndex<128>(0, index_schema, bpm_);
   for (int i = 0; i < 10; i++) {
     std::vector<Field> fields{Field(TypeId::kTypeInt, i),
                               Field(TypeId::kTypeChar, const_cast<char *>("minisql"), 7, true)};
@@ -66,7 +124,7 @@ TEST(BPlusTreeTests, BPlusTreeIndexSimpleTest) {
     ASSERT_EQ(rid.Get(), ret[i].Get());
   }
   // Iterator Scan
-  IndexIterator iter = index->GetBeginIterator();
+  IndexIterator<128> iter = index->GetBeginIterator();
   uint32_t i = 0;
   for (; iter != index->GetEndIterator(); ++iter) {
     ASSERT_EQ(1000, (*iter).second.GetPageId());
@@ -74,4 +132,29 @@ TEST(BPlusTreeTests, BPlusTreeIndexSimpleTest) {
     i++;
   }
   delete index;
-}
\ No newline at end of file
+}
+
+TEST(BPlusTreeTests, BPlusTreeIndexTooLongKeyTest) {
+  DBStorageEngine engine("bp_tree_index_too_long_test.db");
+  std::vector<Column *> columns = {new Column("name", TypeId::kTypeChar, 4, 0, true, false)};
+  Schema key_schema(columns);
+  auto *index = new BPlusTreeIndex<16>(0, &key_schema, engine.bpm_);
+  auto make_key = [](const char *chars) {
+    return Row(std::vector<Field>{Field(kTypeChar, const_cast<char *>(chars), strlen(chars), true)});
+  };
+  ASSERT_EQ(DB_SUCCESS, index->InsertEntry(make_key("abcd"), RowId(1000, 0), nullptr));
+  ASSERT_EQ(DB_SUCCESS, index->InsertEntry(make_key("abce"), RowId(1000, 1), nullptr));
+  // a key longer than its column is never stored, not even under its first 4 chars
+  ASSERT_EQ(DB_FAILED, index->InsertEntry(make_key("abcdx"), RowId(1000, 2), nullptr));
+  std::vector<RowId> ret;
+  ASSERT_EQ(DB_KEY_NOT_FOUND, index->ScanKey(make_key("abcdx"), ret, nullptr));
+  // it looks up between the stored keys it lies between
+  ASSERT_EQ(DB_SUCCESS, index->ScanKey(make_key("abcdx"), ret, nullptr, ">"));
+  ASSERT_EQ(1, ret.size());
+  ASSERT_EQ(RowId(1000, 1), ret[0]);
+  ret.clear();
+  ASSERT_EQ(DB_SUCCESS, index->ScanKey(make_key("abcdx"), ret, nullptr, "<="));
+  ASSERT_EQ(1, ret.size());
+  ASSERT_EQ(RowId(1000, 0), ret[0]);
+  delete index;
+}
@@ -15,24 +15,24 @@ TEST(BPlusTreeTests, SampleTest) {
       new Column("int", TypeId::kTypeInt, 0, false, false),
   };
   Schema *table_schema = new Schema(columns);
-  KeyManager KP(table_schema, 16);
-  BPlusTree tree(0, engine.bpm_, KP);
+  KeyManager KP(table_schema);
+  BPlusTree<16> tree(0, engine.bpm_, KP);
   TreeFileManagers mgr("tree_");
   // Prepare data
   const int n = 10;
-  vector<GenericKey *> keys;
+  vector<GenericKey<16> *> keys;
   vector<RowId> values;
-  vector<GenericKey *> delete_seq;
-  map<GenericKey *, RowId> kv_map;
+  vector<GenericKey<16> *> delete_seq;
+  map<GenericKey<16> *, RowId> kv_map;
   for (int i = 0; i < n; i++) {
-    GenericKey *key = KP.InitKey();
+    GenericKey<16> *key = new GenericKey<16>;
     std::vector<Field> fields{Field(TypeId::kTypeInt, i)};
     KP.SerializeFromKey(key, Row(fields), table_schema);
     keys.push_back(key);
     values.push_back(RowId(i));
     delete_seq.push_back(key);
   }
-  vector<GenericKey *> keys_copy(keys);
+  vector<GenericKey<16> *> keys_copy(keys);
   // Shuffle data
   ShuffleArray(keys);
   ShuffleArray(values);
@@ -12,21 +12,21 @@ TEST(BPlusTreeTests, IndexIteratorTest) {
       new Column("int", TypeId::kTypeInt, 0, false, false),
   };
   Schema *table_schema = new Schema(columns);
-  KeyManager KP(table_schema, 16);
-  BPlusTree tree(0, engine.bpm_, KP);
+  KeyManager KP(table_schema);
+  BPlusTree<16> tree(0, engine.bpm_, KP);
   // Generate insert record
-  vector<GenericKey *> insert_key;
+  vector<GenericKey<16> *> insert_key;
   for (int i = 1; i <= 50; i++) {
-    GenericKey *key = KP.InitKey();
+    GenericKey<16> *key = new GenericKey<16>;
     std::vector<Field> fields{Field(TypeId::kTypeInt, i)};
     KP.SerializeFromKey(key, Row(fields), table_schema);
     insert_key.emplace_back(key);
     tree.Insert(key, RowId(i * 100), nullptr);
   }
   // Generate delete record
-  vector<GenericKey *> delete_key;
+  vector<GenericKey<16> *> delete_key;
   for (int i = 2; i <= 50; i += 2) {
-    GenericKey *key = KP.InitKey();
+    GenericKey<16> *key = new GenericKey<16>;
     std::vector<Field> fields{Field(TypeId::kTypeInt, i)};
     KP.SerializeFromKey(key, Row(fields), table_schema);
     delete_key.emplace_back(key);
@@ -34,12 +34,12 @@ TEST(BPlusTreeTests, IndexIteratorTest) {
   }
   // Search keys
   vector<RowId> v;
-  vector<GenericKey *> not_delete_key;
+  vector<GenericKey<16> *> not_delete_key;
   for (auto key : delete_key) {
     ASSERT_FALSE(tree.GetValue(key, v));
   }
   for (int i = 1; i <= 49; i += 2) {
-    GenericKey *key = KP.InitKey();
+    GenericKey<16> *key = new GenericKey<16>;
     std::vector<Field> fields{Field(TypeId::kTypeInt, i)};
     KP.SerializeFromKey(key, Row(fields), table_schema);
     not_delete_key.emplace_back(key);
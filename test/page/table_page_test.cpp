@@ -0,0 +1,160 @@
+#include "page/table_page.h"
+
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "record/field.h"
+#include "record/schema.h"
+
+using Fields = std::vector<Field>;
+
+TEST(PageTests, TablePageSlotReuseTest) {
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 256, 1, true, false)};
+  Schema schema(columns);
+  char characters[256];
+  memset(characters, 'x', sizeof(characters));
+  auto make_row = [&](int id, uint32_t len) {
+    Fields fields{Field(TypeId::kTypeInt, id), Field(TypeId::kTypeChar, characters, len, true)};
+    return Row(fields);
+  };
+  auto page = std::make_unique<Page>();
+  auto table_page = reinterpret_cast<TablePage *>(page.get());
+  table_page->Init(0, INVALID_PAGE_ID, nullptr, nullptr);
+  std::vector<RowId> rids;
+  for (int i = 0;; i++) {
+    Row row = make_row(i, 200);
+    if (!table_page->InsertTuple(row, &schema, nullptr, nullptr, nullptr)) {
+      break;
+    }
+    rids.push_back(row.GetRowId());
+  }
+  ASSERT_GT(rids.size(), 4);
+  uint32_t full_free_space = table_page->GetFreeSpaceRemaining();
+  // Scenario: the slots of deleted tuples are reused, the last one freed first, and their bytes with them.
+  table_page->ApplyDelete(rids[1], nullptr, nullptr);
+  table_page->ApplyDelete(rids[3], nullptr, nullptr);
+  for (int slot : {3, 1}) {
+    Row row = make_row(slot, 200);
+    ASSERT_TRUE(table_page->InsertTuple(row, &schema, nullptr, nullptr, nullptr));
+    EXPECT_EQ(slot, row.GetRowId().GetSlotNum());
+  }
+  EXPECT_EQ(full_free_space, table_page->GetFreeSpaceRemaining());
+  Row too_large = make_row(0, 200);
+  EXPECT_FALSE(table_page->InsertTuple(too_large, &schema, nullptr, nullptr, nullptr));
+  // Scenario: shrinking and growing tuples in turn never runs out of space, the page is compacted on demand.
+  for (int round = 0; round < 100; round++) {
+    for (size_t i = 0; i < rids.size(); i++) {
+      Row new_row = make_row(i, round % 2 == 0 ? 100 : 200);
+      Row old_row(rids[i]);
+      ASSERT_EQ(TablePage::updateSuccess,
+                table_page->UpdateTuple(new_row, &old_row, &schema, nullptr, nullptr, nullptr));
+    }
+  }
+  EXPECT_EQ(full_free_space, table_page->GetFreeSpaceRemaining());
+  // every tuple can still be read back
+  for (size_t i = 0; i < rids.size(); i++) {
+    Row row(rids[i]);
+    ASSERT_TRUE(table_page->GetTuple(&row, &schema, nullptr, nullptr));
+    Row expected = make_row(i, 200);
+    EXPECT_EQ(CmpBool::kTrue, row.GetField(0)->CompareEquals(*expected.GetField(0)));
+    EXPECT_EQ(CmpBool::kTrue, row.GetField(1)->CompareEquals(*expected.GetField(1)));
+  }
+}
+
+TEST(PageTests, TablePageEarlierFormatTest) {
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 256, 1, true, false)};
+  Schema schema(columns);
+  char characters[256];
+  memset(characters, 'x', sizeof(characters));
+  auto make_row = [&](int id, uint32_t len) {
+    Fields fields{Field(TypeId::kTypeInt, id), Field(TypeId::kTypeChar, characters, len, true)};
+    return Row(fields);
+  };
+  // the earlier layout: PageId, LSN, PrevPageId, NextPageId, FreeSpacePointer, TupleCount, then the slots
+  const uint32_t earlier_header = 24;
+  auto write_earlier_page = [&](Page *page, const std::vector<uint32_t> &lens) {
+    char *data = page->GetData();
+    memset(data, 0, PAGE_SIZE);
+    page_id_t links[2] = {INVALID_PAGE_ID, INVALID_PAGE_ID};
+    memcpy(data + 8, links, sizeof(links));
+    uint32_t free_space_pointer = PAGE_SIZE;
+    for (uint32_t i = 0; i < lens.size(); i++) {
+      uint32_t slot[2] = {0, 0};
+      // a length of 0 is a deleted tuple
+      if (lens[i] > 0) {
+        Row row = make_row(i, lens[i]);
+        slot[1] = row.GetSerializedSize(&schema);
+        free_space_pointer -= slot[1];
+        slot[0] = free_space_pointer;
+        row.SerializeTo(data + free_space_pointer, &schema);
+      }
+      memcpy(data + earlier_header + 8 * i, slot, sizeof(slot));
+    }
+    uint32_t count = lens.size();
+    memcpy(data + 16, &free_space_pointer, sizeof(uint32_t));
+    memcpy(data + 20, &count, sizeof(uint32_t));
+    return free_space_pointer - earlier_header - 8 * count;
+  };
+  auto expect_tuple = [&](TablePage *table_page, uint32_t slot, uint32_t len) {
+    Row row(RowId(0, slot));
+    ASSERT_TRUE(table_page->GetTuple(&row, &schema, nullptr, nullptr));
+    Row expected = make_row(slot, len);
+    EXPECT_EQ(CmpBool::kTrue, row.GetField(0)->CompareEquals(*expected.GetField(0)));
+    EXPECT_EQ(CmpBool::kTrue, row.GetField(1)->CompareEquals(*expected.GetField(1)));
+  };
+  auto page = std::make_unique<Page>();
+  auto table_page = reinterpret_cast<TablePage *>(page.get());
+
+  // Scenario: a page with room, the free slot in the middle is reused, the trailing one is dropped.
+  std::vector<uint32_t> lens{200, 0, 100, 200, 0};
+  uint32_t free_space = write_earlier_page(page.get(), lens);
+  Row row;
+  EXPECT_FALSE(table_page->ConvertEarlierFormat(&row, &schema));
+  EXPECT_EQ(free_space, table_page->GetFreeSpaceRemaining());
+  for (uint32_t slot : {0, 2, 3}) {
+    expect_tuple(table_page, slot, lens[slot]);
+  }
+  Row new_row = make_row(1, 50);
+  ASSERT_TRUE(table_page->InsertTuple(new_row, &schema, nullptr, nullptr, nullptr));
+  EXPECT_EQ(1, new_row.GetRowId().GetSlotNum());
+  new_row = make_row(4, 50);
+  ASSERT_TRUE(table_page->InsertTuple(new_row, &schema, nullptr, nullptr, nullptr));
+  EXPECT_EQ(4, new_row.GetRowId().GetSlotNum());
+
+  // Scenario: a page with less free space than the header grows by gives back the tuple of its last slot.
+  lens.clear();
+  uint32_t row_size = make_row(0, 200).GetSerializedSize(&schema);
+  // a tuple of the last slot with its slot, without its chars, leaving 4 bytes free
+  uint32_t last_overhead = make_row(0, 1).GetSerializedSize(&schema) - 1 + 8 + 4;
+  uint32_t used = earlier_header;
+  while (used + (row_size + 8) + last_overhead <= PAGE_SIZE) {
+    lens.push_back(200);
+    used += row_size + 8;
+  }
+  uint32_t last_len = PAGE_SIZE - used - last_overhead;
+  ASSERT_GE(last_len, 4);
+  lens.push_back(last_len);
+  ASSERT_EQ(4, write_earlier_page(page.get(), lens));
+  ASSERT_TRUE(table_page->ConvertEarlierFormat(&row, &schema));
+  uint32_t last_slot = lens.size() - 1;
+  EXPECT_EQ(RowId(0, last_slot), row.GetRowId());
+  Row expected = make_row(last_slot, last_len);
+  EXPECT_EQ(CmpBool::kTrue, row.GetField(1)->CompareEquals(*expected.GetField(1)));
+  for (uint32_t slot = 0; slot < last_slot; slot++) {
+    expect_tuple(table_page, slot, lens[slot]);
+  }
+  // the bytes of the tuple taken out are dead space, a tuple 4 bytes shorter than it fits once the page is compacted
+  EXPECT_EQ(4 + row.GetSerializedSize(&schema), table_page->GetFreeSpaceRemaining());
+  EXPECT_FALSE(table_page->InsertTuple(row, &schema, nullptr, nullptr, nullptr));
+  new_row = make_row(last_slot, last_len - 4);
+  ASSERT_TRUE(table_page->InsertTuple(new_row, &schema, nullptr, nullptr, nullptr));
+  EXPECT_EQ(last_slot, new_row.GetRowId().GetSlotNum());
+  EXPECT_EQ(0, table_page->GetFreeSpaceRemaining());
+  expect_tuple(table_page, last_slot, last_len - 4);
+  for (uint32_t slot = 0; slot < last_slot; slot++) {
+    expect_tuple(table_page, slot, lens[slot]);
+  }
+}
@@ -5,6 +5,7 @@
 #include "page/table_page.h"
 #include "record/field.h"
 #include "record/row.h"
+#include "record/row_view.h"
 #include "record/schema.h"
 
 char *chars[] = {const_cast<char *>(""), const_cast<char *>("hello"), const_cast<char *>("world!"),
@@ -93,11 +94,233 @@ TEST(TupleTest, RowTest) {
   ASSERT_EQ(row.GetRowId(), first_tuple_rid);
   Row row2(row.GetRowId());
   ASSERT_TRUE(table_page.GetTuple(&row2, schema.get(), nullptr, nullptr));
-  std::vector<Field *> &row2_fields = row2.GetFields();
+  auto &row2_fields = row2.GetFields();
   ASSERT_EQ(3, row2_fields.size());
   for (size_t i = 0; i < row2_fields.size(); i++) {
-    ASSERT_EQ(CmpBool::kTrue, row2_fields[i]->CompareEquals(fields[i]));
+    ASSERT_EQ(CmpBool::kTrue, row2_fields[i].CompareEquals(fields[i]));
   }
   ASSERT_TRUE(table_page.MarkDelete(row.GetRowId(), nullptr, nullptr, nullptr));
   table_page.ApplyDelete(row.GetRowId(), nullptr, nullptr);
-}
\ No newline at end of file
+}
+
+TEST(TupleTest, RowViewTest) {
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 64, 1, true, false),
+                                   new Column("nick", TypeId::kTypeChar, 64, 2, true, false),
+                                   new Column("account", TypeId::kTypeFloat, 3, true, false)};
+  std::vector<Field> fields = {Field(TypeId::kTypeInt, 188),
+                               Field(TypeId::kTypeChar, const_cast<char *>("minisql"), strlen("minisql"), false),
+                               Field(TypeId::kTypeChar), Field(TypeId::kTypeFloat, 19.99f)};
+  auto schema = std::make_shared<Schema>(columns);
+  Row row(fields);
+  char buffer[PAGE_SIZE];
+  row.SerializeTo(buffer, schema.get());
+  RowView view(buffer, schema.get(), RowId(1, 2));
+  ASSERT_EQ(RowId(1, 2), view.GetRowId());
+  ASSERT_EQ(4, view.GetFieldCount());
+  // read out of order, the offsets are found lazily
+  ASSERT_EQ(CmpBool::kTrue, view.GetField(3).CompareEquals(fields[3]));
+  ASSERT_EQ(CmpBool::kTrue, view.GetField(0).CompareEquals(fields[0]));
+  ASSERT_TRUE(view.IsNull(2));
+  ASSERT_TRUE(view.GetField(2).IsNull());
+  Field name = view.GetField(1);
+  ASSERT_EQ(CmpBool::kTrue, name.CompareEquals(fields[1]));
+  // the chars are read in place
+  ASSERT_TRUE(name.GetData() > buffer && name.GetData() < buffer + PAGE_SIZE);
+  Row copy;
+  view.ToRow(&copy);
+  ASSERT_EQ(RowId(1, 2), copy.GetRowId());
+  ASSERT_EQ(4, copy.GetFieldCount());
+  ASSERT_EQ(CmpBool::kTrue, copy.GetField(1)->CompareEquals(fields[1]));
+  ASSERT_TRUE(copy.GetField(2)->IsNull());
+}
+
+TEST(TupleTest, RowFormatTest) {
+  // wide rows with nulls past the 32nd column
+  const uint32_t column_nums = 40;
+  std::vector<Column *> columns;
+  std::vector<Field> fields;
+  for (uint32_t i = 0; i < column_nums; i++) {
+    std::string name = "c" + std::to_string(i);
+    if (i % 2 == 0) {
+      columns.push_back(new Column(name, TypeId::kTypeInt, i, true, false));
+      fields.emplace_back(i % 3 == 0 ? Field(TypeId::kTypeInt) : Field(TypeId::kTypeInt, static_cast<int32_t>(i)));
+    } else {
+      columns.push_back(new Column(name, TypeId::kTypeChar, 16, i, true, false));
+      fields.emplace_back(i % 3 == 0 ? Field(TypeId::kTypeChar)
+                                     : Field(TypeId::kTypeChar, chars[i % 3], strlen(chars[i % 3]), false));
+    }
+  }
+  auto schema = std::make_shared<Schema>(columns);
+  Row row(fields);
+  char buffer[PAGE_SIZE];
+  uint32_t size = row.SerializeTo(buffer, schema.get());
+  ASSERT_EQ(row.GetSerializedSize(schema.get()), size);
+  ASSERT_EQ(Row::FORMAT_VERSION, Row::GetFormatVersion(buffer));
+  Row row2;
+  ASSERT_EQ(size, row2.DeserializeFrom(buffer, schema.get()));
+  RowView view(buffer, schema.get());
+  for (uint32_t i = 0; i < column_nums; i++) {
+    ASSERT_EQ(fields[i].IsNull(), row2.GetField(i)->IsNull());
+    ASSERT_EQ(fields[i].IsNull(), view.IsNull(i));
+    if (!fields[i].IsNull()) {
+      ASSERT_EQ(CmpBool::kTrue, row2.GetField(i)->CompareEquals(fields[i]));
+      ASSERT_EQ(CmpBool::kTrue, view.GetField(i).CompareEquals(fields[i]));
+    }
+  }
+
+  // rows of the previous format are still read
+  std::vector<Column *> v0_columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                      new Column("name", TypeId::kTypeChar, 64, 1, true, false),
+                                      new Column("account", TypeId::kTypeFloat, 2, true, false)};
+  auto v0_schema = std::make_shared<Schema>(v0_columns);
+  char *p = buffer;
+  MACH_WRITE_UINT32(p, 3);
+  MACH_WRITE_UINT32(p + 4, 0);
+  p += 8;
+  p += int_fields[0].SerializeTo(p);
+  p += char_fields[1].SerializeTo(p);
+  p += float_fields[1].SerializeTo(p);
+  Row v0_row;
+  ASSERT_EQ(p - buffer, v0_row.DeserializeFrom(buffer, v0_schema.get()));
+  RowView v0_view(buffer, v0_schema.get());
+  ASSERT_EQ(CmpBool::kTrue, v0_row.GetField(1)->CompareEquals(char_fields[1]));
+  ASSERT_EQ(CmpBool::kTrue, v0_view.GetField(2).CompareEquals(float_fields[1]));
+  ASSERT_EQ(CmpBool::kTrue, v0_view.GetField(1).CompareEquals(char_fields[1]));
+  // the second field is null, it takes no bytes
+  MACH_WRITE_UINT32(buffer + 4, 1 << 1);
+  memmove(buffer + 12, buffer + 12 + char_fields[1].GetSerializedSize(), 4);
+  Row v0_null_row;
+  ASSERT_EQ(16, v0_null_row.DeserializeFrom(buffer, v0_schema.get()));
+  ASSERT_TRUE(v0_null_row.GetField(1)->IsNull());
+  ASSERT_EQ(CmpBool::kTrue, v0_null_row.GetField(2)->CompareEquals(float_fields[1]));
+  ASSERT_TRUE(RowView(buffer, v0_schema.get()).IsNull(1));
+}
+
+TEST(TupleTest, ArenaRowTest) {
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 64, 1, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  std::vector<Field> fields = {Field(TypeId::kTypeInt, 188),
+                               Field(TypeId::kTypeChar, chars[2], strlen(chars[2]), false)};
+  Row row(fields);
+  char buffer[PAGE_SIZE];
+  row.SerializeTo(buffer, schema.get());
+
+  Row heap_copy;
+  auto arena = std::make_unique<Arena>();
+  {
+    Row arena_row(arena.get());
+    arena_row.DeserializeFrom(buffer, schema.get());
+    ASSERT_EQ(arena.get(), arena_row.GetArena());
+    ASSERT_LT(0, arena->GetAllocatedBytes());
+    // the chars are copied out of the buffer
+    memset(buffer, 0, sizeof(buffer));
+    ASSERT_EQ(CmpBool::kTrue, arena_row.GetField(1)->CompareEquals(char_fields[2]));
+    Row arena_copy(arena_row);
+    ASSERT_EQ(arena.get(), arena_copy.GetArena());
+    heap_copy = arena_copy;
+    ASSERT_EQ(nullptr, heap_copy.GetArena());
+    arena_row.AddField(Field(TypeId::kTypeFloat, 19.99f));
+    ASSERT_EQ(3, arena_row.GetFieldCount());
+  }
+  // the heap copy stays valid once the arena is gone
+  arena.reset();
+  ASSERT_EQ(CmpBool::kTrue, heap_copy.GetField(0)->CompareEquals(fields[0]));
+  ASSERT_EQ(CmpBool::kTrue, heap_copy.GetField(1)->CompareEquals(char_fields[2]));
+}
+
+TEST(TupleTest, FieldMoveTest) {
+  char long_chars[] = "a string longer than the inline buffer of a field";
+  Field short_field(TypeId::kTypeChar, chars[1], strlen(chars[1]), true);
+  Field long_field(TypeId::kTypeChar, long_chars, strlen(long_chars), true);
+  // short chars are copied into the field, long ones into their own buffer
+  ASSERT_NE(chars[1], short_field.GetData());
+  ASSERT_NE(long_chars, long_field.GetData());
+  ASSERT_EQ(CmpBool::kTrue, short_field.CompareEquals(char_fields[1]));
+  ASSERT_EQ("hello", short_field.toString());
+
+  Field short_copy(short_field);
+  ASSERT_NE(short_field.GetData(), short_copy.GetData());
+  ASSERT_EQ(CmpBool::kTrue, short_copy.CompareEquals(short_field));
+  const char *data = long_field.GetData();
+  Field long_moved(std::move(long_field));
+  ASSERT_EQ(data, long_moved.GetData());
+  ASSERT_TRUE(long_field.IsNull());
+  long_field = long_moved;
+  ASSERT_NE(data, long_field.GetData());
+  ASSERT_EQ(CmpBool::kTrue, long_field.CompareEquals(long_moved));
+
+  std::vector<Field> fields;
+  fields.emplace_back(TypeId::kTypeInt, 188);
+  fields.emplace_back(std::move(short_copy));
+  fields.emplace_back(std::move(long_moved));
+  Row row(std::move(fields));
+  ASSERT_EQ(3, row.GetFieldCount());
+  ASSERT_EQ(data, row.GetField(2)->GetData());
+  Row moved(std::move(row));
+  ASSERT_EQ(0, row.GetFieldCount());
+  ASSERT_EQ(data, moved.GetField(2)->GetData());
+  ASSERT_EQ(CmpBool::kTrue, moved.GetField(1)->CompareEquals(char_fields[1]));
+  row = std::move(moved);
+  ASSERT_EQ(3, row.GetFieldCount());
+  ASSERT_EQ(data, row.GetField(2)->GetData());
+}
+
+TEST(TupleTest, FieldKernelTest) {
+  const CmpOp ops[] = {CmpOp::kEquals,         CmpOp::kNotEquals,   CmpOp::kLessThan,
+                       CmpOp::kLessThanEquals, CmpOp::kGreaterThan, CmpOp::kGreaterThanEquals};
+  auto compare = [](const Field &lhs, const Field &rhs, CmpOp op) {
+    switch (op) {
+      case CmpOp::kEquals:
+        return lhs.CompareEquals(rhs);
+      case CmpOp::kNotEquals:
+        return lhs.CompareNotEquals(rhs);
+      case CmpOp::kLessThan:
+        return lhs.CompareLessThan(rhs);
+      case CmpOp::kLessThanEquals:
+        return lhs.CompareLessThanEquals(rhs);
+      case CmpOp::kGreaterThan:
+        return lhs.CompareGreaterThan(rhs);
+      default:
+        return lhs.CompareGreaterThanEquals(rhs);
+    }
+  };
+  // the kernels picked up front agree with the comparisons of Field, nulls included
+  for (CmpOp op : ops) {
+    auto int_comparator = GetFieldComparator(kTypeInt, op);
+    auto float_comparator = GetFieldComparator(kTypeFloat, op);
+    auto char_comparator = GetFieldComparator(kTypeChar, op);
+    for (auto &lhs : int_fields) {
+      for (auto &rhs : int_fields) {
+        ASSERT_EQ(compare(lhs, rhs, op), int_comparator(lhs, rhs));
+      }
+      ASSERT_EQ(CmpBool::kNull, int_comparator(lhs, null_fields[0]));
+    }
+    for (auto &lhs : float_fields) {
+      for (auto &rhs : float_fields) {
+        ASSERT_EQ(compare(lhs, rhs, op), float_comparator(lhs, rhs));
+      }
+    }
+    for (auto &lhs : char_fields) {
+      for (auto &rhs : char_fields) {
+        ASSERT_EQ(compare(lhs, rhs, op), char_comparator(lhs, rhs));
+      }
+      ASSERT_EQ(CmpBool::kNull, char_comparator(null_fields[2], lhs));
+    }
+  }
+  ASSERT_EQ(CmpBool::kTrue, int_fields[1].CompareLessThan(int_fields[0]));
+  ASSERT_EQ(CmpBool::kTrue, char_fields[0].CompareLessThan(char_fields[1]));
+  ASSERT_EQ(CmpBool::kTrue, char_fields[1].CompareLessThan(char_fields[2]));
+
+  auto int_order = GetFieldOrder(kTypeInt);
+  auto char_order = GetFieldOrder(kTypeChar);
+  ASSERT_EQ(-1, int_order(int_fields[1], int_fields[0]));
+  ASSERT_EQ(1, int_order(int_fields[0], int_fields[1]));
+  ASSERT_EQ(0, int_order(int_fields[0], int_fields[0]));
+  ASSERT_EQ(0, int_order(int_fields[0], null_fields[0]));
+  char hell[] = "hell";
+  ASSERT_EQ(-1, char_order(Field(kTypeChar, hell, strlen(hell), false), char_fields[1]));
+  ASSERT_EQ(1, char_order(char_fields[2], char_fields[1]));
+  ASSERT_EQ(0, GetFieldOrder(kTypeFloat)(float_fields[2], float_fields[2]));
+}
@@ -1,6 +1,9 @@
 #include "storage/disk_manager.h"
 
+#include <future>
+#include <thread>
 #include <unordered_set>
+#include <vector>
 
 #include "gtest/gtest.h"
 
@@ -34,6 +37,49 @@ TEST(DiskManagerTest, BitMapPageTest) {
   ASSERT_FALSE(bitmap->AllocatePage(ofs));
 }
 
+TEST(DiskManagerTest, BitMapPageRunTest) {
+  const size_t size = 512;
+  char buf[size];
+  memset(buf, 0, size);
+  auto *bitmap = reinterpret_cast<BitmapPage<size> *>(buf);
+  const uint32_t num_pages = bitmap->GetMaxSupportedSize();
+  uint32_t ofs;
+  std::vector<uint32_t> run(num_pages);
+  // Scenario: runs are contiguous and handed out in order, across word boundaries.
+  ASSERT_TRUE(bitmap->AllocatePages(60, run.data()));
+  ASSERT_EQ(0, run[0]);
+  ASSERT_EQ(59, run[59]);
+  ASSERT_TRUE(bitmap->AllocatePages(10, run.data()));
+  ASSERT_EQ(60, run[0]);
+  ASSERT_EQ(69, run[9]);
+  ASSERT_TRUE(bitmap->AllocatePage(ofs));
+  ASSERT_EQ(70, ofs);
+  // Scenario: holes smaller than the run are skipped, and single pages still fill them.
+  ASSERT_TRUE(bitmap->DeAllocatePage(3));
+  ASSERT_TRUE(bitmap->DeAllocatePage(63));
+  ASSERT_TRUE(bitmap->DeAllocatePage(64));
+  ASSERT_TRUE(bitmap->AllocatePages(3, run.data()));
+  ASSERT_EQ(71, run[0]);
+  ASSERT_TRUE(bitmap->AllocatePages(2, run.data()));
+  ASSERT_EQ(63, run[0]);
+  ASSERT_EQ(64, run[1]);
+  ASSERT_TRUE(bitmap->AllocatePage(ofs));
+  ASSERT_EQ(3, ofs);
+  ASSERT_TRUE(bitmap->AllocatePage(ofs));
+  ASSERT_EQ(74, ofs);
+  // Scenario: a run that does not fit allocates nothing.
+  uint32_t left = num_pages - 75;
+  ASSERT_FALSE(bitmap->AllocatePages(left + 1, run.data()));
+  ASSERT_TRUE(bitmap->IsPageFree(75));
+  ASSERT_TRUE(bitmap->AllocatePages(left, run.data()));
+  ASSERT_EQ(num_pages - 1, run[left - 1]);
+  ASSERT_FALSE(bitmap->AllocatePage(ofs));
+  // Scenario: the last page of a full bitmap is found again.
+  ASSERT_TRUE(bitmap->DeAllocatePage(num_pages - 1));
+  ASSERT_TRUE(bitmap->AllocatePage(ofs));
+  ASSERT_EQ(num_pages - 1, ofs);
+}
+
 TEST(DiskManagerTest, FreePageAllocationTest) {
   std::string db_name = "disk_test.db";
   remove(db_name.c_str());
@@ -56,4 +102,224 @@ TEST(DiskManagerTest, FreePageAllocationTest) {
   EXPECT_EQ(extent_nums * DiskManager::BITMAP_SIZE - 5, meta_page->GetAllocatedPages());
   EXPECT_EQ(DiskManager::BITMAP_SIZE - 2, meta_page->GetExtentUsedPage(0));
   EXPECT_EQ(DiskManager::BITMAP_SIZE - 3, meta_page->GetExtentUsedPage(1));
-}
\ No newline at end of file
+}
+
+TEST(DiskManagerTest, FreeSpacePersistenceTest) {
+  std::string db_name = "disk_fsm_test.db";
+  remove(db_name.c_str());
+  auto *disk_mgr = new DiskManager(db_name);
+  const uint32_t num_pages = DiskManager::BITMAP_SIZE + 10;
+  for (uint32_t i = 0; i < num_pages; i++) {
+    ASSERT_EQ(i, disk_mgr->AllocatePage());
+  }
+  // Scenario: a hole in the first extent is refilled before the second extent is used further.
+  disk_mgr->DeAllocatePage(5);
+  disk_mgr->DeAllocatePage(DiskManager::BITMAP_SIZE + 3);
+  EXPECT_TRUE(disk_mgr->IsPageFree(5));
+  EXPECT_FALSE(disk_mgr->IsPageFree(6));
+  EXPECT_TRUE(disk_mgr->IsPageFree(3 * DiskManager::BITMAP_SIZE));
+  delete disk_mgr;
+  // Scenario: the cached bitmaps and the meta page are written back on close.
+  disk_mgr = new DiskManager(db_name);
+  auto *meta_page = reinterpret_cast<DiskFileMetaPage *>(disk_mgr->GetMetaData());
+  EXPECT_EQ(num_pages - 2, meta_page->GetAllocatedPages());
+  EXPECT_EQ(2, meta_page->GetExtentNums());
+  EXPECT_TRUE(disk_mgr->IsPageFree(5));
+  EXPECT_TRUE(disk_mgr->IsPageFree(DiskManager::BITMAP_SIZE + 3));
+  EXPECT_FALSE(disk_mgr->IsPageFree(DiskManager::BITMAP_SIZE + 4));
+  EXPECT_EQ(5, disk_mgr->AllocatePage());
+  EXPECT_EQ(DiskManager::BITMAP_SIZE + 3, disk_mgr->AllocatePage());
+  EXPECT_EQ(num_pages, disk_mgr->AllocatePage());
+  delete disk_mgr;
+  remove(db_name.c_str());
+}
+
+TEST(DiskManagerTest, MetaPageChainTest) {
+  if (MAX_META_PAGES < 2) {
+    GTEST_SKIP() << "one group of extents already covers page_id_t with this page size";
+  }
+  std::string db_name = "disk_chain_test.db";
+  remove(db_name.c_str());
+  auto *disk_mgr = new DiskManager(db_name);
+  // Scenario: once every extent of the first meta page is full, pages come from the group of the next meta page.
+  for (uint32_t i = 0; i < EXTENTS_PER_META_PAGE; i++) {
+    ASSERT_EQ(i * DiskManager::BITMAP_SIZE, disk_mgr->AllocatePages(DiskManager::BITMAP_SIZE));
+  }
+  const page_id_t page_id = disk_mgr->AllocatePage();
+  ASSERT_EQ(EXTENTS_PER_META_PAGE * DiskManager::BITMAP_SIZE, page_id);
+  // Scenario: the page lies far beyond 4 GB in the (sparse) file and still reads back after a reopen.
+  char data[PAGE_SIZE];
+  memset(data, 7, PAGE_SIZE);
+  disk_mgr->WritePage(page_id, data);
+  delete disk_mgr;
+  disk_mgr = new DiskManager(db_name);
+  memset(data, 0, PAGE_SIZE);
+  disk_mgr->ReadPage(page_id, data);
+  EXPECT_EQ(std::vector<char>(PAGE_SIZE, 7), std::vector<char>(data, data + PAGE_SIZE));
+  auto *meta_page = reinterpret_cast<DiskFileMetaPage *>(disk_mgr->GetMetaData());
+  EXPECT_EQ(EXTENTS_PER_META_PAGE * DiskManager::BITMAP_SIZE + 1, meta_page->GetAllocatedPages());
+  EXPECT_EQ(EXTENTS_PER_META_PAGE + 1, meta_page->GetExtentNums());
+  EXPECT_FALSE(disk_mgr->IsPageFree(page_id));
+  EXPECT_TRUE(disk_mgr->IsPageFree(page_id + 1));
+  // Scenario: pages freed in the first group are reused before the second group grows.
+  disk_mgr->DeAllocatePage(5);
+  EXPECT_EQ(5, disk_mgr->AllocatePage());
+  EXPECT_EQ(page_id + 1, disk_mgr->AllocatePage());
+  delete disk_mgr;
+  remove(db_name.c_str());
+}
+
+TEST(DiskManagerTest, PageSizeMismatchTest) {
+  std::string db_name = "disk_page_size_test.db";
+  remove(db_name.c_str());
+  auto *disk_mgr = new DiskManager(db_name);
+  ASSERT_EQ(0, disk_mgr->AllocatePage());
+  delete disk_mgr;
+  // Scenario: the page size is recorded at creation and survives a reopen.
+  disk_mgr = new DiskManager(db_name);
+  EXPECT_EQ(PAGE_SIZE, reinterpret_cast<DiskFileMetaPage *>(disk_mgr->GetMetaData())->GetPageSize());
+  EXPECT_FALSE(disk_mgr->IsPageFree(0));
+  delete disk_mgr;
+  // Scenario: a file created with another page size is rejected instead of being misread.
+  FILE *file = fopen(db_name.c_str(), "r+b");
+  ASSERT_NE(nullptr, file);
+  uint32_t other_page_size = PAGE_SIZE * 2;
+  fseek(file, offsetof(DiskFileMetaPage, page_size_), SEEK_SET);
+  fwrite(&other_page_size, sizeof(other_page_size), 1, file);
+  fclose(file);
+  EXPECT_THROW(DiskManager disk_mgr_2(db_name), std::runtime_error);
+  remove(db_name.c_str());
+}
+
+TEST(DiskManagerTest, EarlierFormatTest) {
+  std::string db_name = "disk_earlier_format_test.db";
+  remove(db_name.c_str());
+  auto *disk_mgr = new DiskManager(db_name);
+  for (int i = 0; i < 10; i++) {
+    ASSERT_EQ(i, disk_mgr->AllocatePage());
+  }
+  delete disk_mgr;
+  // a file of an earlier build has no trailer, its place holds the used page counts of the last extents
+  auto write_trailer = [&](uint32_t format_version, uint32_t page_size, uint32_t magic) {
+    FILE *file = fopen(db_name.c_str(), "r+b");
+    ASSERT_NE(nullptr, file);
+    uint32_t trailer[] = {format_version, page_size, magic};
+    fseek(file, offsetof(DiskFileMetaPage, format_version_), SEEK_SET);
+    fwrite(trailer, sizeof(trailer), 1, file);
+    fclose(file);
+  };
+  write_trailer(0, 0, 0);
+  if (PAGE_SIZE != 4096) {
+    // Scenario: earlier builds only had 4 KB pages, their files are rejected by builds with other page sizes.
+    EXPECT_THROW(DiskManager disk_mgr_2(db_name), std::runtime_error);
+    remove(db_name.c_str());
+    return;
+  }
+  // Scenario: a file of an earlier build keeps its pages and gets a trailer.
+  disk_mgr = new DiskManager(db_name);
+  auto *meta_page = reinterpret_cast<DiskFileMetaPage *>(disk_mgr->GetMetaData());
+  EXPECT_TRUE(meta_page->HasTrailer());
+  EXPECT_EQ(PAGE_SIZE, meta_page->GetPageSize());
+  EXPECT_EQ(DISK_FORMAT_VERSION, meta_page->GetFormatVersion());
+  EXPECT_EQ(10, meta_page->GetAllocatedPages());
+  for (int i = 0; i < 10; i++) {
+    EXPECT_FALSE(disk_mgr->IsPageFree(i));
+  }
+  EXPECT_TRUE(disk_mgr->IsPageFree(10));
+  delete disk_mgr;
+  // Scenario: an earlier file that uses the extents in the place of the trailer is rejected, even if the count of
+  // an extent happens to equal the page size.
+  write_trailer(0, PAGE_SIZE, 0);
+  EXPECT_THROW(DiskManager disk_mgr_2(db_name), std::runtime_error);
+  // Scenario: a file of a later format version is rejected.
+  write_trailer(DISK_FORMAT_VERSION + 1, PAGE_SIZE, META_PAGE_MAGIC);
+  EXPECT_THROW(DiskManager disk_mgr_2(db_name), std::runtime_error);
+  remove(db_name.c_str());
+}
+
+TEST(DiskManagerTest, PageReadWriteTest) {
+  std::string db_name = "disk_rw_test.db";
+  for (bool direct_io : {false, true}) {
+    remove(db_name.c_str());
+    auto *disk_mgr = new DiskManager(db_name, direct_io);
+    const int num_pages = 64;
+    // Scenario: pages past the end of the file read as zeros.
+    char data[PAGE_SIZE];
+    memset(data, 1, PAGE_SIZE);
+    disk_mgr->ReadPage(num_pages, data);
+    for (char c : data) {
+      ASSERT_EQ(0, c);
+    }
+    // Scenario: unaligned buffers work in both modes, and concurrent readers see what was written.
+    for (int i = 0; i < num_pages; i++) {
+      memset(data, i, PAGE_SIZE);
+      disk_mgr->WritePage(i, data);
+    }
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+      threads.emplace_back([&, t] {
+        char buf[PAGE_SIZE + 1];
+        for (int i = t; i < num_pages; i += 4) {
+          disk_mgr->ReadPage(i, buf + 1);
+          for (int j = 0; j < PAGE_SIZE; j++) {
+            ASSERT_EQ(static_cast<char>(i), buf[j + 1]);
+          }
+        }
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    disk_mgr->Close();
+    delete disk_mgr;
+
+    // Scenario: data and meta data survive reopening the file.
+    disk_mgr = new DiskManager(db_name, direct_io);
+    disk_mgr->ReadPage(num_pages - 1, data);
+    EXPECT_EQ(static_cast<char>(num_pages - 1), data[PAGE_SIZE - 1]);
+    delete disk_mgr;
+  }
+  remove(db_name.c_str());
+}
+
+TEST(DiskManagerTest, AsyncReadWriteTest) {
+  std::string db_name = "disk_async_test.db";
+  const int num_pages = 300;
+  for (auto backend : {AsyncIO::kIoUring, AsyncIO::kThreadPool}) {
+    for (bool direct_io : {false, true}) {
+      remove(db_name.c_str());
+      auto *disk_mgr = new DiskManager(db_name, direct_io, backend);
+      // Scenario: a batch larger than the io_uring queue is written, and every page reads back.
+      std::vector<std::vector<char>> pages(num_pages, std::vector<char>(PAGE_SIZE));
+      std::vector<std::pair<page_id_t, const char *>> batch;
+      for (int i = 0; i < num_pages; i++) {
+        memset(pages[i].data(), i, PAGE_SIZE);
+        batch.emplace_back(i, pages[i].data());
+      }
+      ASSERT_TRUE(disk_mgr->WritePagesAsync(batch).get());
+      std::vector<std::vector<char>> reads(num_pages + 1, std::vector<char>(PAGE_SIZE, 1));
+      std::vector<std::future<bool>> futures;
+      for (int i = 0; i <= num_pages; i++) {
+        futures.push_back(disk_mgr->ReadPageAsync(i, reads[i].data()));
+      }
+      for (int i = 0; i <= num_pages; i++) {
+        ASSERT_TRUE(futures[i].get());
+        // the last page is past the end of the file and reads as zeros
+        char expected = i < num_pages ? static_cast<char>(i) : 0;
+        ASSERT_EQ(std::vector<char>(PAGE_SIZE, expected), reads[i]);
+      }
+      // Scenario: synchronous and asynchronous I/O see each other's writes.
+      memset(pages[0].data(), 42, PAGE_SIZE);
+      ASSERT_TRUE(disk_mgr->WritePageAsync(7, pages[0].data()).get());
+      disk_mgr->ReadPage(7, reads[0].data());
+      EXPECT_EQ(42, reads[0][PAGE_SIZE - 1]);
+      // Scenario: asynchronous I/O after Close() fails instead of touching the closed file.
+      disk_mgr->Close();
+      EXPECT_FALSE(disk_mgr->ReadPageAsync(7, reads[0].data()).get());
+      EXPECT_FALSE(disk_mgr->WritePagesAsync(batch).get());
+      disk_mgr->GetAsyncIOBackend();
+      delete disk_mgr;
+    }
+  }
+  remove(db_name.c_str());
+}
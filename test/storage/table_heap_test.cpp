@@ -1,5 +1,8 @@
 #include "storage/table_heap.h"
 
+#include <algorithm>
+#include <chrono>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -61,3 +64,387 @@ TEST(TableHeapTest, TableHeapSampleTest) {
   }
   ASSERT_EQ(size, 0);
 }
+
+TEST(TableHeapTest, ReadAheadScanTest) {
+  remove(db_file_name.c_str());
+  auto disk_mgr_ = new DiskManager(db_file_name);
+  auto bpm_ = new BufferPoolManager(DEFAULT_BUFFER_POOL_SIZE, disk_mgr_);
+  const int row_nums = 5000;
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 64, 1, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  TableHeap *table_heap = TableHeap::Create(bpm_, schema.get(), nullptr, nullptr, nullptr);
+  char characters[64];
+  memset(characters, 'x', sizeof(characters));
+  for (int i = 0; i < row_nums; i++) {
+    Fields fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, characters, sizeof(characters), true)};
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+  }
+  page_id_t first_page_id = table_heap->GetFirstPageId();
+  std::vector<page_id_t> page_chain;
+  for (page_id_t page_id = first_page_id; page_id != INVALID_PAGE_ID;) {
+    page_chain.push_back(page_id);
+    auto page = reinterpret_cast<TablePage *>(bpm_->FetchPage(page_id));
+    page_id_t next_page_id = page->GetNextPageId();
+    bpm_->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+  ASSERT_GT(page_chain.size(), 9);
+  delete table_heap;
+  delete bpm_;
+
+  // Scenario: a new scan gets the whole read-ahead window loaded, not just the next page.
+  bpm_ = new BufferPoolManager(64, disk_mgr_, kTwoQueueReplacer);
+  table_heap = TableHeap::Create(bpm_, first_page_id, schema.get(), nullptr, nullptr);
+  table_heap->SetReadAhead(8);
+  {
+    auto itr = table_heap->Begin(nullptr);
+    Page *last = nullptr;
+    for (int i = 0; i < 1000 && last == nullptr; i++) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      last = bpm_->TryFetchPage(page_chain[8]);
+    }
+    ASSERT_NE(nullptr, last);
+    bpm_->UnpinPage(page_chain[8], false);
+  }
+  delete table_heap;
+  delete bpm_;
+
+  // Scenario: scans over a pool much smaller than the table see every row once, with and without read-ahead.
+  for (size_t read_ahead : {0, 1, 8}) {
+    bpm_ = new BufferPoolManager(16, disk_mgr_, kTwoQueueReplacer);
+    table_heap = TableHeap::Create(bpm_, first_page_id, schema.get(), nullptr, nullptr);
+    table_heap->SetReadAhead(read_ahead);
+    std::vector<bool> seen(row_nums, false);
+    int count = 0;
+    for (auto itr = table_heap->Begin(nullptr); itr != table_heap->End(); itr++) {
+      int id = std::stoi(itr->GetField(0)->toString());
+      ASSERT_FALSE(seen[id]);
+      seen[id] = true;
+      count++;
+    }
+    EXPECT_EQ(row_nums, count);
+    EXPECT_TRUE(bpm_->CheckAllUnpinned());
+    delete table_heap;
+    delete bpm_;
+  }
+  delete disk_mgr_;
+  remove(db_file_name.c_str());
+}
+
+TEST(TableHeapTest, ContiguousPagesTest) {
+  remove(db_file_name.c_str());
+  auto disk_mgr_ = new DiskManager(db_file_name);
+  auto bpm_ = new BufferPoolManager(DEFAULT_BUFFER_POOL_SIZE, disk_mgr_);
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 512, 1, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  TableHeap *table_heaps[2];
+  for (auto &table_heap : table_heaps) {
+    table_heap = TableHeap::Create(bpm_, schema.get(), nullptr, nullptr, nullptr);
+  }
+  char characters[512];
+  memset(characters, 'x', sizeof(characters));
+  // Scenario: tables growing side by side each get their own run of contiguous pages.
+  const int row_nums = 2 * 16 * PAGE_SIZE / sizeof(characters);
+  for (int i = 0; i < row_nums; i++) {
+    Fields fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, characters, sizeof(characters), true)};
+    Row row(fields);
+    ASSERT_TRUE(table_heaps[i % 2]->InsertTuple(row, nullptr));
+  }
+  std::vector<page_id_t> page_ids[2];
+  for (int t = 0; t < 2; t++) {
+    for (auto page_id = table_heaps[t]->GetFirstPageId(); page_id != INVALID_PAGE_ID;) {
+      page_ids[t].push_back(page_id);
+      auto page = reinterpret_cast<TablePage *>(bpm_->FetchPage(page_id));
+      auto next_page_id = page->GetNextPageId();
+      bpm_->UnpinPage(page_id, false);
+      page_id = next_page_id;
+    }
+    ASSERT_GT(page_ids[t].size(), 10);
+    for (size_t i = 1; i < page_ids[t].size(); i++) {
+      EXPECT_EQ(page_ids[t][i - 1] + 1, page_ids[t][i]);
+    }
+  }
+  // Scenario: the pages reserved but not used are freed with the table heap.
+  page_id_t unused = page_ids[0].back() + 1;
+  EXPECT_FALSE(bpm_->IsPageFree(unused));
+  delete table_heaps[0];
+  EXPECT_TRUE(bpm_->IsPageFree(unused));
+  EXPECT_FALSE(bpm_->IsPageFree(page_ids[0].back()));
+  delete table_heaps[1];
+  delete bpm_;
+  delete disk_mgr_;
+  remove(db_file_name.c_str());
+}
+
+TEST(TableHeapTest, FreeSpaceMapTest) {
+  remove(db_file_name.c_str());
+  auto disk_mgr_ = new DiskManager(db_file_name);
+  auto bpm_ = new BufferPoolManager(DEFAULT_BUFFER_POOL_SIZE, disk_mgr_);
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 512, 1, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  TableHeap *table_heap = TableHeap::Create(bpm_, schema.get(), nullptr, nullptr, nullptr);
+  char characters[512];
+  memset(characters, 'x', sizeof(characters));
+  auto insert = [&](int id) {
+    Fields fields{Field(TypeId::kTypeInt, id), Field(TypeId::kTypeChar, characters, sizeof(characters), true)};
+    Row row(fields);
+    EXPECT_TRUE(table_heap->InsertTuple(row, nullptr));
+    return row.GetRowId();
+  };
+  auto count_pages = [&]() {
+    size_t pages = 0;
+    for (auto page_id = table_heap->GetFirstPageId(); page_id != INVALID_PAGE_ID; pages++) {
+      auto page = reinterpret_cast<TablePage *>(bpm_->FetchPage(page_id));
+      auto next_page_id = page->GetNextPageId();
+      bpm_->UnpinPage(page_id, false);
+      page_id = next_page_id;
+    }
+    return pages;
+  };
+  std::vector<RowId> rids;
+  for (int i = 0; i < 8 * PAGE_SIZE / 512; i++) {
+    rids.push_back(insert(i));
+  }
+  size_t num_pages = count_pages();
+  ASSERT_GT(num_pages, 4);
+  // Scenario: space freed in a page in the middle of the chain is reused instead of appending a page.
+  page_id_t middle_page_id = rids[rids.size() / 2].GetPageId();
+  int freed = 0;
+  for (auto &rid : rids) {
+    if (rid.GetPageId() == middle_page_id) {
+      table_heap->ApplyDelete(rid, nullptr);
+      freed++;
+    }
+  }
+  // the last page is filled up as well
+  int rows_per_page =
+      std::count_if(rids.begin(), rids.end(), [&](auto &rid) { return rid.GetPageId() == rids[0].GetPageId(); });
+  int rows_in_last_page =
+      std::count_if(rids.begin(), rids.end(), [&](auto &rid) { return rid.GetPageId() == rids.back().GetPageId(); });
+  int reused = 0;
+  for (int i = 0; i < freed + rows_per_page - rows_in_last_page; i++) {
+    reused += insert(i).GetPageId() == middle_page_id;
+  }
+  EXPECT_EQ(freed, reused);
+  EXPECT_EQ(num_pages, count_pages());
+  // Scenario: the free space map is persisted and found again when the table is reopened.
+  page_id_t first_page_id = table_heap->GetFirstPageId();
+  page_id_t fsm_page_id = table_heap->GetFreeSpaceMapPageId();
+  delete table_heap;
+  table_heap = TableHeap::Create(bpm_, first_page_id, schema.get(), nullptr, nullptr, fsm_page_id);
+  table_heap->ApplyDelete(rids[0], nullptr);
+  EXPECT_EQ(rids[0].GetPageId(), insert(0).GetPageId());
+  EXPECT_EQ(num_pages, count_pages());
+  EXPECT_EQ(fsm_page_id, table_heap->GetFreeSpaceMapPageId());
+  // Scenario: the free space map is freed with the table.
+  table_heap->FreeTableHeap();
+  EXPECT_TRUE(bpm_->IsPageFree(fsm_page_id));
+  delete table_heap;
+  delete bpm_;
+  delete disk_mgr_;
+  remove(db_file_name.c_str());
+}
+
+TEST(TableHeapTest, BulkInsertTest) {
+  remove(db_file_name.c_str());
+  auto disk_mgr_ = new DiskManager(db_file_name);
+  auto bpm_ = new BufferPoolManager(DEFAULT_BUFFER_POOL_SIZE, disk_mgr_);
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 64, 1, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  TableHeap *table_heap = TableHeap::Create(bpm_, schema.get(), nullptr, nullptr, nullptr);
+  char characters[64];
+  memset(characters, 'x', sizeof(characters));
+  auto make_row = [&](int id) {
+    Fields fields{Field(TypeId::kTypeInt, id),
+                  Field(TypeId::kTypeChar, characters, RandomUtils::RandomInt(1, sizeof(characters)), true)};
+    return Row(fields);
+  };
+  const int single_rows = 3;
+  for (int i = 0; i < single_rows; i++) {
+    Row row = make_row(i);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+  }
+  // Scenario: a batch fills the last page, then new pages, and every row can be read back through its rid.
+  const int row_nums = 20 * PAGE_SIZE / 64;
+  std::vector<Row> rows;
+  for (int i = single_rows; i < single_rows + row_nums; i++) {
+    rows.push_back(make_row(i));
+  }
+  ASSERT_TRUE(table_heap->BulkInsert(rows, nullptr));
+  EXPECT_EQ(table_heap->GetFirstPageId(), rows[0].GetRowId().GetPageId());
+  for (int i = 0; i < row_nums; i++) {
+    Row row(rows[i].GetRowId());
+    ASSERT_TRUE(table_heap->GetTuple(&row, nullptr));
+    ASSERT_EQ(CmpBool::kTrue, row.GetField(0)->CompareEquals(*rows[i].GetField(0)));
+    ASSERT_EQ(CmpBool::kTrue, row.GetField(1)->CompareEquals(*rows[i].GetField(1)));
+  }
+  int scanned = 0;
+  for (auto iter = table_heap->Begin(nullptr); iter != table_heap->End(); iter++) {
+    ASSERT_EQ(CmpBool::kTrue, iter->GetField(0)->CompareEquals(Field(TypeId::kTypeInt, scanned)));
+    scanned++;
+  }
+  EXPECT_EQ(single_rows + row_nums, scanned);
+  EXPECT_TRUE(bpm_->CheckAllUnpinned());
+  delete table_heap;
+  delete bpm_;
+  delete disk_mgr_;
+  remove(db_file_name.c_str());
+}
+
+TEST(TableHeapTest, VacuumTest) {
+  remove(db_file_name.c_str());
+  auto disk_mgr_ = new DiskManager(db_file_name);
+  auto bpm_ = new BufferPoolManager(DEFAULT_BUFFER_POOL_SIZE, disk_mgr_);
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 128, 1, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  TableHeap *table_heap = TableHeap::Create(bpm_, schema.get(), nullptr, nullptr, nullptr);
+  char characters[128];
+  memset(characters, 'x', sizeof(characters));
+  const int row_nums = 40 * PAGE_SIZE / 128;
+  std::unordered_map<int, RowId> rids;
+  for (int i = 0; i < row_nums; i++) {
+    Fields fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, characters, sizeof(characters), true)};
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+    rids[i] = row.GetRowId();
+  }
+  // Scenario: every page keeps one row in ten after mass deletes, some pages lose all rows.
+  for (int i = 0; i < row_nums; i++) {
+    bool keep = i % 10 == 0 && (i / 100) % 3 != 1;
+    if (!keep) {
+      ASSERT_TRUE(table_heap->MarkDelete(rids[i], nullptr));
+      rids.erase(i);
+    }
+  }
+  EXPECT_EQ(row_nums - rids.size(), table_heap->GetDeadTupleCount());
+  auto stats = table_heap->Vacuum(nullptr, [&](Row &row, const RowId &old_rid) {
+    for (auto &[key, rid] : rids) {
+      if (rid == old_rid) {
+        rid = row.GetRowId();
+        return;
+      }
+    }
+    FAIL() << "moved a row that is not in the table";
+  });
+  EXPECT_EQ(0, table_heap->GetDeadTupleCount());
+  EXPECT_EQ(row_nums - rids.size(), stats.rows_deleted_);
+  EXPECT_GT(stats.rows_moved_, 0);
+  EXPECT_GT(stats.pages_reclaimed_, stats.pages_before_ / 2);
+  size_t pages = 0;
+  for (auto page_id = table_heap->GetFirstPageId(); page_id != INVALID_PAGE_ID; pages++) {
+    auto page = reinterpret_cast<TablePage *>(bpm_->FetchPage(page_id));
+    auto next_page_id = page->GetNextPageId();
+    bpm_->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+  EXPECT_EQ(stats.pages_before_ - stats.pages_reclaimed_, pages);
+  // every row left is found through its new rid, a scan sees each of them once
+  for (auto &[key, rid] : rids) {
+    Row row(rid);
+    ASSERT_TRUE(table_heap->GetTuple(&row, nullptr));
+    ASSERT_EQ(CmpBool::kTrue, row.GetField(0)->CompareEquals(Field(TypeId::kTypeInt, key)));
+  }
+  size_t scanned = 0;
+  for (auto iter = table_heap->Begin(nullptr); iter != table_heap->End(); iter++) {
+    scanned++;
+  }
+  EXPECT_EQ(rids.size(), scanned);
+  // the free space map follows the new page chain
+  Fields fields{Field(TypeId::kTypeInt, row_nums), Field(TypeId::kTypeChar, characters, sizeof(characters), true)};
+  Row row(fields);
+  ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+  EXPECT_FALSE(bpm_->IsPageFree(row.GetRowId().GetPageId()));
+  EXPECT_TRUE(bpm_->CheckAllUnpinned());
+  delete table_heap;
+  delete bpm_;
+  delete disk_mgr_;
+  remove(db_file_name.c_str());
+}
+
+TEST(TableHeapTest, VacuumFullPoolTest) {
+  remove(db_file_name.c_str());
+  const size_t buffer_pool_size = 8;
+  auto disk_mgr_ = new DiskManager(db_file_name);
+  auto bpm_ = new BufferPoolManager(buffer_pool_size, disk_mgr_, kLRUReplacer, 1);
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 128, 1, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  TableHeap *table_heap = TableHeap::Create(bpm_, schema.get(), nullptr, nullptr, nullptr);
+  char characters[128];
+  memset(characters, 'x', sizeof(characters));
+  const int row_nums = 10 * PAGE_SIZE / 128;
+  std::vector<RowId> rids;
+  for (int i = 0; i < row_nums; i++) {
+    Fields fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, characters, sizeof(characters), true)};
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+    rids.push_back(row.GetRowId());
+  }
+  std::vector<page_id_t> chain;
+  for (auto page_id = table_heap->GetFirstPageId(); page_id != INVALID_PAGE_ID;) {
+    chain.push_back(page_id);
+    auto page = reinterpret_cast<TablePage *>(bpm_->FetchPage(page_id));
+    auto next_page_id = page->GetNextPageId();
+    bpm_->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+  ASSERT_GT(chain.size(), 6);
+  // rows are only deleted after the fourth page, the first three stay full
+  size_t deleted = 0;
+  for (int i = 0; i < row_nums; i += 2) {
+    if (std::find(chain.begin(), chain.begin() + 4, rids[i].GetPageId()) == chain.begin() + 4) {
+      ASSERT_TRUE(table_heap->MarkDelete(rids[i], nullptr));
+      deleted++;
+    }
+  }
+
+  // Scenario: the second page and scratch pages are pinned, all but one frame. The first pages each take that frame
+  // in turn, until the third page holds it while the fourth one is fetched.
+  std::vector<page_id_t> pinned{chain[1]};
+  ASSERT_NE(nullptr, bpm_->FetchPage(chain[1]));
+  while (pinned.size() < buffer_pool_size - 1) {
+    page_id_t page_id;
+    ASSERT_NE(nullptr, bpm_->NewPage(page_id));
+    pinned.push_back(page_id);
+  }
+  auto stats = table_heap->Vacuum(nullptr);
+  EXPECT_EQ(3, stats.pages_before_);
+  EXPECT_EQ(0, stats.pages_reclaimed_);
+  EXPECT_EQ(0, stats.rows_deleted_);
+  EXPECT_EQ(deleted, table_heap->GetDeadTupleCount());
+  for (auto page_id : pinned) {
+    bpm_->UnpinPage(page_id, false);
+  }
+  EXPECT_TRUE(bpm_->CheckAllUnpinned());
+
+  // Scenario: the chain is intact, the free space map still knows every page, and a later vacuum finishes the work.
+  size_t pages = 0;
+  for (auto page_id = table_heap->GetFirstPageId(); page_id != INVALID_PAGE_ID; pages++) {
+    auto page = reinterpret_cast<TablePage *>(bpm_->FetchPage(page_id));
+    ASSERT_EQ(pages == 0 ? INVALID_PAGE_ID : chain[pages - 1], page->GetPrevPageId());
+    auto next_page_id = page->GetNextPageId();
+    bpm_->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+  EXPECT_EQ(chain.size(), pages);
+  stats = table_heap->Vacuum(nullptr);
+  EXPECT_EQ(chain.size(), stats.pages_before_);
+  EXPECT_EQ(deleted, stats.rows_deleted_);
+  EXPECT_EQ(0, table_heap->GetDeadTupleCount());
+  size_t scanned = 0;
+  for (auto iter = table_heap->Begin(nullptr); iter != table_heap->End(); iter++) {
+    scanned++;
+  }
+  EXPECT_EQ(row_nums - deleted, scanned);
+  EXPECT_TRUE(bpm_->CheckAllUnpinned());
+  delete table_heap;
+  delete bpm_;
+  delete disk_mgr_;
+  remove(db_file_name.c_str());
+}